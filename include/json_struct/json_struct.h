@@ -121,6 +121,7 @@
 #include <limits>
 #include <memory>
 #include <stddef.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <string>
 #include <vector>
@@ -129,6 +130,25 @@
 #include <intrin.h>
 #endif
 
+#ifndef JS_NO_SIMD
+#if defined(__AVX2__)
+#define JS_SIMD_AVX2 1
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define JS_SIMD_SSE2 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(_M_ARM64)
+#define JS_SIMD_NEON 1
+#endif
+#endif
+
+#if defined(JS_SIMD_AVX2)
+#include <immintrin.h>
+#elif defined(JS_SIMD_SSE2)
+#include <emmintrin.h>
+#elif defined(JS_SIMD_NEON)
+#include <arm_neon.h>
+#endif
+
 #if __cplusplus > 199711L || (defined(_MSC_VER) && _MSC_VER > 1800)
 #define JS_STD_UNORDERED_MAP 1
 #endif
@@ -152,6 +172,42 @@
 #include <optional>
 #endif
 
+#ifndef JS_STD_STRING_VIEW
+#if defined(__APPLE__)
+#if __clang_major__ > 9 && __cplusplus >= 201703L
+#define JS_STD_STRING_VIEW 1
+#endif
+#elif defined(_MSC_VER) && _MSC_VER >= 1910 && _HAS_CXX17
+#define JS_STD_STRING_VIEW 1
+#elif __cplusplus >= 201703L
+#define JS_STD_STRING_VIEW 1
+#endif
+#endif
+
+#ifdef JS_STD_STRING_VIEW
+#include <string_view>
+#endif
+
+#ifndef JS_STD_MEMORY_RESOURCE
+#if defined(_MSC_VER) && _MSC_VER >= 1913 && _HAS_CXX17
+#define JS_STD_MEMORY_RESOURCE 1
+#elif __cplusplus >= 201703L && defined(__has_include)
+#if __has_include(<memory_resource>)
+#define JS_STD_MEMORY_RESOURCE 1
+#endif
+#endif
+#endif
+
+#ifdef JS_STD_MEMORY_RESOURCE
+#include <memory_resource>
+#endif
+
+#ifndef JS_PROJECTION
+#if __cpp_nontype_template_parameter_auto >= 201606L
+#define JS_PROJECTION 1
+#endif
+#endif
+
 #ifdef JS_STD_TIMEPOINT
 #include <chrono>
 #include <type_traits>
@@ -236,6 +292,13 @@ struct DataRef
   {
   }
 
+  template <typename Traits, typename Allocator>
+  explicit DataRef(const std::basic_string<char, Traits, Allocator> &str)
+    : data(&str[0])
+    , size(str.size())
+  {
+  }
+
   explicit DataRef(const char *data)
     : data(data)
     , size(strlen(data))
@@ -271,6 +334,55 @@ struct Token
   Type value_type;
 };
 
+/* A Token in CompactJsonTokens. The name and value are 32 bit offsets into
+ * the tape, and the sizes share 32 bits with the type in the low 4 bits. */
+struct CompactToken
+{
+  uint32_t name_offset;
+  uint32_t value_offset;
+  uint32_t name_size_and_type;
+  uint32_t value_size_and_type;
+};
+
+/*!
+ * \brief A token tape storing 16 bytes per token instead of the 40 of Token.
+ *
+ * Names and values are stored as offsets into the base buffer, which has to
+ * outlive the tape, just as the data referenced by JsonTokens. Data outside of
+ * the base buffer, like tokens copied from an intermediate buffer, is copied
+ * into storage owned by the tape. Tokens are unpacked on access, and the tape
+ * can be fed to a Tokenizer with resetData.
+ */
+class CompactJsonTokens
+{
+public:
+  CompactJsonTokens();
+  CompactJsonTokens(const char *base, size_t base_size);
+
+  void reset(const char *base, size_t base_size);
+  void clear();
+  void reserve(size_t count);
+  bool push_back(const Token &token);
+
+  Token operator[](size_t index) const;
+  Type valueType(size_t index) const;
+  size_t size() const;
+  bool empty() const;
+  const char *baseData() const;
+  size_t baseSize() const;
+
+  static const size_t max_string_size = (size_t(1) << 28) - 1;
+  std::vector<CompactToken> data;
+
+private:
+  bool pack(const DataRef &ref, Type type, uint32_t &offset, uint32_t &size_and_type);
+  DataRef unpack(uint32_t offset, uint32_t size_and_type) const;
+
+  const char *m_base;
+  size_t m_base_size;
+  std::string m_extra;
+};
+
 namespace Internal
 {
 struct IntermediateToken
@@ -351,6 +463,573 @@ static inline const unsigned char *lookup()
     /*248*/ 0,      0,       0,       0,       0,       0,       0,       0};
   return tmp;
 }
+
+static inline int bit_scan_forward(uint64_t a)
+{
+  assert(a);
+#ifdef _MSC_VER
+  unsigned long index;
+#ifdef _WIN64
+  _BitScanForward64(&index, a);
+#else
+  if (_BitScanForward(&index, uint32_t(a)))
+    return int(index);
+  _BitScanForward(&index, uint32_t(a >> 32));
+  index += 32;
+#endif
+  return int(index);
+#else
+  return __builtin_ctzll(a);
+#endif
+}
+
+#if defined(JS_SIMD_NEON)
+static inline uint64_t neon_match_mask(uint8x16_t match)
+{
+  // Narrowing shift packs the 16 byte wide result into 4 bits per byte.
+  return vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(match), 4)), 0);
+}
+#endif
+
+/* Returns the position of the first '"' or '\\' in data[pos, size), or size
+ * if there is none. This is the inner loop of the string scanning, so it is
+ * vectorized when the target supports it. The lookup table loop handles the
+ * tail and targets without SIMD support. */
+static inline size_t findStringEndOrEscape(const char *data, size_t pos, size_t size)
+{
+#if defined(JS_SIMD_AVX2)
+  const __m256i quote32 = _mm256_set1_epi8('"');
+  const __m256i backslash32 = _mm256_set1_epi8('\\');
+  for (; pos + 32 <= size; pos += 32)
+  {
+    const __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + pos));
+    const __m256i match = _mm256_or_si256(_mm256_cmpeq_epi8(chunk, quote32), _mm256_cmpeq_epi8(chunk, backslash32));
+    const uint32_t mask = uint32_t(_mm256_movemask_epi8(match));
+    if (mask)
+      return pos + size_t(bit_scan_forward(mask));
+  }
+#endif
+#if defined(JS_SIMD_SSE2)
+  const __m128i quote = _mm_set1_epi8('"');
+  const __m128i backslash = _mm_set1_epi8('\\');
+  for (; pos + 16 <= size; pos += 16)
+  {
+    const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + pos));
+    const __m128i match = _mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, backslash));
+    const uint32_t mask = uint32_t(_mm_movemask_epi8(match));
+    if (mask)
+      return pos + size_t(bit_scan_forward(mask));
+  }
+#elif defined(JS_SIMD_NEON)
+  const uint8x16_t quote = vdupq_n_u8('"');
+  const uint8x16_t backslash = vdupq_n_u8('\\');
+  for (; pos + 16 <= size; pos += 16)
+  {
+    const uint8x16_t chunk = vld1q_u8(reinterpret_cast<const uint8_t *>(data + pos));
+    const uint64_t mask = neon_match_mask(vorrq_u8(vceqq_u8(chunk, quote), vceqq_u8(chunk, backslash)));
+    if (mask)
+      return pos + size_t(bit_scan_forward(mask) >> 2);
+  }
+#endif
+  for (; pos < size; pos++)
+  {
+    if (lookup()[(unsigned char)data[pos]] == StrEndOrBackSlash)
+      return pos;
+  }
+  return size;
+}
+
+/* Returns the position of the first '"', '[', ']', '{' or '}' in
+ * data[pos, size), or size if there is none. OR-ing in 0x20 maps '[' and ']'
+ * onto '{' and '}', so the brackets take two compares. */
+static inline size_t findContainerCharOrQuote(const char *data, size_t pos, size_t size)
+{
+#if defined(JS_SIMD_AVX2)
+  const __m256i quote32 = _mm256_set1_epi8('"');
+  const __m256i open32 = _mm256_set1_epi8('{');
+  const __m256i close32 = _mm256_set1_epi8('}');
+  const __m256i fold32 = _mm256_set1_epi8(0x20);
+  for (; pos + 32 <= size; pos += 32)
+  {
+    const __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + pos));
+    const __m256i folded = _mm256_or_si256(chunk, fold32);
+    const __m256i brackets = _mm256_or_si256(_mm256_cmpeq_epi8(folded, open32), _mm256_cmpeq_epi8(folded, close32));
+    const __m256i match = _mm256_or_si256(_mm256_cmpeq_epi8(chunk, quote32), brackets);
+    const uint32_t mask = uint32_t(_mm256_movemask_epi8(match));
+    if (mask)
+      return pos + size_t(bit_scan_forward(mask));
+  }
+#endif
+#if defined(JS_SIMD_SSE2)
+  const __m128i quote = _mm_set1_epi8('"');
+  const __m128i open = _mm_set1_epi8('{');
+  const __m128i close = _mm_set1_epi8('}');
+  const __m128i fold = _mm_set1_epi8(0x20);
+  for (; pos + 16 <= size; pos += 16)
+  {
+    const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + pos));
+    const __m128i folded = _mm_or_si128(chunk, fold);
+    const __m128i brackets = _mm_or_si128(_mm_cmpeq_epi8(folded, open), _mm_cmpeq_epi8(folded, close));
+    const __m128i match = _mm_or_si128(_mm_cmpeq_epi8(chunk, quote), brackets);
+    const uint32_t mask = uint32_t(_mm_movemask_epi8(match));
+    if (mask)
+      return pos + size_t(bit_scan_forward(mask));
+  }
+#elif defined(JS_SIMD_NEON)
+  const uint8x16_t quote = vdupq_n_u8('"');
+  const uint8x16_t open = vdupq_n_u8('{');
+  const uint8x16_t close = vdupq_n_u8('}');
+  const uint8x16_t fold = vdupq_n_u8(0x20);
+  for (; pos + 16 <= size; pos += 16)
+  {
+    const uint8x16_t chunk = vld1q_u8(reinterpret_cast<const uint8_t *>(data + pos));
+    const uint8x16_t folded = vorrq_u8(chunk, fold);
+    const uint64_t mask =
+      neon_match_mask(vorrq_u8(vceqq_u8(chunk, quote), vorrq_u8(vceqq_u8(folded, open), vceqq_u8(folded, close))));
+    if (mask)
+      return pos + size_t(bit_scan_forward(mask) >> 2);
+  }
+#endif
+  for (; pos < size; pos++)
+  {
+    const char folded = char(data[pos] | 0x20);
+    if (data[pos] == '"' || folded == '{' || folded == '}')
+      return pos;
+  }
+  return size;
+}
+
+/* Returns the position of the bracket closing the object or array whose
+ * content starts at pos, or size if it does not end in data[pos, size). Only
+ * strings and escapes are recognized, the content is not validated. */
+static inline size_t findContainerEnd(const char *data, size_t pos, size_t size)
+{
+  int depth = 1;
+  while (true)
+  {
+    pos = findContainerCharOrQuote(data, pos, size);
+    if (pos >= size)
+      return size;
+    const char cur = data[pos];
+    if (cur == '"')
+    {
+      pos = findStringEndOrEscape(data, pos + 1, size);
+      while (pos < size && data[pos] == '\\')
+        pos = findStringEndOrEscape(data, pos + 2, size);
+      if (pos >= size)
+        return size;
+    }
+    else if (cur == '{' || cur == '[')
+    {
+      depth++;
+    }
+    else if (--depth == 0)
+    {
+      return pos;
+    }
+    pos++;
+  }
+}
+
+/* Returns the position of the first character in data[pos, size) that has to
+ * be escaped when serialized as a json string, or size if there is none.
+ * These are '"', '\\' and the control characters up to and including '\r'. */
+static inline size_t findEscapeOut(const char *data, size_t pos, size_t size)
+{
+#if defined(JS_SIMD_AVX2)
+  const __m256i quote32 = _mm256_set1_epi8('"');
+  const __m256i backslash32 = _mm256_set1_epi8('\\');
+  const __m256i control32 = _mm256_set1_epi8('\r');
+  for (; pos + 32 <= size; pos += 32)
+  {
+    const __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + pos));
+    const __m256i control = _mm256_cmpeq_epi8(_mm256_min_epu8(chunk, control32), chunk);
+    const __m256i match = _mm256_or_si256(
+      control, _mm256_or_si256(_mm256_cmpeq_epi8(chunk, quote32), _mm256_cmpeq_epi8(chunk, backslash32)));
+    const uint32_t mask = uint32_t(_mm256_movemask_epi8(match));
+    if (mask)
+      return pos + size_t(bit_scan_forward(mask));
+  }
+#endif
+#if defined(JS_SIMD_SSE2)
+  const __m128i quote = _mm_set1_epi8('"');
+  const __m128i backslash = _mm_set1_epi8('\\');
+  const __m128i control_max = _mm_set1_epi8('\r');
+  for (; pos + 16 <= size; pos += 16)
+  {
+    const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + pos));
+    const __m128i control = _mm_cmpeq_epi8(_mm_min_epu8(chunk, control_max), chunk);
+    const __m128i match =
+      _mm_or_si128(control, _mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, backslash)));
+    const uint32_t mask = uint32_t(_mm_movemask_epi8(match));
+    if (mask)
+      return pos + size_t(bit_scan_forward(mask));
+  }
+#elif defined(JS_SIMD_NEON)
+  const uint8x16_t quote = vdupq_n_u8('"');
+  const uint8x16_t backslash = vdupq_n_u8('\\');
+  const uint8x16_t control_max = vdupq_n_u8('\r');
+  for (; pos + 16 <= size; pos += 16)
+  {
+    const uint8x16_t chunk = vld1q_u8(reinterpret_cast<const uint8_t *>(data + pos));
+    const uint8x16_t match =
+      vorrq_u8(vcleq_u8(chunk, control_max), vorrq_u8(vceqq_u8(chunk, quote), vceqq_u8(chunk, backslash)));
+    const uint64_t mask = neon_match_mask(match);
+    if (mask)
+      return pos + size_t(bit_scan_forward(mask) >> 2);
+  }
+#endif
+  for (; pos < size; pos++)
+  {
+    const char cur = data[pos];
+    if (static_cast<uint8_t>(cur) <= uint8_t('\r') || cur == '\"' || cur == '\\')
+      return pos;
+  }
+  return size;
+}
+
+/* Returns the two character escape sequence for a character found by
+ * findEscapeOut, or nullptr if the character is written as is. */
+static inline const char *escapeSequenceOut(char cur)
+{
+  switch (cur)
+  {
+  case '\b':
+    return "\\b";
+  case '\t':
+    return "\\t";
+  case '\n':
+    return "\\n";
+  case '\f':
+    return "\\f";
+  case '\r':
+    return "\\r";
+  case '\"':
+    return "\\\"";
+  case '\\':
+    return "\\\\";
+  default:
+    return nullptr;
+  }
+}
+
+/* Stage one of the structural index tokenizer mode. It records, for a whole
+ * buffer, the position of every unescaped quote, every structural character
+ * ({}[]:,) outside strings, and every non whitespace character outside
+ * strings that follows whitespace or a structural character. This means the
+ * first non whitespace character after any whitespace is always in the index,
+ * and the closing quote is the first entry after any position inside a
+ * string. The tokenizer uses this to jump over whitespace and string contents
+ * while still running its normal per character logic on what it lands on. */
+struct StructuralIndex
+{
+  struct State
+  {
+    bool in_string;
+    bool escaped;
+    bool prev_separator;
+  };
+
+  StructuralIndex()
+    : data(nullptr)
+    , size(0)
+    , next(0)
+    , valid(false)
+    , count(0)
+    , capacity(0)
+  {
+  }
+
+  bool isBuiltFor(const char *json, size_t json_size) const
+  {
+    return data == json && size == json_size;
+  }
+
+  void clear()
+  {
+    data = nullptr;
+    size = 0;
+    next = 0;
+    valid = false;
+    count = 0;
+  }
+
+  /* Returns the first indexed position >= pos, or size if there is none. */
+  size_t nextEntry(size_t pos)
+  {
+    const uint32_t *entries = positions.get();
+    if (next > 0 && entries[next - 1] >= pos)
+      next = size_t(std::lower_bound(entries, entries + count, uint32_t(pos)) - entries);
+    while (next < count && entries[next] < pos)
+      next++;
+    return next < count ? size_t(entries[next]) : size;
+  }
+
+  void build(const char *json, size_t json_size, size_t start, bool in_string, bool escaped)
+  {
+    clear();
+    data = json;
+    size = json_size;
+    if (json_size > size_t(std::numeric_limits<uint32_t>::max()))
+      return;
+    reserve((json_size - start) / 8 + 64);
+    State state = {in_string, escaped, true};
+    size_t pos = start;
+    for (; pos + 64 <= json_size; pos += 64)
+    {
+      if (!buildBlock(json + pos, uint32_t(pos), state))
+        buildScalar(json, pos, pos + 64, state);
+    }
+    buildScalar(json, pos, json_size, state);
+    valid = true;
+  }
+
+  const char *data;
+  size_t size;
+  size_t next;
+  bool valid;
+
+private:
+  std::unique_ptr<uint32_t[]> positions;
+  size_t count;
+  size_t capacity;
+
+  void reserve(size_t needed)
+  {
+    if (needed <= capacity)
+      return;
+    size_t new_capacity = std::max(needed, capacity * 2);
+    std::unique_ptr<uint32_t[]> new_positions(new uint32_t[new_capacity]);
+    if (count)
+      memcpy(new_positions.get(), positions.get(), count * sizeof(uint32_t));
+    positions = std::move(new_positions);
+    capacity = new_capacity;
+  }
+
+  void push(size_t pos)
+  {
+    reserve(count + 1);
+    positions[count++] = uint32_t(pos);
+  }
+
+  static bool isStructural(char c)
+  {
+    return c == '{' || c == '}' || c == '[' || c == ']' || c == ':' || c == ',';
+  }
+
+  void buildScalar(const char *json, size_t pos, size_t end, State &state)
+  {
+    for (; pos < end; pos++)
+    {
+      const char c = json[pos];
+      if (state.in_string)
+      {
+        if (state.escaped)
+          state.escaped = false;
+        else if (c == '\\')
+          state.escaped = true;
+        else if (c == '"')
+        {
+          state.in_string = false;
+          state.prev_separator = true;
+          push(pos);
+        }
+        continue;
+      }
+      if (c == '"')
+      {
+        state.in_string = true;
+        push(pos);
+      }
+      else if (isStructural(c))
+      {
+        state.prev_separator = true;
+        push(pos);
+      }
+      else if (lookup()[(unsigned char)c] & WhiteSpaceOrNull)
+      {
+        state.prev_separator = true;
+      }
+      else
+      {
+        if (state.prev_separator)
+          push(pos);
+        state.prev_separator = false;
+      }
+    }
+  }
+
+  static uint64_t prefixXor(uint64_t x)
+  {
+    x ^= x << 1;
+    x ^= x << 2;
+    x ^= x << 4;
+    x ^= x << 8;
+    x ^= x << 16;
+    x ^= x << 32;
+    return x;
+  }
+
+#if defined(JS_SIMD_SSE2)
+  static uint64_t movemask64(__m128i m0, __m128i m1, __m128i m2, __m128i m3)
+  {
+    return uint64_t(uint32_t(_mm_movemask_epi8(m0))) | uint64_t(uint32_t(_mm_movemask_epi8(m1))) << 16 |
+           uint64_t(uint32_t(_mm_movemask_epi8(m2))) << 32 | uint64_t(uint32_t(_mm_movemask_epi8(m3))) << 48;
+  }
+#elif defined(JS_SIMD_NEON)
+  static uint64_t movemask16(uint8x16_t match)
+  {
+    static const uint8_t weights[16] = {1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128};
+    const uint8x16_t masked = vandq_u8(match, vld1q_u8(weights));
+    uint8x8_t sum = vpadd_u8(vget_low_u8(masked), vget_high_u8(masked));
+    sum = vpadd_u8(sum, sum);
+    sum = vpadd_u8(sum, sum);
+    return vget_lane_u16(vreinterpret_u16_u8(sum), 0);
+  }
+#endif
+
+  static void classifyStrings(const char *block, uint64_t &quote, uint64_t &backslash)
+  {
+#if defined(JS_SIMD_SSE2)
+    __m128i chunk[4];
+    for (int i = 0; i < 4; i++)
+      chunk[i] = _mm_loadu_si128(reinterpret_cast<const __m128i *>(block + i * 16));
+    const __m128i q = _mm_set1_epi8('"');
+    const __m128i b = _mm_set1_epi8('\\');
+    quote = movemask64(_mm_cmpeq_epi8(chunk[0], q), _mm_cmpeq_epi8(chunk[1], q), _mm_cmpeq_epi8(chunk[2], q),
+                       _mm_cmpeq_epi8(chunk[3], q));
+    backslash = movemask64(_mm_cmpeq_epi8(chunk[0], b), _mm_cmpeq_epi8(chunk[1], b), _mm_cmpeq_epi8(chunk[2], b),
+                           _mm_cmpeq_epi8(chunk[3], b));
+#elif defined(JS_SIMD_NEON)
+    quote = backslash = 0;
+    for (int i = 0; i < 4; i++)
+    {
+      const uint8x16_t chunk = vld1q_u8(reinterpret_cast<const uint8_t *>(block + i * 16));
+      quote |= movemask16(vceqq_u8(chunk, vdupq_n_u8('"'))) << (i * 16);
+      backslash |= movemask16(vceqq_u8(chunk, vdupq_n_u8('\\'))) << (i * 16);
+    }
+#else
+    quote = backslash = 0;
+    for (int i = 0; i < 64; i++)
+    {
+      quote |= uint64_t(block[i] == '"') << i;
+      backslash |= uint64_t(block[i] == '\\') << i;
+    }
+#endif
+  }
+
+  static void classifyStructure(const char *block, uint64_t &white_space, uint64_t &structural)
+  {
+#if defined(JS_SIMD_SSE2)
+    __m128i ws[4];
+    __m128i st[4];
+    for (int i = 0; i < 4; i++)
+    {
+      const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(block + i * 16));
+      ws[i] = _mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8(' ')), _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\n')));
+      ws[i] = _mm_or_si128(ws[i], _mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('\t')),
+                                               _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\r'))));
+      ws[i] = _mm_or_si128(ws[i], _mm_cmpeq_epi8(chunk, _mm_setzero_si128()));
+      // '[' and ']' are '{' and '}' without the 0x20 bit
+      const __m128i folded = _mm_or_si128(chunk, _mm_set1_epi8(0x20));
+      st[i] = _mm_or_si128(_mm_cmpeq_epi8(folded, _mm_set1_epi8('{')), _mm_cmpeq_epi8(folded, _mm_set1_epi8('}')));
+      st[i] = _mm_or_si128(st[i], _mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8(':')),
+                                               _mm_cmpeq_epi8(chunk, _mm_set1_epi8(','))));
+    }
+    white_space = movemask64(ws[0], ws[1], ws[2], ws[3]);
+    structural = movemask64(st[0], st[1], st[2], st[3]);
+#elif defined(JS_SIMD_NEON)
+    white_space = structural = 0;
+    for (int i = 0; i < 4; i++)
+    {
+      const uint8x16_t chunk = vld1q_u8(reinterpret_cast<const uint8_t *>(block + i * 16));
+      uint8x16_t ws = vorrq_u8(vceqq_u8(chunk, vdupq_n_u8(' ')), vceqq_u8(chunk, vdupq_n_u8('\n')));
+      ws = vorrq_u8(ws, vorrq_u8(vceqq_u8(chunk, vdupq_n_u8('\t')), vceqq_u8(chunk, vdupq_n_u8('\r'))));
+      ws = vorrq_u8(ws, vceqq_u8(chunk, vdupq_n_u8(0)));
+      const uint8x16_t folded = vorrq_u8(chunk, vdupq_n_u8(0x20));
+      uint8x16_t st = vorrq_u8(vceqq_u8(folded, vdupq_n_u8('{')), vceqq_u8(folded, vdupq_n_u8('}')));
+      st = vorrq_u8(st, vorrq_u8(vceqq_u8(chunk, vdupq_n_u8(':')), vceqq_u8(chunk, vdupq_n_u8(','))));
+      white_space |= movemask16(ws) << (i * 16);
+      structural |= movemask16(st) << (i * 16);
+    }
+#else
+    white_space = structural = 0;
+    for (int i = 0; i < 64; i++)
+    {
+      const char c = block[i];
+      structural |= uint64_t(isStructural(c)) << i;
+      white_space |= uint64_t((lookup()[(unsigned char)c] & WhiteSpaceOrNull) != 0) << i;
+    }
+#endif
+  }
+
+  /* Returns false if the block has a backslash outside a string. The escape
+   * computation assumes all backslashes escape, which is only true inside
+   * strings, so such blocks are redone with the scalar state machine. */
+  bool buildBlock(const char *block, uint32_t offset, State &state)
+  {
+    uint64_t quote, backslash;
+    classifyStrings(block, quote, backslash);
+    if (state.in_string && !quote && !backslash)
+    {
+      // The whole block is string contents
+      state.escaped = false;
+      return true;
+    }
+
+    uint64_t escaped = 0;
+    bool escape_carry = false;
+    if (backslash || state.escaped)
+    {
+      uint64_t remaining = backslash;
+      if (state.escaped)
+      {
+        escaped = 1;
+        remaining &= ~uint64_t(1);
+      }
+      while (remaining)
+      {
+        const int index = bit_scan_forward(remaining);
+        if (index == 63)
+        {
+          escape_carry = true;
+          break;
+        }
+        escaped |= uint64_t(1) << (index + 1);
+        remaining &= ~(uint64_t(3) << index);
+      }
+    }
+    quote &= ~escaped;
+
+    uint64_t in_string = prefixXor(quote);
+    if (state.in_string)
+      in_string = ~in_string;
+    const uint64_t string_content = in_string & ~quote;
+    if (backslash & ~string_content)
+      return false;
+
+    uint64_t white_space, structural;
+    classifyStructure(block, white_space, structural);
+    const uint64_t separators = white_space | structural | quote;
+    const uint64_t prev_separator = (separators << 1) | (state.prev_separator ? 1 : 0);
+    const uint64_t scalar_start = ~separators & prev_separator;
+    uint64_t entries = ((structural | scalar_start) & ~string_content) | quote;
+
+    reserve(count + 64);
+    uint32_t *out = positions.get() + count;
+    while (entries)
+    {
+      *out++ = offset + uint32_t(bit_scan_forward(entries));
+      entries &= entries - 1;
+    }
+    count = size_t(out - positions.get());
+
+    state.in_string = (in_string >> 63) != 0;
+    state.escaped = escape_carry;
+    state.prev_separator = ((separators >> 63) & 1) != 0;
+    return true;
+  }
+};
 } // namespace Internal
 
 enum class Error : unsigned char
@@ -381,6 +1060,8 @@ enum class Error : unsigned char
   ScopeHasEnded,
   KeyNotFound,
   DuplicateInSet,
+  FailedToOpenFile,
+  TokenTooLarge,
   UnknownError,
   UserDefinedErrors
 };
@@ -573,6 +1254,23 @@ inline void RefCounter<T>::dec()
     callbackContainer->dec(index);
 }
 
+namespace Internal
+{
+/* The configuration of a Tokenizer. Every option and its default is listed
+ * here, so a tokenizer is returned to its defaults by assigning a default
+ * constructed instance. */
+struct TokenizerOptions
+{
+  bool allow_ascii_properties = false;
+  bool allow_new_lines = false;
+  bool allow_superfluous_comma = false;
+  bool use_structural_index = false;
+  size_t line_context = 4;
+  size_t line_range_context = 256;
+  size_t range_context = 38;
+};
+} // namespace Internal
+
 class Tokenizer;
 typedef RefCounter<void(const char *)> ReleaseCBRef;
 typedef RefCounter<void(Tokenizer &)> NeedMoreDataCBRef;
@@ -585,6 +1283,9 @@ public:
   void allowAsciiType(bool allow);
   void allowNewLineAsTokenDelimiter(bool allow);
   void allowSuperfluousComma(bool allow);
+  void useStructuralIndex(bool use);
+  void restoreDefaultOptions();
+  void copyOptions(const Tokenizer &other);
 
   void addData(const char *data, size_t size);
   template <size_t N>
@@ -592,12 +1293,16 @@ public:
   void addData(const std::vector<Token> *parsedData);
   void resetData(const char *data, size_t size, size_t index);
   void resetData(const std::vector<Token> *parsedData, size_t index);
+  void resetData(const CompactJsonTokens *parsedData, size_t index);
+  void reset(const char *data, size_t size);
   size_t registeredBuffers() const;
 
   NeedMoreDataCBRef registerNeedMoreDataCallback(std::function<void(Tokenizer &)> callback);
   ReleaseCBRef registerReleaseCallback(std::function<void(const char *)> &callback);
   Error nextToken(Token &next_token);
   const char *currentPosition() const;
+  DataRef currentBuffer() const;
+  bool isIntermediateValue(const Token &token) const;
 
   void copyFromValue(const Token &token, std::string &to_buffer);
   void copyIncludingValue(const Token &token, std::string &to_buffer);
@@ -605,6 +1310,11 @@ public:
   void pushScope(JS::Type type);
   void popScope();
   JS::Error goToEndOfScope(JS::Token &token);
+  bool skipToContainerEnd();
+  size_t containerDepth() const
+  {
+    return container_stack.size();
+  }
 
   std::string makeErrorString() const;
   void setErrorContextConfig(size_t lineContext, size_t rangeContext);
@@ -638,26 +1348,24 @@ private:
   Error findStartOfNextValue(Type *type, const DataRef &json_data, size_t *chars_ahead);
   Error findDelimiter(const DataRef &json_data, size_t *chars_ahead);
   Error findTokenEnd(const DataRef &json_data, size_t *chars_ahead);
+  bool structuralIndexUsable(const DataRef &json_data) const;
+  size_t skipWhiteSpace(const DataRef &json_data, size_t pos);
   void requestMoreData();
   void releaseFirstDataRef();
   Error populateFromDataRef(DataRef &data, Type &type, const DataRef &json_data);
   static void populate_annonymous_token(const DataRef &data, Type type, Token &token);
+  bool populateTokenFromStructuralIndex(Token &next_token, const DataRef &json_data);
   Error populateNextTokenFromDataRef(Token &next_token, const DataRef &json_data);
 
   InTokenState token_state = InTokenState::FindingName;
   InPropertyState property_state = InPropertyState::NoStartFound;
   Type property_type = Type::Error;
   bool is_escaped : 1;
-  bool allow_ascii_properties : 1;
-  bool allow_new_lines : 1;
-  bool allow_superfluous_comma : 1;
   bool expecting_prop_or_annonymous_data : 1;
   bool continue_after_need_more_data : 1;
   size_t cursor_index;
   size_t current_data_start;
-  size_t line_context;
-  size_t line_range_context;
-  size_t range_context;
+  Internal::TokenizerOptions options;
   Internal::IntermediateToken intermediate_token;
   std::vector<DataRef> data_list;
   std::vector<Internal::ScopeCounter> scope_counter;
@@ -666,7 +1374,9 @@ private:
   Internal::CallbackContainer<void(Tokenizer &)> need_more_data_callbacks;
   std::vector<std::pair<size_t, std::string *>> copy_buffers;
   const std::vector<Token> *parsed_data_vector;
+  const CompactJsonTokens *parsed_compact_tokens;
   Internal::ErrorContext error_context;
+  Internal::StructuralIndex structural_index;
 };
 
 namespace Internal
@@ -709,6 +1419,7 @@ public:
 
   unsigned char depth() const;
   void setDepth(int depth);
+  size_t indentation() const;
 
   void skipDelimiter(bool skip);
 
@@ -723,7 +1434,7 @@ private:
   Style m_style;
   bool m_convert_ascii_to_string;
 
-  std::string m_prefix;
+  mutable std::string m_prefix;
   std::string m_token_delimiter;
   std::string m_value_delimiter;
   std::string m_postfix;
@@ -763,6 +1474,17 @@ public:
   size_t used;
 };
 
+namespace Internal
+{
+struct FreeDeleter
+{
+  void operator()(char *data) const
+  {
+    ::free(data);
+  }
+};
+} // namespace Internal
+
 class Serializer;
 typedef RefCounter<void(Serializer &)> BufferRequestCBRef;
 class Serializer
@@ -772,13 +1494,20 @@ public:
   Serializer(char *buffer, size_t size);
 
   void setBuffer(char *buffer, size_t size);
+  void useOwnedBuffer(size_t initial_size = 4096);
+  void useStringBuffer(std::string &out, size_t initial_size = 4096);
+  void flushStringBuffer();
   void setOptions(const SerializerOptions &option);
   SerializerOptions options() const
   {
     return m_option;
   }
+  void resume(int depth, bool after_value);
 
   bool write(const Token &token);
+  bool writeEscaped(const Token &token);
+  template <size_t MaxSize, typename Format>
+  bool writeNumber(const Token &token, Format format);
   bool write(const char *data, size_t size);
   bool write(const std::string &str)
   {
@@ -786,6 +1515,7 @@ public:
   }
   template<size_t SIZE>
   inline bool write(const Internal::StringLiteral<SIZE> &strLiteral);
+  void setMemberKey(const DataRef &name, const char *key);
 
   const BufferRequestCBRef addRequestBufferCallback(std::function<void(Serializer &)> callback);
   const SerializerBuffer &currentBuffer() const;
@@ -793,11 +1523,20 @@ public:
 private:
   void askForMoreBuffers();
   void markCurrentSerializerBufferFull();
+  bool growOwnedBuffer(size_t needed);
+  bool writeToken(const Token &token, bool escape_value);
+  bool writeTokenStart(const Token &token);
+  bool writeIndentation(bool delimiter, bool newline, size_t indentation);
   bool writeAsString(const DataRef &data);
+  bool writeAsEscapedString(const DataRef &data);
   bool write(Type type, const DataRef &data);
 
   Internal::CallbackContainer<void(Serializer &)> m_request_buffer_callbacks;
   SerializerBuffer m_current_buffer;
+  std::unique_ptr<char, Internal::FreeDeleter> m_owned_buffer;
+  std::string *m_string_buffer = nullptr;
+  DataRef m_member_name;
+  const char *m_member_key = nullptr;
 
   bool m_first;
   bool m_token_start;
@@ -814,62 +1553,198 @@ inline Token::Token()
 {
 }
 
-inline Tokenizer::Tokenizer()
-  : is_escaped(false)
-  , allow_ascii_properties(false)
-  , allow_new_lines(false)
-  , allow_superfluous_comma(false)
-  , expecting_prop_or_annonymous_data(false)
-  , continue_after_need_more_data(false)
-  , cursor_index(0)
-  , current_data_start(0)
-  , line_context(4)
-  , line_range_context(256)
-  , range_context(38)
-  , parsed_data_vector(nullptr)
+inline CompactJsonTokens::CompactJsonTokens()
+  : m_base(nullptr)
+  , m_base_size(0)
 {
-  container_stack.reserve(16);
 }
 
-inline void Tokenizer::allowAsciiType(bool allow)
+inline CompactJsonTokens::CompactJsonTokens(const char *base, size_t base_size)
+  : m_base(nullptr)
+  , m_base_size(0)
 {
-  allow_ascii_properties = allow;
+  reset(base, base_size);
 }
 
-inline void Tokenizer::allowNewLineAsTokenDelimiter(bool allow)
+inline void CompactJsonTokens::reset(const char *base, size_t base_size)
 {
-  allow_new_lines = allow;
+  m_base = base;
+  m_base_size = base_size < size_t(UINT32_MAX) ? base_size : 0;
+  if (!m_base_size)
+    m_base = nullptr;
+  clear();
 }
 
-inline void Tokenizer::allowSuperfluousComma(bool allow)
+inline void CompactJsonTokens::clear()
 {
-  allow_superfluous_comma = allow;
+  data.clear();
+  m_extra.clear();
 }
-inline void Tokenizer::addData(const char *data, size_t data_size)
+
+inline void CompactJsonTokens::reserve(size_t count)
 {
-  data_list.push_back(DataRef(data, data_size));
+  data.reserve(count);
 }
 
-template <size_t N>
-inline void Tokenizer::addData(const char (&data)[N])
+inline bool CompactJsonTokens::push_back(const Token &token)
 {
-  data_list.push_back(DataRef(data));
+  CompactToken compact;
+  if (!pack(token.name, token.name_type, compact.name_offset, compact.name_size_and_type) ||
+      !pack(token.value, token.value_type, compact.value_offset, compact.value_size_and_type))
+    return false;
+  data.push_back(compact);
+  return true;
 }
 
-inline void Tokenizer::addData(const std::vector<Token> *parsedData)
+inline Token CompactJsonTokens::operator[](size_t index) const
 {
-  assert(parsed_data_vector == 0);
-  parsed_data_vector = parsedData;
-  cursor_index = 0;
+  const CompactToken &compact = data[index];
+  Token token;
+  token.name = unpack(compact.name_offset, compact.name_size_and_type);
+  token.name_type = Type(compact.name_size_and_type & 0xf);
+  token.value = unpack(compact.value_offset, compact.value_size_and_type);
+  token.value_type = Type(compact.value_size_and_type & 0xf);
+  return token;
 }
 
-inline void Tokenizer::resetData(const char *data, size_t size, size_t index)
+inline Type CompactJsonTokens::valueType(size_t index) const
 {
+  return Type(data[index].value_size_and_type & 0xf);
+}
 
-  for (auto &data_buffer : data_list)
+inline size_t CompactJsonTokens::size() const
+{
+  return data.size();
+}
+
+inline bool CompactJsonTokens::empty() const
+{
+  return data.empty();
+}
+
+inline const char *CompactJsonTokens::baseData() const
+{
+  return m_base;
+}
+
+inline size_t CompactJsonTokens::baseSize() const
+{
+  return m_base_size;
+}
+
+/* Offsets below the base size point into the base buffer, the rest into the
+ * owned extra storage following it. */
+inline bool CompactJsonTokens::pack(const DataRef &ref, Type type, uint32_t &offset, uint32_t &size_and_type)
+{
+  if (ref.size > max_string_size)
+    return false;
+  size_and_type = uint32_t(ref.size << 4) | uint32_t(type);
+  if (!ref.size)
+  {
+    offset = 0;
+    return true;
+  }
+  if (m_base && ref.data >= m_base && ref.data + ref.size <= m_base + m_base_size)
+  {
+    offset = uint32_t(ref.data - m_base);
+    return true;
+  }
+  if (m_base_size + m_extra.size() + ref.size > size_t(UINT32_MAX))
+    return false;
+  offset = uint32_t(m_base_size + m_extra.size());
+  m_extra.append(ref.data, ref.size);
+  return true;
+}
+
+inline DataRef CompactJsonTokens::unpack(uint32_t offset, uint32_t size_and_type) const
+{
+  size_t size = size_and_type >> 4;
+  if (!size)
+    return DataRef("", 0);
+  if (offset < m_base_size)
+    return DataRef(m_base + offset, size);
+  return DataRef(m_extra.data() + (offset - m_base_size), size);
+}
+
+inline Tokenizer::Tokenizer()
+  : is_escaped(false)
+  , expecting_prop_or_annonymous_data(false)
+  , continue_after_need_more_data(false)
+  , cursor_index(0)
+  , current_data_start(0)
+  , parsed_data_vector(nullptr)
+  , parsed_compact_tokens(nullptr)
+{
+  container_stack.reserve(16);
+}
+
+inline void Tokenizer::allowAsciiType(bool allow)
+{
+  options.allow_ascii_properties = allow;
+}
+
+inline void Tokenizer::allowNewLineAsTokenDelimiter(bool allow)
+{
+  options.allow_new_lines = allow;
+}
+
+inline void Tokenizer::allowSuperfluousComma(bool allow)
+{
+  options.allow_superfluous_comma = allow;
+}
+
+/* Builds an index of the structural characters of each buffer before
+ * tokenizing it, and uses it to jump over whitespace and string contents. The
+ * produced tokens are identical, but large documents are tokenized faster. */
+inline void Tokenizer::useStructuralIndex(bool use)
+{
+  options.use_structural_index = use;
+  if (!use)
+    structural_index.clear();
+}
+
+inline void Tokenizer::restoreDefaultOptions()
+{
+  options = Internal::TokenizerOptions();
+  structural_index.clear();
+}
+
+/* Uses the options of other, as set with allowAsciiType and the other option
+ * setters. The data and state of this tokenizer are kept. */
+inline void Tokenizer::copyOptions(const Tokenizer &other)
+{
+  options = other.options;
+  if (!options.use_structural_index)
+    structural_index.clear();
+}
+
+inline void Tokenizer::addData(const char *data, size_t data_size)
+{
+  data_list.push_back(DataRef(data, data_size));
+}
+
+template <size_t N>
+inline void Tokenizer::addData(const char (&data)[N])
+{
+  data_list.push_back(DataRef(data));
+}
+
+inline void Tokenizer::addData(const std::vector<Token> *parsedData)
+{
+  assert(parsed_data_vector == 0);
+  parsed_data_vector = parsedData;
+  cursor_index = 0;
+}
+
+inline void Tokenizer::resetData(const char *data, size_t size, size_t index)
+{
+
+  for (auto &data_buffer : data_list)
     release_callbacks.invokeCallbacks(data_buffer.data);
   data_list.clear();
+  structural_index.clear();
   parsed_data_vector = nullptr;
+  parsed_compact_tokens = nullptr;
   cursor_index = index;
   addData(data, size);
   resetForNewToken();
@@ -880,11 +1755,49 @@ inline void Tokenizer::resetData(const std::vector<Token> *parsedData, size_t in
   for (auto &data_buffer : data_list)
     release_callbacks.invokeCallbacks(data_buffer.data);
   data_list.clear();
+  structural_index.clear();
   parsed_data_vector = parsedData;
+  parsed_compact_tokens = nullptr;
+  cursor_index = index;
+  resetForNewToken();
+}
+
+inline void Tokenizer::resetData(const CompactJsonTokens *parsedData, size_t index)
+{
+  for (auto &data_buffer : data_list)
+    release_callbacks.invokeCallbacks(data_buffer.data);
+  data_list.clear();
+  structural_index.clear();
+  parsed_data_vector = nullptr;
+  parsed_compact_tokens = parsedData;
   cursor_index = index;
   resetForNewToken();
 }
 
+/* Rewinds all parsing state to tokenize a new document, but keeps the
+ * configuration, the registered callbacks and all allocated capacity. */
+inline void Tokenizer::reset(const char *data, size_t size)
+{
+  for (auto &data_buffer : data_list)
+    release_callbacks.invokeCallbacks(data_buffer.data);
+  data_list.clear();
+  structural_index.clear();
+  parsed_data_vector = nullptr;
+  parsed_compact_tokens = nullptr;
+  scope_counter.clear();
+  container_stack.clear();
+  copy_buffers.clear();
+  error_context.clear();
+  error_context.custom_message.clear();
+  token_state = InTokenState::FindingName;
+  is_escaped = false;
+  expecting_prop_or_annonymous_data = false;
+  continue_after_need_more_data = false;
+  cursor_index = 0;
+  addData(data, size);
+  resetForNewToken();
+}
+
 inline size_t Tokenizer::registeredBuffers() const
 {
   return data_list.size();
@@ -921,6 +1834,19 @@ inline Error Tokenizer::nextToken(Token &next_token)
       scope_counter.back().handleType(next_token.value_type);
     return Error::NoError;
   }
+  if (parsed_compact_tokens)
+  {
+    next_token = (*parsed_compact_tokens)[cursor_index];
+    cursor_index++;
+    if (cursor_index == parsed_compact_tokens->size())
+    {
+      cursor_index = 0;
+      parsed_compact_tokens = nullptr;
+    }
+    if (scope_counter.size())
+      scope_counter.back().handleType(next_token.value_type);
+    return Error::NoError;
+  }
   if (data_list.empty())
   {
     requestMoreData();
@@ -975,7 +1901,7 @@ inline Error Tokenizer::nextToken(Token &next_token)
 
 inline const char *Tokenizer::currentPosition() const
 {
-  if (parsed_data_vector)
+  if (parsed_data_vector || parsed_compact_tokens)
     return reinterpret_cast<const char *>(cursor_index);
 
   if (data_list.empty())
@@ -984,6 +1910,13 @@ inline const char *Tokenizer::currentPosition() const
   return data_list.front().data + cursor_index;
 }
 
+inline DataRef Tokenizer::currentBuffer() const
+{
+  if (parsed_data_vector || parsed_compact_tokens || data_list.empty())
+    return DataRef();
+  return data_list.front();
+}
+
 static bool isValueInIntermediateToken(const Token &token, const Internal::IntermediateToken &intermediate)
 {
   if (intermediate.data.size())
@@ -992,6 +1925,13 @@ static bool isValueInIntermediateToken(const Token &token, const Internal::Inter
   return false;
 }
 
+/* Values spanning two buffers are copied into a buffer owned by the
+ * tokenizer, and are only valid until the next token is read. */
+inline bool Tokenizer::isIntermediateValue(const Token &token) const
+{
+  return JS::isValueInIntermediateToken(token, intermediate_token);
+}
+
 inline void Tokenizer::copyFromValue(const Token &token, std::string &to_buffer)
 {
   if (isValueInIntermediateToken(token, intermediate_token))
@@ -1046,6 +1986,31 @@ inline JS::Error Tokenizer::goToEndOfScope(JS::Token &token)
   return error;
 }
 
+/* Moves the cursor to the bracket closing the innermost open object or array,
+ * without tokenizing the rest of its content, so the next token is its end.
+ * The bytes are only scanned for strings and brackets, so the skipped content
+ * is not validated. Returns false, leaving the tokenizer untouched, when the
+ * container does not end in the current buffer or the tokenizer is tracking
+ * scopes. */
+inline bool Tokenizer::skipToContainerEnd()
+{
+  if (parsed_data_vector || parsed_compact_tokens || data_list.empty() || container_stack.empty() || !scope_counter.empty() ||
+      continue_after_need_more_data ||
+      (token_state != InTokenState::FindingName && token_state != InTokenState::FindingTokenEnd))
+    return false;
+  const DataRef &json_data = data_list.front();
+  const size_t end = Internal::findContainerEnd(json_data.data, cursor_index, json_data.size);
+  if (end >= json_data.size)
+    return false;
+  const char expected = container_stack.back() == Type::ObjectStart ? '}' : ']';
+  if (json_data.data[end] != expected)
+    return false;
+  cursor_index = end;
+  token_state = InTokenState::FindingName;
+  expecting_prop_or_annonymous_data = false;
+  return true;
+}
+
 namespace Internal
 {
 static const char *error_strings[] = {
@@ -1075,6 +2040,8 @@ static const char *error_strings[] = {
   "ScopeHasEnded",
   "KeyNotFound",
   "DuplicateInSet",
+  "FailedToOpenFile",
+  "TokenTooLarge",
   "UnknownError",
   "UserDefinedErrors",
 };
@@ -1108,8 +2075,8 @@ inline std::string Tokenizer::makeErrorString() const
 
 inline void Tokenizer::setErrorContextConfig(size_t lineContext, size_t rangeContext)
 {
-  line_context = lineContext;
-  range_context = rangeContext;
+  options.line_context = lineContext;
+  options.range_context = rangeContext;
 }
 
 inline void Tokenizer::resetForNewToken()
@@ -1127,6 +2094,16 @@ inline void Tokenizer::resetForNewValue()
 
 inline Error Tokenizer::findStringEnd(const DataRef &json_data, size_t *chars_ahead)
 {
+  if (structuralIndexUsable(json_data))
+  {
+    const size_t string_end = structural_index.nextEntry(cursor_index);
+    if (string_end < json_data.size && json_data.data[string_end] == '"')
+    {
+      is_escaped = false;
+      *chars_ahead = string_end + 1 - cursor_index;
+      return Error::NoError;
+    }
+  }
   size_t end = cursor_index;
   while (end < json_data.size)
   {
@@ -1136,22 +2113,7 @@ inline Error Tokenizer::findStringEnd(const DataRef &json_data, size_t *chars_ah
       end++;
       continue;
     }
-    while (end + 4 < json_data.size)
-    {
-      unsigned char lc = Internal::lookup()[(unsigned char)json_data.data[end]];
-      if (lc == Internal::StrEndOrBackSlash)
-        break;
-      lc = Internal::lookup()[(unsigned char)json_data.data[++end]];
-      if (lc == Internal::StrEndOrBackSlash)
-        break;
-      lc = Internal::lookup()[(unsigned char)json_data.data[++end]];
-      if (lc == Internal::StrEndOrBackSlash)
-        break;
-      lc = Internal::lookup()[(unsigned char)json_data.data[++end]];
-      if (lc == Internal::StrEndOrBackSlash)
-        break;
-      end++;
-    }
+    end = Internal::findStringEndOrEscape(json_data.data, end, json_data.size);
     if (end >= json_data.size)
       break;
     char c = json_data.data[end];
@@ -1253,7 +2215,7 @@ inline Error Tokenizer::findStartOfNextValue(Type *type, const DataRef &json_dat
 
   assert(property_state == InPropertyState::NoStartFound);
 
-  for (size_t current_pos = cursor_index; current_pos < json_data.size; current_pos++)
+  for (size_t current_pos = skipWhiteSpace(json_data, cursor_index); current_pos < json_data.size; current_pos++)
   {
     const char c = json_data.data[current_pos];
     unsigned char lc = Internal::lookup()[(unsigned char)c];
@@ -1312,7 +2274,7 @@ inline Error Tokenizer::findDelimiter(const DataRef &json_data, size_t *chars_ah
 {
   if (container_stack.empty())
     return Error::IllegalPropertyType;
-  for (size_t end = cursor_index; end < json_data.size; end++)
+  for (size_t end = skipWhiteSpace(json_data, cursor_index); end < json_data.size; end++)
   {
     const char c = json_data.data[end];
     if (c == ':')
@@ -1351,7 +2313,9 @@ inline Error Tokenizer::findTokenEnd(const DataRef &json_data, size_t *chars_ahe
 {
   if (container_stack.empty())
     return Error::NoError;
-  for (size_t end = cursor_index; end < json_data.size; end++)
+  // With new lines as delimiters whitespace is significant, so it can not be skipped
+  const size_t start = options.allow_new_lines ? cursor_index : skipWhiteSpace(json_data, cursor_index);
+  for (size_t end = start; end < json_data.size; end++)
   {
     const char c = json_data.data[end];
     if (c == ',')
@@ -1367,7 +2331,7 @@ inline Error Tokenizer::findTokenEnd(const DataRef &json_data, size_t *chars_ahe
     }
     else if (c == '\n')
     {
-      if (allow_new_lines)
+      if (options.allow_new_lines)
       {
         *chars_ahead = end + 1 - cursor_index;
         return Error::NoError;
@@ -1386,6 +2350,20 @@ inline Error Tokenizer::findTokenEnd(const DataRef &json_data, size_t *chars_ahe
   return Error::NeedMoreData;
 }
 
+inline bool Tokenizer::structuralIndexUsable(const DataRef &json_data) const
+{
+  return options.use_structural_index && structural_index.valid &&
+         structural_index.isBuiltFor(json_data.data, json_data.size);
+}
+
+inline size_t Tokenizer::skipWhiteSpace(const DataRef &json_data, size_t pos)
+{
+  if (pos >= json_data.size || !structuralIndexUsable(json_data) ||
+      !(Internal::lookup()[(unsigned char)json_data.data[pos]] & Internal::WhiteSpaceOrNull))
+    return pos;
+  return structural_index.nextEntry(pos);
+}
+
 inline void Tokenizer::requestMoreData()
 {
   need_more_data_callbacks.invokeCallbacks(*this);
@@ -1410,6 +2388,7 @@ inline void Tokenizer::releaseFirstDataRef()
 
   const char *data_to_release = json_data.data;
   data_list.erase(data_list.begin());
+  structural_index.clear();
   release_callbacks.invokeCallbacks(data_to_release);
 }
 
@@ -1525,8 +2504,119 @@ inline size_t strnlen(const char *data, size_t size)
 
 } // namespace Internal
 
+/* Produces the common complete tokens, a string name followed by a value, or
+ * an array element, directly from the structural index. Returns false without
+ * changing any state for anything else, which is then left to the state
+ * machine in populateNextTokenFromDataRef. */
+inline bool Tokenizer::populateTokenFromStructuralIndex(Token &next_token, const DataRef &json_data)
+{
+  const char *data = json_data.data;
+  const bool in_object = container_stack.back() == Type::ObjectStart;
+  Token token;
+  size_t pos = skipWhiteSpace(json_data, cursor_index);
+  if (in_object)
+  {
+    if (pos >= json_data.size || data[pos] != '"')
+      return false;
+    const size_t name_end = structural_index.nextEntry(pos + 1);
+    if (name_end >= json_data.size || data[name_end] != '"')
+      return false;
+    const size_t delimiter = skipWhiteSpace(json_data, name_end + 1);
+    if (delimiter >= json_data.size || data[delimiter] != ':')
+      return false;
+    token.name = DataRef(data + pos + 1, name_end - pos - 1);
+    token.name_type = Type::String;
+    pos = skipWhiteSpace(json_data, delimiter + 1);
+  }
+  if (pos >= json_data.size)
+    return false;
+
+  Type type;
+  size_t value_end;
+  const char c = data[pos];
+  if (c == '"')
+  {
+    const size_t string_end = structural_index.nextEntry(pos + 1);
+    if (string_end >= json_data.size || data[string_end] != '"')
+      return false;
+    type = Type::String;
+    token.value = DataRef(data + pos + 1, string_end - pos - 1);
+    value_end = string_end + 1;
+  }
+  else if (c == '{' || c == '[')
+  {
+    type = c == '{' ? Type::ObjectStart : Type::ArrayStart;
+    token.value = DataRef(data + pos, 1);
+    value_end = pos + 1;
+  }
+  else
+  {
+    const unsigned char lc = Internal::lookup()[(unsigned char)c];
+    const size_t saved_cursor_index = cursor_index;
+    size_t diff = 0;
+    Error error;
+    cursor_index = pos + 1;
+    if (lc & (Internal::PlusOrMinus | Internal::Digits))
+    {
+      type = Type::Number;
+      error = findNumberEnd(json_data, &diff);
+    }
+    else if (lc & Internal::AsciiLetters)
+    {
+      type = Type::Ascii;
+      property_type = Type::Ascii;
+      error = findAsciiEnd(json_data, &diff);
+      property_type = Type::Error;
+    }
+    else
+    {
+      type = Type::Error;
+      error = Error::InvalidToken;
+    }
+    cursor_index = saved_cursor_index;
+    if (error != Error::NoError)
+      return false;
+    token.value = DataRef(data + pos, diff + 1);
+    value_end = pos + 1 + diff;
+  }
+  token.value_type = Internal::getType(type, token.value.data, token.value.size);
+
+  if (in_object)
+  {
+    if (token.value_type == Type::Ascii && !options.allow_ascii_properties)
+      return false;
+    token_state = type == Type::ObjectStart || type == Type::ArrayStart ? InTokenState::FindingName
+                                                                         : InTokenState::FindingTokenEnd;
+    cursor_index = value_end;
+  }
+  else if (type == Type::ObjectStart || type == Type::ArrayStart)
+  {
+    token_state = InTokenState::FindingName;
+    cursor_index = value_end;
+  }
+  else
+  {
+    const size_t delimiter = skipWhiteSpace(json_data, value_end);
+    if (delimiter >= json_data.size || (data[delimiter] != ',' && data[delimiter] != ']'))
+      return false;
+    token_state = InTokenState::FindingName;
+    cursor_index = data[delimiter] == ',' ? delimiter + 1 : delimiter;
+  }
+  expecting_prop_or_annonymous_data = false;
+  if (in_object)
+    next_token = token;
+  else
+    populate_annonymous_token(token.value, token.value_type, next_token);
+  return true;
+}
+
 inline Error Tokenizer::populateNextTokenFromDataRef(Token &next_token, const DataRef &json_data)
 {
+  if (options.use_structural_index && !structural_index.isBuiltFor(json_data.data, json_data.size))
+  {
+    const bool in_string = property_state == InPropertyState::FindingEnd && property_type == Type::String;
+    structural_index.build(json_data.data, json_data.size, cursor_index, in_string, is_escaped);
+  }
   Token tmp_token;
   while (cursor_index < json_data.size)
   {
@@ -1537,6 +2627,11 @@ inline Error Tokenizer::populateNextTokenFromDataRef(Token &next_token, const Da
     switch (token_state)
     {
     case InTokenState::FindingName:
+      if (!intermediate_token.active && !container_stack.empty() && structuralIndexUsable(json_data) &&
+          populateTokenFromStructuralIndex(next_token, json_data))
+      {
+        return Error::NoError;
+      }
       type = intermediate_token.name_type;
       error = populateFromDataRef(data, type, json_data);
       if (error == Error::NeedMoreData)
@@ -1572,7 +2667,7 @@ inline Error Tokenizer::populateNextTokenFromDataRef(Token &next_token, const Da
         {
         case Type::ObjectEnd:
         case Type::ArrayEnd:
-          if (expecting_prop_or_annonymous_data && !allow_superfluous_comma)
+          if (expecting_prop_or_annonymous_data && !options.allow_superfluous_comma)
           {
             return Error::ExpectedDataToken;
           }
@@ -1617,6 +2712,18 @@ inline Error Tokenizer::populateNextTokenFromDataRef(Token &next_token, const Da
       expecting_prop_or_annonymous_data = false;
       if (token_state == InTokenState::FindingName)
       {
+        if (intermediate_token.active)
+        {
+          // The value ended in a previous buffer, so tmp_token no longer
+          // refers to it. Move it to the data part of the intermediate token
+          // where isIntermediateValue looks for it.
+          intermediate_token.data.swap(intermediate_token.name);
+          intermediate_token.data_type = intermediate_token.name_type;
+          intermediate_token.data_type_set = true;
+          tmp_token.name = DataRef(intermediate_token.data);
+          tmp_token.name_type =
+            Internal::getType(intermediate_token.data_type, tmp_token.name.data, tmp_token.name.size);
+        }
         populate_annonymous_token(tmp_token.name, tmp_token.name_type, next_token);
         return Error::NoError;
       }
@@ -1624,7 +2731,7 @@ inline Error Tokenizer::populateNextTokenFromDataRef(Token &next_token, const Da
       {
         if (tmp_token.name_type != Type::String)
         {
-          if (!allow_ascii_properties || tmp_token.name_type != Type::Ascii)
+          if (!options.allow_ascii_properties || tmp_token.name_type != Type::Ascii)
           {
             return Error::IllegalPropertyName;
           }
@@ -1677,7 +2784,7 @@ inline Error Tokenizer::populateNextTokenFromDataRef(Token &next_token, const Da
       tmp_token.value = data;
       tmp_token.value_type = Internal::getType(type, tmp_token.value.data, tmp_token.value.size);
 
-      if (tmp_token.value_type == Type::Ascii && !allow_ascii_properties)
+      if (tmp_token.value_type == Type::Ascii && !options.allow_ascii_properties)
         return Error::IllegalDataValue;
 
       if (type == Type::ObjectStart || type == Type::ArrayStart)
@@ -1701,6 +2808,13 @@ inline Error Tokenizer::populateNextTokenFromDataRef(Token &next_token, const Da
       break;
     }
   }
+  if ((token_state == InTokenState::FindingDelimiter || token_state == InTokenState::FindingData) &&
+      !intermediate_token.active)
+  {
+    intermediate_token.name.append(tmp_token.name.data, tmp_token.name.size);
+    intermediate_token.name_type = tmp_token.name_type;
+    intermediate_token.active = true;
+  }
   return Error::NeedMoreData;
 }
 
@@ -1717,19 +2831,40 @@ inline Error Tokenizer::updateErrorContext(Error error, const std::string &custo
 {
   error_context.error = error;
   error_context.custom_message = custom_message;
-  if ((!parsed_data_vector || parsed_data_vector->empty()) && data_list.empty())
+  if (parsed_compact_tokens)
+  {
+    // Only tokens in the base buffer of the tape can be placed in the json.
+    const CompactToken *token =
+      cursor_index < parsed_compact_tokens->size() ? &parsed_compact_tokens->data[cursor_index] : nullptr;
+    if (!token || token->value_offset >= parsed_compact_tokens->baseSize())
+      return error;
+  }
+  else if ((!parsed_data_vector || parsed_data_vector->empty()) && data_list.empty())
+  {
     return error;
+  }
 
-  const DataRef json_data =
-    parsed_data_vector && parsed_data_vector->size()
-      ? DataRef(parsed_data_vector->front().value.data,
-                size_t(parsed_data_vector->back().value.data - parsed_data_vector->front().value.data))
-      : data_list.front();
-  int64_t real_cursor_index = parsed_data_vector && parsed_data_vector->size()
-                               ? int64_t (parsed_data_vector->at(cursor_index).value.data - json_data.data)
-                               : int64_t(cursor_index);
-  const int64_t stop_back = real_cursor_index - std::min(int64_t(real_cursor_index), int64_t(line_range_context));
-  const int64_t stop_forward = std::min(real_cursor_index + int64_t(line_range_context), int64_t(json_data.size));
+  DataRef json_data;
+  int64_t real_cursor_index;
+  if (parsed_compact_tokens)
+  {
+    json_data = DataRef(parsed_compact_tokens->baseData(), parsed_compact_tokens->baseSize());
+    real_cursor_index = int64_t(parsed_compact_tokens->data[cursor_index].value_offset);
+  }
+  else if (parsed_data_vector && parsed_data_vector->size())
+  {
+    json_data = DataRef(parsed_data_vector->front().value.data,
+                        size_t(parsed_data_vector->back().value.data - parsed_data_vector->front().value.data));
+    real_cursor_index = int64_t(parsed_data_vector->at(cursor_index).value.data - json_data.data);
+  }
+  else
+  {
+    json_data = data_list.front();
+    real_cursor_index = int64_t(cursor_index);
+  }
+  const int64_t line_range_context = int64_t(options.line_range_context);
+  const int64_t stop_back = real_cursor_index - std::min(int64_t(real_cursor_index), line_range_context);
+  const int64_t stop_forward = std::min(real_cursor_index + line_range_context, int64_t(json_data.size));
   std::vector<Internal::Lines> lines;
   lines.push_back({0, size_t(real_cursor_index)});
   assert(real_cursor_index <= int64_t(json_data.size));
@@ -1745,7 +2880,7 @@ inline Error Tokenizer::updateErrorContext(Error error, const std::string &custo
       lines_back++;
       if (lines_back == 1)
         error_context.character = size_t(real_cursor_index - cursor_back);
-      if (lines_back == int64_t(line_context))
+      if (lines_back == int64_t(options.line_context))
       {
         lines_back--;
         break;
@@ -1768,7 +2903,7 @@ inline Error Tokenizer::updateErrorContext(Error error, const std::string &custo
     {
       lines.back().end = size_t(cursor_forward);
       lines_forward++;
-      if (lines_forward == int64_t(line_context))
+      if (lines_forward == int64_t(options.line_context))
         break;
       add_new_line = true;
     }
@@ -1789,9 +2924,10 @@ inline Error Tokenizer::updateErrorContext(Error error, const std::string &custo
   {
     error_context.line = 0;
 
-    int64_t left = real_cursor_index > int64_t(range_context) ? real_cursor_index - int64_t(range_context) : 0;
-    int64_t right =
-      real_cursor_index + int64_t(range_context) > int64_t(json_data.size) ? int64_t(json_data.size) : real_cursor_index + int64_t(range_context);
+    const int64_t range_context = int64_t(options.range_context);
+    int64_t left = real_cursor_index > range_context ? real_cursor_index - range_context : 0;
+    int64_t right = real_cursor_index + range_context > int64_t(json_data.size) ? int64_t(json_data.size)
+                                                                                 : real_cursor_index + range_context;
     error_context.character = size_t(real_cursor_index - left);
     error_context.lines.push_back(std::string(json_data.data + left, size_t(right - left)));
   }
@@ -1808,16 +2944,7 @@ static inline JS::Error reformat(const char *data, size_t size, std::string &out
 
   Serializer serializer;
   serializer.setOptions(options);
-  size_t last_pos = 0;
-  auto cbref = serializer.addRequestBufferCallback([&out, &last_pos](Serializer &serializer_p) {
-    size_t end = out.size();
-    out.resize(end * 2);
-    serializer_p.setBuffer(&out[0] + end, end);
-    last_pos = end;
-  });
-  if (out.empty())
-    out.resize(4096);
-  serializer.setBuffer(&out[0], out.size());
+  serializer.useStringBuffer(out, std::max(size, size_t(4096)));
 
   while (true)
   {
@@ -1826,7 +2953,7 @@ static inline JS::Error reformat(const char *data, size_t size, std::string &out
       break;
     serializer.write(token);
   }
-  out.resize(last_pos + serializer.currentBuffer().used);
+  serializer.flushStringBuffer();
   if (error == Error::NeedMoreData)
     return Error::NoError;
 
@@ -1988,6 +3115,32 @@ constexpr Tuple<Ts...> makeTuple(Ts... args)
 }
 // Tuple end
 
+namespace Internal
+{
+constexpr char indentationSpace(size_t)
+{
+  return ' ';
+}
+
+/* ",\n" followed by a run of spaces. Pretty printed indentation is written as
+ * a slice of this buffer, so it is never built at runtime. */
+template <typename Seq>
+struct IndentationBuffer;
+template <size_t... Is>
+struct IndentationBuffer<Sequence<Is...>>
+{
+  static constexpr const size_t spaces = sizeof...(Is);
+  static constexpr const char data[spaces + 2] = {',', '\n', indentationSpace(Is)...};
+};
+
+template <size_t... Is>
+constexpr const size_t IndentationBuffer<Sequence<Is...>>::spaces;
+template <size_t... Is>
+constexpr const char IndentationBuffer<Sequence<Is...>>::data[];
+
+using Indentation = IndentationBuffer<GenSequence<256>::type>;
+} // namespace Internal
+
 inline SerializerOptions::SerializerOptions(Style style)
 
   : m_shift_size(style == Compact ? 0 : 2)
@@ -2049,11 +3202,17 @@ inline void SerializerOptions::skipDelimiter(bool skip)
 inline void SerializerOptions::setDepth(int depth)
 {
   m_depth = (unsigned char)depth;
-  m_prefix = m_style == Pretty ? std::string(depth * size_t(m_shift_size), ' ') : std::string();
+}
+
+/* Number of spaces written in front of a token at the current depth. */
+inline size_t SerializerOptions::indentation() const
+{
+  return m_style == Pretty ? m_depth * size_t(m_shift_size) : 0;
 }
 
 inline const std::string &SerializerOptions::prefix() const
 {
+  m_prefix.assign(indentation(), ' ');
   return m_prefix;
 }
 inline const std::string &SerializerOptions::tokenDelimiter() const
@@ -2100,101 +3259,158 @@ inline Serializer::Serializer(char *buffer, size_t size)
 
 inline void Serializer::setBuffer(char *buffer, size_t size)
 {
+  m_owned_buffer.reset();
+  m_string_buffer = nullptr;
   m_current_buffer = SerializerBuffer(buffer, size);
 }
 
+/* Makes the serializer write into a buffer it owns, which grows
+ * geometrically without zero filling and without invoking the buffer request
+ * callbacks. The output is currentBuffer().buffer with currentBuffer().used
+ * bytes, and it is valid until the serializer is destroyed or given another
+ * buffer. */
+inline void Serializer::useOwnedBuffer(size_t initial_size)
+{
+  m_owned_buffer.reset();
+  m_string_buffer = nullptr;
+  m_current_buffer = SerializerBuffer();
+  growOwnedBuffer(initial_size);
+}
+
+/* Makes the serializer write straight into out, replacing its content. out is
+ * grown geometrically like an owned buffer, so the output is never copied,
+ * but growing a string zero fills the added space once. This is slower than
+ * useOwnedBuffer and one copy of the output for large documents. The size of out is
+ * its capacity while serializing, flushStringBuffer() trims it to the
+ * output. */
+inline void Serializer::useStringBuffer(std::string &out, size_t initial_size)
+{
+  m_owned_buffer.reset();
+  m_string_buffer = &out;
+  out.clear();
+  out.resize(std::max(out.capacity(), initial_size));
+  m_current_buffer = SerializerBuffer(&out[0], out.size());
+}
+
+inline void Serializer::flushStringBuffer()
+{
+  if (!m_string_buffer)
+    return;
+  m_string_buffer->resize(m_current_buffer.used);
+  m_current_buffer.size = m_current_buffer.used;
+}
+
 inline void Serializer::setOptions(const SerializerOptions &option)
 {
   m_option = option;
 }
 
+/* Puts the serializer in the state it would have inside a container at depth,
+ * after_value telling if a value has already been written in it. Output
+ * written from here continues a document serialized by another serializer,
+ * with the same delimiters and indentation. */
+inline void Serializer::resume(int depth, bool after_value)
+{
+  m_option.setDepth(depth);
+  m_first = false;
+  m_token_start = !after_value;
+}
 
-inline bool Serializer::write(const Token &in_token)
+
+inline bool Serializer::write(const Token &token)
 {
-  auto begining_literals = makeTuple( JS::Internal::makeStringLiteral("\n  "),
-                                      Internal::makeStringLiteral("\n    "),
-                                      Internal::makeStringLiteral("\n      "),
-                                      Internal::makeStringLiteral("\n        "),
-                                      Internal::makeStringLiteral("\n          "),
-                                      Internal::makeStringLiteral(",\n  "),
-                                      Internal::makeStringLiteral(",\n    "),
-                                      Internal::makeStringLiteral(",\n      "),
-                                      Internal::makeStringLiteral(",\n        "),
-                                      Internal::makeStringLiteral(",\n          "));
-  //auto begining_literals_compat = makeTuple( Internal::makeStringLiteral(",\""));
-  const Token &token = in_token;
+  return writeToken(token, false);
+}
 
-  bool isEnd = token.value_type == Type::ObjectEnd || token.value_type == Type::ArrayEnd;
-  if (isEnd)
-  {
-    assert(m_option.depth() > 0);
-    m_option.setDepth(m_option.depth() - 1);
-  }
+/* Writes a String token whose value is unescaped text, escaping it directly
+ * into the output. */
+inline bool Serializer::writeEscaped(const Token &token)
+{
+  return writeToken(token, true);
+}
 
-  bool shortcut_front = false;
-  if (m_option.shiftSize() == 2 && !m_first)
+/* Writes a Number token whose value is formatted straight into the output.
+ * The delimiter, indentation and name are written as for write(token), then
+ * MaxSize bytes are reserved and format(char *out) writes the value and
+ * returns its size. token.value is not used. */
+template <size_t MaxSize, typename Format>
+inline bool Serializer::writeNumber(const Token &token, Format format)
+{
+  // Room for a delimiter as well, so array elements in compact output need
+  // only this one check.
+  if (m_current_buffer.free() <= MaxSize && (m_owned_buffer || m_string_buffer) && !growOwnedBuffer(MaxSize + 1))
+    return false;
+  if (!token.name.size && m_option.postfix().empty() && !m_option.indentation() && m_current_buffer.free() > MaxSize)
+  {
+    char *out = m_current_buffer.buffer + m_current_buffer.used;
+    if (!m_token_start && !m_option.tokenDelimiter().empty())
+      *out++ = ',';
+    m_first = false;
+    m_token_start = false;
+    out += format(out);
+    m_current_buffer.used = size_t(out - m_current_buffer.buffer);
+    return true;
+  }
+  if (!writeTokenStart(token))
+    return false;
+  m_token_start = false;
+  if (m_current_buffer.free() < MaxSize && (m_owned_buffer || m_string_buffer) && !growOwnedBuffer(MaxSize))
+    return false;
+  if (m_current_buffer.free() >= MaxSize)
   {
-    if (!m_token_start && !isEnd)
-    {
-      if (m_option.depth() == 1)
-        shortcut_front = write(begining_literals.get<5>());
-      else if (m_option.depth() == 2)
-        shortcut_front = write(begining_literals.get<6>());
-      else if (m_option.depth() == 3)
-        shortcut_front = write(begining_literals.get<7>());
-      else if (m_option.depth() == 4)
-        shortcut_front = write(begining_literals.get<8>());
-      else if (m_option.depth() == 5)
-        shortcut_front = write(begining_literals.get<9>());
-    }
-    else
-    {
-      if (m_option.depth() == 1)
-        shortcut_front = write(begining_literals.get<0>());
-      else if (m_option.depth() == 2)
-        shortcut_front = write(begining_literals.get<1>());
-      else if (m_option.depth() == 3)
-        shortcut_front = write(begining_literals.get<2>());
-      else if (m_option.depth() == 4)
-        shortcut_front = write(begining_literals.get<3>());
-      else if (m_option.depth() == 5)
-        shortcut_front = write(begining_literals.get<4>());
-
-    }
+    m_current_buffer.used += format(m_current_buffer.buffer + m_current_buffer.used);
+    return true;
   }
+  char value[MaxSize];
+  return write(value, format(value));
+}
+
+inline bool Serializer::writeToken(const Token &token, bool escape_value)
+{
+  if (!writeTokenStart(token))
+    return false;
 
-  if (!shortcut_front)
+  if (escape_value && token.value_type == Type::String)
   {
-    if (!m_token_start)
-    {
-      if (!isEnd)
-      {
-        if (!m_option.tokenDelimiter().empty())
-        {
-          if (!write(Internal::makeStringLiteral(",")))
-            return false;
-        }
-      }
-    }
+    if (!writeAsEscapedString(token.value))
+      return false;
+  }
+  else if (!write(token.value_type, token.value))
+  {
+    return false;
+  }
 
-    if (m_first)
-    {
-      m_first = false;
-    }
-    else
-    {
-      if (!m_option.postfix().empty())
-        if (!write(m_option.postfix()))
-          return false;
-    }
+  m_token_start = (token.value_type == Type::ObjectStart || token.value_type == Type::ArrayStart);
+  if (m_token_start)
+  {
+    m_option.setDepth(m_option.depth() + 1);
+  }
+  return true;
+}
 
+// Writes everything in front of the value of a token.
+inline bool Serializer::writeTokenStart(const Token &token)
+{
+  bool isEnd = token.value_type == Type::ObjectEnd || token.value_type == Type::ArrayEnd;
+  if (isEnd)
+  {
+    assert(m_option.depth() > 0);
+    m_option.setDepth(m_option.depth() - 1);
+  }
 
-    if (!m_option.prefix().empty())
-      if (!write(m_option.prefix()))
-        return false;
+  bool delimiter = !m_token_start && !isEnd && !m_option.tokenDelimiter().empty();
+  bool newline = !m_first && !m_option.postfix().empty();
+  m_first = false;
+  if (!writeIndentation(delimiter, newline, m_option.indentation()))
+    return false;
 
+  if (token.name.size && token.name.data == m_member_name.data && token.name.size == m_member_name.size &&
+      token.name_type == Type::Ascii && m_option.convertAsciiToString())
+  {
+    if (!write(m_member_key, m_member_name.size + (m_option.style() == SerializerOptions::Pretty ? 4 : 3)))
+      return false;
   }
-  if (token.name.size)
+  else if (token.name.size)
   {
     if (!write(token.name_type, token.name))
       return false;
@@ -2210,18 +3426,44 @@ inline bool Serializer::write(const Token &in_token)
         return false;
     }
   }
+  return true;
+}
 
-  if (!write(token.value_type, token.value))
+/* Writes the token delimiter, newline and indentation in front of a token as
+ * one slice of Internal::Indentation. Only indentation deeper than the buffer
+ * needs more than one write. */
+inline bool Serializer::writeIndentation(bool delimiter, bool newline, size_t indentation)
+{
+  using Buffer = Internal::Indentation;
+  if (delimiter && !newline)
+  {
+    if (!write(Internal::makeStringLiteral(",")))
+      return false;
+    delimiter = false;
+  }
+  size_t head = size_t(delimiter) + size_t(newline);
+  size_t spaces = std::min(indentation, Buffer::spaces);
+  if (head + spaces && !write(Buffer::data + 2 - head, head + spaces))
     return false;
-
-  m_token_start = (token.value_type == Type::ObjectStart || token.value_type == Type::ArrayStart);
-  if (m_token_start)
+  indentation -= spaces;
+  while (indentation)
   {
-    m_option.setDepth(m_option.depth() + 1);
+    spaces = std::min(indentation, Buffer::spaces);
+    if (!write(Buffer::data + 2, spaces))
+      return false;
+    indentation -= spaces;
   }
   return true;
 }
 
+/* Registers the pre-rendered key of the member about to be serialized. When
+ * a token has exactly this name, the key is written with a single copy. */
+inline void Serializer::setMemberKey(const DataRef &name, const char *key)
+{
+  m_member_name = name;
+  m_member_key = key;
+}
+
 inline const BufferRequestCBRef Serializer::addRequestBufferCallback(std::function<void(Serializer &)> callback)
 {
   return m_request_buffer_callbacks.addCallback(callback);
@@ -2237,6 +3479,26 @@ inline void Serializer::askForMoreBuffers()
   m_request_buffer_callbacks.invokeCallbacks(*this);
 }
 
+inline bool Serializer::growOwnedBuffer(size_t needed)
+{
+  size_t new_size = std::max(m_current_buffer.size * 2, m_current_buffer.used + needed);
+  if (m_string_buffer)
+  {
+    m_string_buffer->resize(new_size);
+    m_current_buffer.buffer = &(*m_string_buffer)[0];
+    m_current_buffer.size = new_size;
+    return true;
+  }
+  char *new_buffer = static_cast<char *>(realloc(m_owned_buffer.get(), new_size));
+  if (!new_buffer)
+    return false;
+  m_owned_buffer.release();
+  m_owned_buffer.reset(new_buffer);
+  m_current_buffer.buffer = new_buffer;
+  m_current_buffer.size = new_size;
+  return true;
+}
+
 inline void Serializer::markCurrentSerializerBufferFull()
 {
   m_current_buffer = SerializerBuffer();
@@ -2259,6 +3521,27 @@ inline bool Serializer::writeAsString(const DataRef &data)
   return written;
 }
 
+inline bool Serializer::writeAsEscapedString(const DataRef &data)
+{
+  if (!write(Internal::makeStringLiteral("\"")))
+    return false;
+  size_t start = 0;
+  size_t pos = Internal::findEscapeOut(data.data, 0, data.size);
+  while (pos < data.size)
+  {
+    if (!write(data.data + start, pos - start))
+      return false;
+    const char *escaped = Internal::escapeSequenceOut(data.data[pos]);
+    if (!(escaped ? write(escaped, 2) : write(data.data + pos, 1)))
+      return false;
+    start = pos + 1;
+    pos = Internal::findEscapeOut(data.data, start, data.size);
+  }
+  if (!write(data.data + start, data.size - start))
+    return false;
+  return write(Internal::makeStringLiteral("\""));
+}
+
 inline bool Serializer::write(Type type, const DataRef &data)
 {
   bool written;
@@ -2285,8 +3568,14 @@ inline bool Serializer::write(Type type, const DataRef &data)
 
 inline bool Serializer::write(const char *data, size_t size)
 {
-  if (!size)
+  if (m_current_buffer.free() < size && (m_owned_buffer || m_string_buffer) && !growOwnedBuffer(size))
+    return false;
+  if (m_current_buffer.free() >= size)
+  {
+    if (size)
+      m_current_buffer.append(data, size);
     return true;
+  }
   size_t written = 0;
   while (written < size)
   {
@@ -2649,52 +3938,68 @@ struct JsonMeta
   bool has_data : 1;
 };
 
-static inline std::vector<JsonMeta> metaForTokens(const JsonTokens &tokens)
+namespace Internal
+{
+/* Builds the meta of every object and array in tokens in one pass. size,
+ * skip and has_data are filled in when the scope closes, from the token and
+ * meta counts since it opened, so each token is only visited once. */
+template <typename ValueTypeAt>
+inline std::vector<JsonMeta> metaForTokenTypes(size_t token_count, ValueTypeAt value_type_at)
 {
   std::vector<JsonMeta> meta;
-  meta.reserve(tokens.data.size() / 4);
+  meta.reserve(token_count / 4);
   std::vector<size_t> parent;
-  for (size_t i = 0; i < tokens.data.size(); i++)
+  auto close_scope = [&meta, &parent](size_t end) {
+    JsonMeta &closing = meta[parent.back()];
+    closing.size = uint32_t(end - closing.position);
+    closing.skip = uint32_t(meta.size() - parent.back());
+    bool has_data = closing.has_data;
+    parent.pop_back();
+    if (has_data && parent.size())
+      meta[parent.back()].has_data = true;
+  };
+  for (size_t i = 0; i < token_count; i++)
   {
-    for (size_t parent_index : parent)
-    {
-      meta[parent_index].size++;
-    }
-    const JS::Token &token = tokens.data.at(i);
-    if (token.value_type == Type::ArrayEnd || token.value_type == Type::ObjectEnd)
+    const Type value_type = value_type_at(i);
+    if (value_type == Type::ArrayEnd || value_type == Type::ObjectEnd)
     {
       assert(parent.size());
-      assert(meta[parent.back()].is_array == (token.value_type == Type::ArrayEnd));
-      parent.pop_back();
+      assert(meta[parent.back()].is_array == (value_type == Type::ArrayEnd));
+      close_scope(i + 1);
     }
-    else
+    else if (value_type == Type::ArrayStart || value_type == Type::ObjectStart)
     {
       if (parent.size())
+      {
         meta[parent.back()].children++;
-    }
-
-    if (token.value_type == Type::ArrayStart || token.value_type == Type::ObjectStart)
-    {
-      if (parent.size())
         meta[parent.back()].complex_children++;
-      for (size_t parent_index : parent)
-      {
-        meta[parent_index].skip++;
       }
-      meta.push_back(JsonMeta(i, token.value_type == Type::ArrayStart));
+      meta.push_back(JsonMeta(i, value_type == Type::ArrayStart));
       parent.push_back(meta.size() - 1);
     }
-    else if (token.value_type != JS::Type::ArrayEnd && token.value_type != JS::Type::ObjectEnd)
+    else if (parent.size())
     {
-      for (size_t parent_index : parent)
-      {
-        meta[parent_index].has_data = true;
-      }
+      meta[parent.back()].children++;
+      meta[parent.back()].has_data = true;
     }
   }
   assert(!parent.size()); // This assert may be triggered when JSON is invalid (e.g. when creating a DiffContext).
+  while (parent.size())
+    close_scope(token_count);
   return meta;
 }
+} // namespace Internal
+
+static inline std::vector<JsonMeta> metaForTokens(const JsonTokens &tokens)
+{
+  return Internal::metaForTokenTypes(tokens.data.size(),
+                                     [&tokens](size_t index) { return tokens.data[index].value_type; });
+}
+
+static inline std::vector<JsonMeta> metaForTokens(const CompactJsonTokens &tokens)
+{
+  return Internal::metaForTokenTypes(tokens.size(), [&tokens](size_t index) { return tokens.valueType(index); });
+}
 
 namespace Internal
 {
@@ -2747,7 +4052,214 @@ struct IsOptionalType<std::optional<T>>
 };
 #endif
 
-struct ParseContext
+/*!
+ * \brief Block allocator for data that has to outlive a parse.
+ *
+ * String values that can not point straight into the input, because they
+ * contain escapes or span two buffers, are unescaped into the arena set on
+ * ParseContext::arena when parsed into a DataRef or std::string_view. Empty
+ * containers using JS::ArenaAllocator or, with C++17, std::pmr allocators are
+ * bound to ParseContext::arena by their TypeHandlers, unless they were
+ * constructed with an arena or memory resource of their own. Memory is only
+ * released by clear() or when the arena is destroyed, so everything parsed
+ * with an arena has to be destroyed or cleared before the arena.
+ */
+class Arena
+#ifdef JS_STD_MEMORY_RESOURCE
+  : public std::pmr::memory_resource
+#endif
+{
+public:
+  explicit Arena(size_t block_size = 4096)
+    : block_size(block_size)
+  {
+  }
+  Arena(const Arena &) = delete;
+  Arena &operator=(const Arena &) = delete;
+
+  void *allocate(size_t size, size_t alignment = alignof(max_align_t))
+  {
+    uintptr_t start = (uintptr_t(position) + alignment - 1) & ~uintptr_t(alignment - 1);
+    if (!position || start + size > uintptr_t(end))
+    {
+      Block block = {std::unique_ptr<char[]>(new char[std::max(block_size, size + alignment)]),
+                     std::max(block_size, size + alignment)};
+      blocks.push_back(std::move(block));
+      position = blocks.back().data.get();
+      end = position + blocks.back().size;
+      start = (uintptr_t(position) + alignment - 1) & ~uintptr_t(alignment - 1);
+    }
+    position = reinterpret_cast<char *>(start + size);
+    return reinterpret_cast<void *>(start);
+  }
+
+  /// Returns true if p points into memory allocated from this arena.
+  bool owns(const void *p) const
+  {
+    for (auto &block : blocks)
+    {
+      if (p >= block.data.get() && p < block.data.get() + block.size)
+        return true;
+    }
+    return false;
+  }
+
+  /// Releases all allocations, but keeps the first block for reuse.
+  void clear()
+  {
+    if (blocks.empty())
+      return;
+    blocks.resize(1);
+    position = blocks.front().data.get();
+    end = position + blocks.front().size;
+  }
+
+  /// The arena installed for the current thread by ArenaScope, or nullptr.
+  static Arena *&current()
+  {
+    static thread_local Arena *arena = nullptr;
+    return arena;
+  }
+
+private:
+#ifdef JS_STD_MEMORY_RESOURCE
+  void *do_allocate(size_t size, size_t alignment) override
+  {
+    return allocate(size, alignment);
+  }
+  void do_deallocate(void *, size_t, size_t) override
+  {
+  }
+  bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override
+  {
+    return this == &other;
+  }
+#endif
+
+  struct Block
+  {
+    std::unique_ptr<char[]> data;
+    size_t size;
+  };
+  size_t block_size;
+  std::vector<Block> blocks;
+  char *position = nullptr;
+  char *end = nullptr;
+};
+
+/*!
+ * \brief Installs an arena as Arena::current() for the lifetime of the scope.
+ *
+ * Default constructed ArenaAllocators allocate from the current arena. This
+ * is a convenience for constructing objects outside of a parse, parsing does
+ * not depend on it.
+ */
+struct ArenaScope
+{
+  explicit ArenaScope(Arena *arena)
+    : previous(Arena::current())
+  {
+    if (arena)
+      Arena::current() = arena;
+  }
+  ~ArenaScope()
+  {
+    Arena::current() = previous;
+  }
+  ArenaScope(const ArenaScope &) = delete;
+  ArenaScope &operator=(const ArenaScope &) = delete;
+
+private:
+  Arena *previous;
+};
+
+/*!
+ * \brief Standard allocator allocating from an Arena.
+ *
+ * A default constructed allocator uses Arena::current(), which is only set
+ * inside an ArenaScope. Without an arena it falls back to the global
+ * allocator. Deallocation is a no-op for arena memory. The allocator moves
+ * with its container, which is how TypeHandlers bind an empty container to
+ * ParseContext::arena.
+ */
+template <typename T>
+class ArenaAllocator
+{
+public:
+  using value_type = T;
+  using propagate_on_container_move_assignment = std::true_type;
+
+  ArenaAllocator() noexcept
+    : arena(Arena::current())
+  {
+  }
+  explicit ArenaAllocator(Arena *arena) noexcept
+    : arena(arena)
+  {
+  }
+  template <typename U>
+  ArenaAllocator(const ArenaAllocator<U> &other) noexcept
+    : arena(other.arena)
+  {
+  }
+
+  T *allocate(size_t n)
+  {
+    if (!arena)
+      return std::allocator<T>().allocate(n);
+    return static_cast<T *>(arena->allocate(n * sizeof(T), alignof(T)));
+  }
+
+  void deallocate(T *p, size_t n)
+  {
+    if (!arena)
+      std::allocator<T>().deallocate(p, n);
+  }
+
+  Arena *arena;
+};
+
+template <typename T, typename U>
+bool operator==(const ArenaAllocator<T> &a, const ArenaAllocator<U> &b)
+{
+  return a.arena == b.arena;
+}
+
+template <typename T, typename U>
+bool operator!=(const ArenaAllocator<T> &a, const ArenaAllocator<U> &b)
+{
+  return a.arena != b.arena;
+}
+
+template <typename T>
+using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+using ArenaString = std::basic_string<char, std::char_traits<char>, ArenaAllocator<char>>;
+
+/*!
+ * \brief The configuration of a ParseContext.
+ *
+ * Every option and its default is listed here. ParseContext inherits the
+ * members, so they are set directly on the context, and a context is returned
+ * to its defaults by assigning a default constructed instance.
+ */
+struct ParseContextOptions
+{
+  bool allow_missing_members = true;
+  bool allow_unasigned_required_members = true;
+  bool track_member_assignement_state = true;
+  // Skip the objects and arrays of missing members by scanning for the
+  // closing bracket instead of tokenizing them. Their content is then not
+  // validated.
+  bool fast_skip_missing_members = false;
+  // Stop parsing a JS::Projection as soon as all its members have been read.
+  // The rest of its object is skipped without validating it. A root object
+  // that does not end in the buffer is left unread.
+  bool stop_after_projected_members = false;
+  Arena *arena = nullptr;
+  void *user_data = nullptr;
+};
+
+struct ParseContext : ParseContextOptions
 {
   ParseContext()
   {
@@ -2784,6 +4296,23 @@ struct ParseContext
   template <typename T>
   Error parseTo(T &to_type);
 
+  /* Prepares the context for parsing a new document, keeping the
+   * configuration, the member prediction statistics and all allocated
+   * capacity, so a reused context parses without allocating. */
+  void reset(const char *data, size_t size)
+  {
+    tokenizer.reset(data, size);
+    token = Token();
+    error = Error::NoError;
+    missing_members.clear();
+    unassigned_required_members.clear();
+  }
+
+  void reset(const std::string &data)
+  {
+    reset(data.data(), data.size());
+  }
+
   Error nextToken()
   {
     error = tokenizer.nextToken(token);
@@ -2840,16 +4369,85 @@ struct ParseContext
     return tokenizer.makeErrorString();
   }
 
+  // Fraction of struct members that were found by predicting that the json keys
+  // are in declaration order. A low value means the producer's key order differs.
+  double memberPredictionHitRate() const
+  {
+    size_t total = member_prediction_hits + member_prediction_misses;
+    return total ? double(member_prediction_hits) / double(total) : 1.0;
+  }
+
   Tokenizer tokenizer;
   Token token;
   Error error = Error::NoError;
   std::vector<std::string> missing_members;
   std::vector<std::string> unassigned_required_members;
-  bool allow_missing_members = true;
-  bool allow_unasigned_required_members = true;
-  bool track_member_assignement_state = true;
-  void *user_data = nullptr;
+  size_t member_prediction_hits = 0;
+  size_t member_prediction_misses = 0;
+};
+
+namespace Internal
+{
+/* Passes ParseContext::arena to the containers a TypeHandler parses into.
+ * Only containers without an arena or memory resource of their own are
+ * bound, so an allocator chosen by the caller is always kept. */
+template <typename Allocator>
+struct ContextAllocator
+{
+  static Allocator select(const Allocator &allocator, const ParseContext &)
+  {
+    return allocator;
+  }
+
+  template <typename Container>
+  static void bind(Container &, const ParseContext &)
+  {
+  }
+};
+
+template <typename T>
+struct ContextAllocator<ArenaAllocator<T>>
+{
+  static ArenaAllocator<T> select(const ArenaAllocator<T> &allocator, const ParseContext &context)
+  {
+    return allocator.arena || !context.arena ? allocator : ArenaAllocator<T>(context.arena);
+  }
+
+  template <typename Container>
+  static void bind(Container &container, const ParseContext &context)
+  {
+    if (container.empty() && !container.get_allocator().arena && context.arena)
+      container = Container(ArenaAllocator<T>(context.arena));
+  }
+};
+
+#ifdef JS_STD_MEMORY_RESOURCE
+template <typename T>
+struct ContextAllocator<std::pmr::polymorphic_allocator<T>>
+{
+  static std::pmr::polymorphic_allocator<T> select(const std::pmr::polymorphic_allocator<T> &allocator,
+                                                   const ParseContext &context)
+  {
+    if (!context.arena || allocator.resource() != std::pmr::get_default_resource())
+      return allocator;
+    return std::pmr::polymorphic_allocator<T>(context.arena);
+  }
+
+  // The allocator of a pmr container can not be replaced, so the empty
+  // container is recreated with the arena.
+  template <typename Container>
+  static void bind(Container &container, const ParseContext &context)
+  {
+    if (!std::is_nothrow_move_constructible<Container>::value || !container.empty() || !context.arena ||
+        container.get_allocator().resource() != std::pmr::get_default_resource())
+      return;
+    Container bound((std::pmr::polymorphic_allocator<T>(context.arena)));
+    container.~Container();
+    new (&container) Container(std::move(bound));
+  }
 };
+#endif
+} // namespace Internal
 
 /*! \def JS_MEMBER
  *
@@ -3102,10 +4700,26 @@ constexpr const Internal::SuperInfo<T> makeSuperInfo(const char (&name)[NAME_SIZ
 template <typename T, typename Enable = void>
 struct TypeHandler
 {
+  // Only present in the handler of JS_OBJ types, so ValidateHandler can tell
+  // them apart from specializations.
+  typedef void js_object_handler;
   static inline Error to(T &to_type, ParseContext &context);
   static inline void from(const T &from_type, Token &token, Serializer &serializer);
 };
 
+/*!
+ * \brief Checks that the current value parses as T, without creating a T.
+ *
+ * JS_OBJ types, containers and optional wrappers are walked token by token.
+ * Other types are parsed into a temporary with their TypeHandler. Specialize
+ * this for custom types where the temporary would allocate.
+ */
+template <typename T, typename Enable = void>
+struct ValidateHandler
+{
+  static inline Error validate(ParseContext &context);
+};
+
 namespace Internal
 {
 template <size_t STRINGSIZE>
@@ -3181,14 +4795,43 @@ inline Error verifyMember(const MemberInfo<MI_T, MI_M, MI_NC> &memberInfo, size_
   return Error::UnassignedRequiredMember;
 }
 
-template <typename T, typename MI_T, typename MI_M, typename MI_NC>
+template <size_t SIZE>
+struct KeyLiteral
+{
+  char data[SIZE];
+};
+
+template <size_t NAME_SIZE, size_t... Is>
+constexpr KeyLiteral<NAME_SIZE + 4> makeKeyLiteral(const char *name, Sequence<Is...>)
+{
+  return {{'"', name[Is]..., '"', ':', ' '}};
+}
+
+/* The primary name of member INDEX of T rendered as it is serialized,
+ * '"name": ', at compile time. Compact style uses all but the last space. */
+template <typename T, size_t INDEX>
+struct MemberKey
+{
+  using Members = decltype(JsonStructBaseDummy<T, T>::js_static_meta_data_info());
+  using NameTuple = decltype(TypeAt<INDEX, Members>::type::names);
+  static constexpr const size_t name_size = TypeAt<0, NameTuple>::type::size;
+  static constexpr const KeyLiteral<name_size + 4> key = makeKeyLiteral<name_size>(
+    JsonStructBaseDummy<T, T>::js_static_meta_data_info().template get<INDEX>().names.template get<0>().data,
+    typename GenSequence<name_size>::type());
+};
+
+template <typename T, size_t INDEX>
+constexpr const KeyLiteral<MemberKey<T, INDEX>::name_size + 4> MemberKey<T, INDEX>::key;
+
+template <typename T, typename MI_T, typename MI_M, typename MI_NC>
 inline void serializeMember(const T &from_type, const MemberInfo<MI_T, MI_M, MI_NC> &memberInfo, Token &token,
-                            Serializer &serializer, const char *super_name)
+                            Serializer &serializer, const char *super_name, const char *key)
 {
   JS_UNUSED(super_name);
   token.name.data = memberInfo.names.template get<0>().data;
   token.name.size = memberInfo.names.template get<0>().size;
   token.name_type = Type::Ascii;
+  serializer.setMemberKey(token.name, key);
 
   TypeHandler<MI_T>::from(from_type.*memberInfo.member, token, serializer);
 }
@@ -3300,7 +4943,8 @@ struct MemberChecker
   inline static void serializeMembers(const T &from_type, const Members &members, Token &token, Serializer &serializer,
                                       const char *super_name)
   {
-    serializeMember(from_type, members.template get<Members::size - INDEX - 1>(), token, serializer, super_name);
+    serializeMember(from_type, members.template get<Members::size - INDEX - 1>(), token, serializer, super_name,
+                    MemberKey<T, Members::size - INDEX - 1>::key.data);
     MemberChecker<T, Members, PAGE, INDEX - 1>::serializeMembers(from_type, members, token, serializer, super_name);
   }
 };
@@ -3336,7 +4980,8 @@ struct MemberChecker<T, Members, PAGE, 0>
   inline static void serializeMembers(const T &from_type, const Members &members, Token &token, Serializer &serializer,
                                       const char *super_name)
   {
-    serializeMember(from_type, members.template get<Members::size - 1>(), token, serializer, super_name);
+    serializeMember(from_type, members.template get<Members::size - 1>(), token, serializer, super_name,
+                    MemberKey<T, Members::size - 1>::key.data);
     using Super = decltype(Internal::template JsonStructBaseDummy<T, T>::js_static_meta_super_info());
     StartSuperRecursion<T, PAGE + Members::size, Super::size>::serializeMembers(from_type, token, serializer);
   }
@@ -3437,6 +5082,201 @@ struct SuperClassHandler<T, PAGE, 0>
   }
 };
 
+/* FNV-1a of a json name, used by the member lookup tables. */
+inline size_t hashName(const char *data, size_t size)
+{
+  size_t hash = 2166136261u;
+  for (size_t i = 0; i < size; i++)
+    hash = (hash ^ (unsigned char)data[i]) * 16777619u;
+  return hash ^ size;
+}
+
+template <typename T>
+struct MemberLookupEntry
+{
+  const char *name;
+  size_t name_size;
+  size_t index;
+  Error (*unpack)(T &to_type, ParseContext &context);
+};
+
+/* Maps the json names of all the members of T, including aliases and members
+ * of super classes, to the member index and a function unpacking that member.
+ * It is built once per type, and names resolve with one hash and on average
+ * a single compare. Names are added in the same order as MemberChecker checks
+ * them, and the first one added wins, so duplicate names resolve to the same
+ * member as with the linear search.
+ *
+ * Member indices follow the serialization order, so predict() can check the
+ * primary name of the member following the previously parsed one with a
+ * single compare when the input has the keys in declaration order. */
+template <typename T>
+class MemberLookupTable
+{
+public:
+  static const MemberLookupTable &get()
+  {
+    static const MemberLookupTable table;
+    return table;
+  }
+
+  const MemberLookupEntry<T> *find(const DataRef &name) const
+  {
+    size_t slot = hashName(name.data, name.size) & mask;
+    while (table[slot])
+    {
+      const MemberLookupEntry<T> &entry = entries[table[slot] - 1];
+      if (entry.name_size == name.size && memcmp(entry.name, name.data, name.size) == 0)
+        return &entry;
+      slot = (slot + 1) & mask;
+    }
+    return nullptr;
+  }
+
+  const MemberLookupEntry<T> *predict(size_t index, const DataRef &name) const
+  {
+    if (index >= ordered.size() || !ordered[index])
+      return nullptr;
+    const MemberLookupEntry<T> &entry = entries[ordered[index] - 1];
+    if (entry.name_size == name.size && memcmp(entry.name, name.data, name.size) == 0)
+      return &entry;
+    return nullptr;
+  }
+
+  void add(const char *name, size_t name_size, size_t index, Error (*unpack)(T &, ParseContext &))
+  {
+    for (auto &entry : entries)
+    {
+      if (entry.name_size == name_size && memcmp(entry.name, name, name_size) == 0)
+        return;
+    }
+    MemberLookupEntry<T> entry = {name, name_size, index, unpack};
+    entries.push_back(entry);
+  }
+
+private:
+  MemberLookupTable();
+
+  std::vector<MemberLookupEntry<T>> entries;
+  std::vector<uint32_t> table;
+  std::vector<uint32_t> ordered;
+  size_t mask;
+};
+
+template <typename T, typename Owner, size_t INDEX>
+Error unpackMemberAt(T &to_type, ParseContext &context)
+{
+  using Members = decltype(Internal::template JsonStructBaseDummy<Owner, Owner>::js_static_meta_data_info());
+  using MI_T = typename TypeAt<INDEX, Members>::type::type;
+  auto members = Internal::template JsonStructBaseDummy<Owner, Owner>::js_static_meta_data_info();
+  return TypeHandler<MI_T>::to(static_cast<Owner &>(to_type).*(members.template get<INDEX>().member), context);
+}
+
+template <typename T, typename NameTuple, size_t NAME_INDEX>
+struct MemberLookupNames
+{
+  static void addAliases(MemberLookupTable<T> &table, const NameTuple &names, size_t index,
+                         Error (*unpack)(T &, ParseContext &))
+  {
+    MemberLookupNames<T, NameTuple, NAME_INDEX - 1>::addAliases(table, names, index, unpack);
+    auto &name = names.template get<NAME_INDEX>();
+    table.add(name.data, name.size, index, unpack);
+  }
+};
+
+template <typename T, typename NameTuple>
+struct MemberLookupNames<T, NameTuple, 0>
+{
+  static void addAliases(MemberLookupTable<T> &table, const NameTuple &names, size_t index,
+                         Error (*unpack)(T &, ParseContext &))
+  {
+    JS_UNUSED(table);
+    JS_UNUSED(names);
+    JS_UNUSED(index);
+    JS_UNUSED(unpack);
+  }
+};
+
+template <typename T, typename Owner, size_t PAGE, size_t SIZE>
+struct SuperLookupBuilder;
+
+template <typename T, typename Owner, size_t PAGE, size_t INDEX>
+struct MemberLookupBuilder
+{
+  static void addMembers(MemberLookupTable<T> &table, bool primary)
+  {
+    using Members = decltype(Internal::template JsonStructBaseDummy<Owner, Owner>::js_static_meta_data_info());
+    using NameTuple = decltype(TypeAt<INDEX, Members>::type::names);
+    auto members = Internal::template JsonStructBaseDummy<Owner, Owner>::js_static_meta_data_info();
+    auto &names = members.template get<INDEX>().names;
+    if (primary)
+      table.add(names.template get<0>().data, names.template get<0>().size, PAGE + INDEX,
+                &unpackMemberAt<T, Owner, INDEX>);
+    else
+      MemberLookupNames<T, NameTuple, NameTuple::size - 1>::addAliases(table, names, PAGE + INDEX,
+                                                                        &unpackMemberAt<T, Owner, INDEX>);
+    MemberLookupBuilder<T, Owner, PAGE, INDEX - 1>::addMembers(table, primary);
+  }
+};
+
+template <typename T, typename Owner, size_t PAGE>
+struct MemberLookupBuilder<T, Owner, PAGE, size_t(-1)>
+{
+  static void addMembers(MemberLookupTable<T> &table, bool primary)
+  {
+    using Members = decltype(Internal::template JsonStructBaseDummy<Owner, Owner>::js_static_meta_data_info());
+    using SuperMeta = decltype(Internal::template JsonStructBaseDummy<Owner, Owner>::js_static_meta_super_info());
+    SuperLookupBuilder<T, Owner, PAGE + Members::size, SuperMeta::size>::addMembers(table, primary);
+  }
+};
+
+template <typename T, typename Owner, size_t PAGE, size_t SIZE>
+struct SuperLookupBuilder
+{
+  static void addMembers(MemberLookupTable<T> &table, bool primary)
+  {
+    using SuperMeta = decltype(Internal::template JsonStructBaseDummy<Owner, Owner>::js_static_meta_super_info());
+    using Super = typename TypeAt<SIZE - 1, SuperMeta>::type::type;
+    using Members = decltype(Internal::template JsonStructBaseDummy<Super, Super>::js_static_meta_data_info());
+    MemberLookupBuilder<T, Super, PAGE, Members::size - 1>::addMembers(table, primary);
+    SuperLookupBuilder<T, Owner, PAGE + memberCount<Super, 0>(), SIZE - 1>::addMembers(table, primary);
+  }
+};
+
+template <typename T, typename Owner, size_t PAGE>
+struct SuperLookupBuilder<T, Owner, PAGE, 0>
+{
+  static void addMembers(MemberLookupTable<T> &table, bool primary)
+  {
+    JS_UNUSED(table);
+    JS_UNUSED(primary);
+  }
+};
+
+template <typename T>
+MemberLookupTable<T>::MemberLookupTable()
+{
+  using Members = decltype(Internal::template JsonStructBaseDummy<T, T>::js_static_meta_data_info());
+  MemberLookupBuilder<T, T, 0, Members::size - 1>::addMembers(*this, true);
+  ordered.resize(memberCount<T, 0>(), 0);
+  for (size_t i = 0; i < entries.size(); i++)
+    ordered[entries[i].index] = uint32_t(i + 1);
+  MemberLookupBuilder<T, T, 0, Members::size - 1>::addMembers(*this, false);
+
+  size_t table_size = 4;
+  while (table_size < entries.size() * 2)
+    table_size *= 2;
+  mask = table_size - 1;
+  table.resize(table_size, 0);
+  for (size_t i = 0; i < entries.size(); i++)
+  {
+    size_t slot = hashName(entries[i].name, entries[i].name_size) & mask;
+    while (table[slot])
+      slot = (slot + 1) & mask;
+    table[slot] = uint32_t(i + 1);
+  }
+}
+
 static bool skipArrayOrObject(ParseContext &context)
 {
   assert(context.error == Error::NoError);
@@ -3455,6 +5295,12 @@ static bool skipArrayOrObject(ParseContext &context)
     return false;
   }
 
+  if (context.fast_skip_missing_members && context.tokenizer.skipToContainerEnd())
+  {
+    context.nextToken();
+    return context.error == Error::NoError && context.token.value_type == end_type;
+  }
+
   int depth = 1;
   while (depth > 0)
   {
@@ -3480,8 +5326,6 @@ static bool skipArrayOrObject(ParseContext &context)
 template <typename T>
 JS_NODISCARD inline Error ParseContext::parseTo(T &to_type)
 {
-  missing_members.reserve(10);
-  unassigned_required_members.reserve(10);
   error = tokenizer.nextToken(token);
   if (error != JS::Error::NoError)
     return error;
@@ -3493,22 +5337,249 @@ JS_NODISCARD inline Error ParseContext::parseTo(T &to_type)
   return error;
 }
 
+/*!
+ * \brief ParseContext borrowed from a thread local pool.
+ *
+ * Hot loops that parse many small documents can use this instead of
+ * constructing a ParseContext per document. The context is reset to the new
+ * data, and handed back to the pool with its default configuration restored,
+ * keeping the allocated capacity for the next user on the same thread.
+ */
+class PooledParseContext
+{
+public:
+  PooledParseContext(const char *data, size_t size)
+    : context(acquire())
+  {
+    context->reset(data, size);
+  }
+  explicit PooledParseContext(const std::string &data)
+    : PooledParseContext(data.data(), data.size())
+  {
+  }
+  ~PooledParseContext()
+  {
+    std::vector<std::unique_ptr<ParseContext>> &contexts = pool();
+    if (contexts.size() < 8)
+    {
+      restoreDefaults(*context);
+      contexts.push_back(std::move(context));
+    }
+  }
+  PooledParseContext(const PooledParseContext &) = delete;
+  PooledParseContext &operator=(const PooledParseContext &) = delete;
+
+  ParseContext &operator*()
+  {
+    return *context;
+  }
+  ParseContext *operator->()
+  {
+    return context.get();
+  }
+
+  template <typename T>
+  JS_NODISCARD Error parseTo(T &to_type)
+  {
+    return context->parseTo(to_type);
+  }
+
+private:
+  static std::vector<std::unique_ptr<ParseContext>> &pool()
+  {
+    static thread_local std::vector<std::unique_ptr<ParseContext>> contexts;
+    return contexts;
+  }
+
+  static std::unique_ptr<ParseContext> acquire()
+  {
+    std::vector<std::unique_ptr<ParseContext>> &contexts = pool();
+    if (contexts.empty())
+      return std::unique_ptr<ParseContext>(new ParseContext());
+    std::unique_ptr<ParseContext> context = std::move(contexts.back());
+    contexts.pop_back();
+    return context;
+  }
+
+  static void restoreDefaults(ParseContext &context)
+  {
+    context.tokenizer.restoreDefaultOptions();
+    static_cast<ParseContextOptions &>(context) = ParseContextOptions();
+    context.member_prediction_hits = 0;
+    context.member_prediction_misses = 0;
+  }
+
+  std::unique_ptr<ParseContext> context;
+};
+
+/*!
+ * \brief Reads newline delimited JSON (NDJSON / JSON Lines) one value at a time.
+ *
+ * Every non empty line holds one JSON object or array. Each line is parsed with the
+ * same ParseContext, which is reset between lines, so an error on one line is
+ * reported for that line and parsing continues with the next one. Values
+ * referring into the input, like DataRef members, point into the buffer given
+ * to the reader.
+ *
+ * Input read in pieces, like from a socket or a pipe, is given with feed().
+ * The reader then keeps a copy of the lines that are not read yet, and a line
+ * split over several pieces is parsed once its newline has been fed. Values
+ * referring into the input are then only valid until the next feed().
+ */
+class JsonLinesReader
+{
+public:
+  JsonLinesReader() = default;
+  JsonLinesReader(const char *data, size_t size)
+  {
+    reset(data, size);
+  }
+  explicit JsonLinesReader(const std::string &data)
+    : JsonLinesReader(data.data(), data.size())
+  {
+  }
+  JsonLinesReader(const JsonLinesReader &) = delete;
+  JsonLinesReader &operator=(const JsonLinesReader &) = delete;
+
+  void reset(const char *data, size_t size)
+  {
+    m_buffer.clear();
+    m_data = data;
+    m_size = size;
+    m_position = 0;
+    m_line = 0;
+    m_next_line = 1;
+  }
+
+  /* Appends data to the input. Only complete lines are returned by next(),
+   * a trailing line without a newline is kept until more data is fed, or
+   * finish() is called. */
+  void feed(const char *data, size_t size)
+  {
+    bool fed = m_data == m_buffer.data();
+    size_t complete = fed ? m_size - m_position : 0;
+    m_buffer.erase(0, fed ? m_position : m_buffer.size());
+    m_buffer.append(data, size);
+    for (size_t i = size; i > 0; i--)
+    {
+      if (data[i - 1] == '\n')
+      {
+        complete = m_buffer.size() - size + i;
+        break;
+      }
+    }
+    m_data = m_buffer.data();
+    m_size = complete;
+    m_position = 0;
+  }
+
+  /* Marks the end of the fed input, so a trailing line without a newline is
+   * returned by next(). */
+  void finish()
+  {
+    if (m_data == m_buffer.data())
+      m_size = m_buffer.size();
+  }
+
+  /* Parses the value on the next non empty line into to_type. Returns false
+   * when there are no more lines, otherwise context.error holds the result
+   * for the line and line() its line number. */
+  template <typename T>
+  bool next(T &to_type);
+
+  bool atEnd() const
+  {
+    return m_position >= m_size;
+  }
+
+  /* The 1 based line number of the value last returned by next(). */
+  size_t line() const
+  {
+    return m_line;
+  }
+
+  ParseContext context;
+
+private:
+  std::string m_buffer;
+  const char *m_data = nullptr;
+  size_t m_size = 0;
+  size_t m_position = 0;
+  size_t m_line = 0;
+  size_t m_next_line = 1;
+};
+
+template <typename T>
+inline bool JsonLinesReader::next(T &to_type)
+{
+  while (m_position < m_size)
+  {
+    const char *begin = m_data + m_position;
+    const char *newline = static_cast<const char *>(memchr(begin, '\n', m_size - m_position));
+    size_t line_size = newline ? size_t(newline - begin) : m_size - m_position;
+    m_position += newline ? line_size + 1 : line_size;
+    m_line = m_next_line++;
+
+    size_t i = 0;
+    while (i < line_size && (begin[i] == ' ' || begin[i] == '\t' || begin[i] == '\r'))
+      i++;
+    if (i == line_size)
+      continue;
+
+    context.reset(begin, line_size);
+    if (context.parseTo(to_type) != Error::NoError)
+      return true;
+
+    const char *end = begin + line_size;
+    const char *rest = context.tokenizer.currentPosition();
+    while (rest && rest < end && (*rest == ' ' || *rest == '\t' || *rest == '\r'))
+      rest++;
+    if (rest && rest < end)
+    {
+      context.error = Error::InvalidToken;
+      context.tokenizer.updateErrorContext(context.error, "Expected one value per line");
+    }
+    return true;
+  }
+  return false;
+}
+
+/*!
+ * Parses every line of the newline delimited JSON in data into a new T and
+ * passes it to on_value(T &, size_t line). Lines that fail to parse are passed
+ * to on_error(const ParseContext &, size_t line) and parsing continues. Returns
+ * the number of values passed to on_value.
+ */
+template <typename T, typename OnValue, typename OnError>
+inline size_t parseJsonLines(const char *data, size_t size, OnValue &&on_value, OnError &&on_error)
+{
+  JsonLinesReader reader(data, size);
+  size_t values = 0;
+  while (!reader.atEnd())
+  {
+    T value;
+    if (!reader.next(value))
+      break;
+    if (reader.context.error == Error::NoError)
+    {
+      on_value(value, reader.line());
+      values++;
+    }
+    else
+    {
+      on_error(reader.context, reader.line());
+    }
+  }
+  return values;
+}
+
 struct SerializerContext
 {
   SerializerContext(std::string &json_out_p)
     : serializer()
-    , cb_ref(serializer.addRequestBufferCallback([this](Serializer &serializer_p) {
-      size_t end = this->json_out.size();
-      this->json_out.resize(end * 2);
-      serializer_p.setBuffer(&(this->json_out[0]) + end, end);
-      this->last_pos = end;
-    }))
     , json_out(json_out_p)
-    , last_pos(0)
   {
-    if (json_out.empty())
-      json_out.resize(4096);
-    serializer.setBuffer(&json_out[0], json_out.size());
+    serializer.useStringBuffer(json_out, 1024);
   }
 
   ~SerializerContext()
@@ -3526,36 +5597,35 @@ struct SerializerContext
 
   void flush()
   {
-    json_out.resize(last_pos + serializer.currentBuffer().used);
+    serializer.flushStringBuffer();
   }
 
   Serializer serializer;
-  BufferRequestCBRef cb_ref;
   std::string &json_out;
-  size_t last_pos;
 };
 
+/* The owned buffer grows with realloc, which neither zero fills nor, for
+ * large buffers, copies, so it is faster than serializing into the string even
+ * though the output is copied into it once. */
 template <typename T>
 JS_NODISCARD std::string serializeStruct(const T &from_type)
 {
-  std::string ret_string;
-  SerializerContext serializeContext(ret_string);
+  Serializer serializer;
+  serializer.useOwnedBuffer(1024);
   Token token;
-  TypeHandler<T>::from(from_type, token, serializeContext.serializer);
-  serializeContext.flush();
-  return ret_string;
+  TypeHandler<T>::from(from_type, token, serializer);
+  return std::string(serializer.currentBuffer().buffer, serializer.currentBuffer().used);
 }
 
 template <typename T>
 JS_NODISCARD std::string serializeStruct(const T &from_type, const SerializerOptions &options)
 {
-  std::string ret_string;
-  SerializerContext serializeContext(ret_string);
-  serializeContext.serializer.setOptions(options);
+  Serializer serializer;
+  serializer.setOptions(options);
+  serializer.useOwnedBuffer(1024);
   Token token;
-  TypeHandler<T>::from(from_type, token, serializeContext.serializer);
-  serializeContext.flush();
-  return ret_string;
+  TypeHandler<T>::from(from_type, token, serializer);
+  return std::string(serializer.currentBuffer().buffer, serializer.currentBuffer().used);
 }
 
 template <>
@@ -4572,8 +6642,14 @@ void populateEnumNames(std::vector<DataRef> &names, const char (&data)[N])
 
 namespace JS
 {
-template <typename T, typename Enable>
-inline Error TypeHandler<T, Enable>::to(T &to_type, ParseContext &context)
+namespace Internal
+{
+/* Walks the members of an object of type T. Every member found in the
+ * lookup table is handed to unpack(member, context), the others are recorded
+ * and skipped as configured in the context. Finally the required members are
+ * verified. */
+template <typename T, typename Unpack>
+inline Error unpackObjectMembers(ParseContext &context, Unpack unpack)
 {
   if (context.token.value_type != JS::Type::ObjectStart)
     return Error::ExpectedObjectStart;
@@ -4582,17 +6658,34 @@ inline Error TypeHandler<T, Enable>::to(T &to_type, ParseContext &context)
     return error;
   auto members = Internal::JsonStructBaseDummy<T, T>::js_static_meta_data_info();
   using MembersType = decltype(members);
+  const Internal::MemberLookupTable<T> &lookup = Internal::MemberLookupTable<T>::get();
   bool assigned_members[Internal::memberCount<T, 0>()];
   memset(assigned_members, 0, sizeof(assigned_members));
+  size_t predicted_member = 0;
   while (context.token.value_type != JS::Type::ObjectEnd)
 
   {
     DataRef token_name = context.token.name;
-    error = Internal::MemberChecker<T, MembersType, 0, MembersType::size - 1>::unpackMembers(to_type, members, context,
-                                                                                             true, assigned_members);
-    if (error == Error::MissingPropertyMember)
-      error = Internal::MemberChecker<T, MembersType, 0, MembersType::size - 1>::unpackMembers(
-        to_type, members, context, false, assigned_members);
+    const Internal::MemberLookupEntry<T> *member = lookup.predict(predicted_member, token_name);
+    if (member)
+    {
+      context.member_prediction_hits++;
+    }
+    else
+    {
+      context.member_prediction_misses++;
+      member = lookup.find(token_name);
+    }
+    if (member)
+    {
+      predicted_member = member->index + 1;
+      assigned_members[member->index] = true;
+      error = unpack(*member, context);
+    }
+    else
+    {
+      error = Error::MissingPropertyMember;
+    }
     if (error == Error::MissingPropertyMember)
     {
 
@@ -4631,6 +6724,16 @@ inline Error TypeHandler<T, Enable>::to(T &to_type, ParseContext &context)
   }
   return error;
 }
+} // namespace Internal
+
+template <typename T, typename Enable>
+inline Error TypeHandler<T, Enable>::to(T &to_type, ParseContext &context)
+{
+  return Internal::unpackObjectMembers<T>(
+    context, [&to_type](const Internal::MemberLookupEntry<T> &member, ParseContext &member_context) {
+      return member.unpack(to_type, member_context);
+    });
+}
 
 template <typename T, typename Enable>
 void TypeHandler<T, Enable>::from(const T &from_type, Token &token, Serializer &serializer)
@@ -4654,40 +6757,549 @@ void TypeHandler<T, Enable>::from(const T &from_type, Token &token, Serializer &
 
 namespace Internal
 {
-template <typename T, typename F>
-struct EnumHandler
+template <typename T>
+struct MakeVoid
 {
-  static inline Error to(T &to_type, ParseContext &context)
-  {
-    if (context.token.value_type == Type::String)
-    {
-      auto &strings = F::strings();
-      for (size_t i = 0; i < strings.size(); i++)
-      {
-        const DataRef &ref = strings[i];
-        if (ref.size == context.token.value.size)
-        {
-          if (memcmp(ref.data, context.token.value.data, ref.size) == 0)
-          {
-            to_type = static_cast<T>(i);
-            return Error::NoError;
-          }
-        }
-      }
-    }
-    else if (context.token.value_type == Type::Number)
-    {
-      using enum_int_t = typename std::underlying_type<T>::type;
-      enum_int_t tmp;
-      auto err = TypeHandler<enum_int_t>::to(tmp, context);
-      if (err != Error::NoError)
-        return err;
-      to_type = static_cast<T>(tmp);
-      return Error::NoError;
-    }
+  typedef void type;
+};
 
-    return Error::IllegalDataValue;
-  }
+template <typename T, typename Enable = void>
+struct IsObjectTypeHandler : std::false_type
+{
+};
+
+template <typename T>
+struct IsObjectTypeHandler<T, typename MakeVoid<typename TypeHandler<T>::js_object_handler>::type> : std::true_type
+{
+};
+
+template <typename Owner, size_t INDEX>
+Error validateMemberAt(ParseContext &context)
+{
+  using Members = decltype(Internal::template JsonStructBaseDummy<Owner, Owner>::js_static_meta_data_info());
+  using MI_T = typename TypeAt<INDEX, Members>::type::type;
+  return ValidateHandler<MI_T>::validate(context);
+}
+
+/* The validate function of every member of T, including the members of super
+ * classes, indexed like the entries in MemberLookupTable. */
+template <typename T>
+class MemberValidateTable
+{
+public:
+  static const MemberValidateTable &get()
+  {
+    static const MemberValidateTable table;
+    return table;
+  }
+
+  Error (*validate[memberCount<T, 0>() + 1])(ParseContext &context);
+
+private:
+  MemberValidateTable();
+};
+
+template <typename T, typename Owner, size_t PAGE, size_t SIZE>
+struct SuperValidateBuilder;
+
+template <typename T, typename Owner, size_t PAGE, size_t INDEX>
+struct MemberValidateBuilder
+{
+  static void addMembers(MemberValidateTable<T> &table)
+  {
+    table.validate[PAGE + INDEX] = &validateMemberAt<Owner, INDEX>;
+    MemberValidateBuilder<T, Owner, PAGE, INDEX - 1>::addMembers(table);
+  }
+};
+
+template <typename T, typename Owner, size_t PAGE>
+struct MemberValidateBuilder<T, Owner, PAGE, size_t(-1)>
+{
+  static void addMembers(MemberValidateTable<T> &table)
+  {
+    using Members = decltype(Internal::template JsonStructBaseDummy<Owner, Owner>::js_static_meta_data_info());
+    using SuperMeta = decltype(Internal::template JsonStructBaseDummy<Owner, Owner>::js_static_meta_super_info());
+    SuperValidateBuilder<T, Owner, PAGE + Members::size, SuperMeta::size>::addMembers(table);
+  }
+};
+
+template <typename T, typename Owner, size_t PAGE, size_t SIZE>
+struct SuperValidateBuilder
+{
+  static void addMembers(MemberValidateTable<T> &table)
+  {
+    using SuperMeta = decltype(Internal::template JsonStructBaseDummy<Owner, Owner>::js_static_meta_super_info());
+    using Super = typename TypeAt<SIZE - 1, SuperMeta>::type::type;
+    using Members = decltype(Internal::template JsonStructBaseDummy<Super, Super>::js_static_meta_data_info());
+    MemberValidateBuilder<T, Super, PAGE, Members::size - 1>::addMembers(table);
+    SuperValidateBuilder<T, Owner, PAGE + memberCount<Super, 0>(), SIZE - 1>::addMembers(table);
+  }
+};
+
+template <typename T, typename Owner, size_t PAGE>
+struct SuperValidateBuilder<T, Owner, PAGE, 0>
+{
+  static void addMembers(MemberValidateTable<T> &table)
+  {
+    JS_UNUSED(table);
+  }
+};
+
+template <typename T>
+MemberValidateTable<T>::MemberValidateTable()
+  : validate()
+{
+  using Members = decltype(Internal::template JsonStructBaseDummy<T, T>::js_static_meta_data_info());
+  MemberValidateBuilder<T, T, 0, Members::size - 1>::addMembers(*this);
+}
+
+template <typename T>
+inline Error validateValue(ParseContext &context, std::true_type)
+{
+  const MemberValidateTable<T> &table = MemberValidateTable<T>::get();
+  return unpackObjectMembers<T>(
+    context, [&table](const Internal::MemberLookupEntry<T> &member, ParseContext &member_context) {
+      return table.validate[member.index](member_context);
+    });
+}
+
+template <typename T>
+inline Error validateValue(ParseContext &context, std::false_type)
+{
+  T value{};
+  return TypeHandler<T>::to(value, context);
+}
+
+template <typename T>
+inline Error validateNullable(ParseContext &context)
+{
+  if (context.token.value_type == Type::Null)
+    return Error::NoError;
+  return ValidateHandler<T>::validate(context);
+}
+
+template <typename T, size_t N>
+inline Error validateFixedArray(ParseContext &context)
+{
+  if (context.token.value_type != Type::ArrayStart)
+    return JS::Error::ExpectedArrayStart;
+
+  context.nextToken();
+  for (size_t i = 0; i < N; i++)
+  {
+    if (context.error != JS::Error::NoError)
+      return context.error;
+    context.error = ValidateHandler<T>::validate(context);
+    if (context.error != JS::Error::NoError)
+      return context.error;
+
+    context.nextToken();
+  }
+
+  if (context.token.value_type != Type::ArrayEnd)
+    return JS::Error::ExpectedArrayEnd;
+  return context.error;
+}
+
+template <typename Value>
+struct ValidateHandlerMap
+{
+  static inline Error validate(ParseContext &context)
+  {
+    if (context.token.value_type != Type::ObjectStart)
+      return JS::Error::ExpectedObjectStart;
+
+    Error error = context.nextToken();
+    if (error != JS::Error::NoError)
+      return error;
+    while (context.token.value_type != Type::ObjectEnd)
+    {
+      error = ValidateHandler<Value>::validate(context);
+      if (error != JS::Error::NoError)
+        return error;
+      error = context.nextToken();
+    }
+    return error;
+  }
+};
+} // namespace Internal
+
+template <typename T, typename Enable>
+inline Error ValidateHandler<T, Enable>::validate(ParseContext &context)
+{
+  return Internal::validateValue<T>(context, Internal::IsObjectTypeHandler<T>());
+}
+
+/// \private
+template <typename Traits, typename Allocator>
+struct ValidateHandler<std::basic_string<char, Traits, Allocator>>
+{
+  static inline Error validate(ParseContext &context)
+  {
+    JS_UNUSED(context);
+    return Error::NoError;
+  }
+};
+
+/// \private
+template <typename T, typename Allocator>
+struct ValidateHandler<std::vector<T, Allocator>>
+{
+  static inline Error validate(ParseContext &context)
+  {
+    if (context.token.value_type != JS::Type::ArrayStart)
+      return Error::ExpectedArrayStart;
+    Error error = context.nextToken();
+    if (error != JS::Error::NoError)
+      return error;
+    while (context.token.value_type != JS::Type::ArrayEnd)
+    {
+      error = ValidateHandler<T>::validate(context);
+      if (error != JS::Error::NoError)
+        break;
+      error = context.nextToken();
+      if (error != JS::Error::NoError)
+        break;
+    }
+    return error;
+  }
+};
+
+/// \private
+template <typename T, size_t N>
+struct ValidateHandler<T[N]>
+{
+  static inline Error validate(ParseContext &context)
+  {
+    return Internal::validateFixedArray<T, N>(context);
+  }
+};
+
+/// \private
+template <typename T>
+struct ValidateHandler<Nullable<T>>
+{
+  static inline Error validate(ParseContext &context)
+  {
+    return Internal::validateNullable<T>(context);
+  }
+};
+
+/// \private
+template <typename T>
+struct ValidateHandler<NullableChecked<T>>
+{
+  static inline Error validate(ParseContext &context)
+  {
+    return Internal::validateNullable<T>(context);
+  }
+};
+
+/// \private
+template <typename T>
+struct ValidateHandler<Optional<T>>
+{
+  static inline Error validate(ParseContext &context)
+  {
+    return ValidateHandler<T>::validate(context);
+  }
+};
+
+/// \private
+template <typename T>
+struct ValidateHandler<OptionalChecked<T>>
+{
+  static inline Error validate(ParseContext &context)
+  {
+    return ValidateHandler<T>::validate(context);
+  }
+};
+
+#ifdef JS_STD_OPTIONAL
+/// \private
+template <typename T>
+struct ValidateHandler<std::optional<T>>
+{
+  static inline Error validate(ParseContext &context)
+  {
+    return ValidateHandler<T>::validate(context);
+  }
+};
+#endif
+
+/// \private
+template <typename T>
+struct ValidateHandler<std::unique_ptr<T>>
+{
+  static inline Error validate(ParseContext &context)
+  {
+    return Internal::validateNullable<T>(context);
+  }
+};
+
+/// \private
+template <typename T>
+struct ValidateHandler<std::shared_ptr<T>>
+{
+  static inline Error validate(ParseContext &context)
+  {
+    return Internal::validateNullable<T>(context);
+  }
+};
+
+#ifdef JS_STD_UNORDERED_MAP
+/// \private
+template <typename Key, typename Value, typename Hash, typename KeyEqual, typename Allocator>
+struct ValidateHandler<std::unordered_map<Key, Value, Hash, KeyEqual, Allocator>> : Internal::ValidateHandlerMap<Value>
+{
+};
+#endif
+
+/*!
+ * \brief Checks the current data of context against the schema of T.
+ *
+ * The tokens are type checked as parseTo would, and the errors, error context,
+ * missing and unassigned required members are reported the same way, but no T
+ * is created. Strings and containers are not copied, so a reused context
+ * validates JS_OBJ types of strings, numbers, enums and containers without
+ * allocating.
+ */
+template <typename T>
+JS_NODISCARD inline Error validate(ParseContext &context)
+{
+  context.error = context.tokenizer.nextToken(context.token);
+  if (context.error != JS::Error::NoError)
+    return context.error;
+  context.error = ValidateHandler<T>::validate(context);
+  if (context.error != JS::Error::NoError && context.tokenizer.errorContext().error == JS::Error::NoError)
+  {
+    context.tokenizer.updateErrorContext(context.error);
+  }
+  return context.error;
+}
+
+/*!
+ * \brief Checks that data is a valid T, using a context from the thread local
+ * pool.
+ */
+template <typename T>
+JS_NODISCARD inline Error validate(const char *data, size_t size)
+{
+  PooledParseContext context(data, size);
+  return validate<T>(*context);
+}
+
+#ifdef JS_PROJECTION
+/*!
+ * \brief A JS_OBJ type T where only the listed members are parsed.
+ *
+ * JS::Projection<Route, &Route::id, &Route::target> parses an object into
+ * value, but only decodes the id and target members. Every other member is
+ * skipped without invoking its TypeHandler and without being recorded as
+ * missing. Serializing a Projection writes only the listed members.
+ */
+template <typename T, auto... Members>
+struct Projection
+{
+  T value;
+};
+
+namespace Internal
+{
+template <typename T, auto Member, size_t INDEX>
+constexpr size_t projectedMemberIndex()
+{
+  using MembersType = decltype(JsonStructBaseDummy<T, T>::js_static_meta_data_info());
+  if constexpr (INDEX == MembersType::size)
+  {
+    return INDEX;
+  }
+  else
+  {
+    using Info = typename TypeAt<INDEX, MembersType>::type;
+    if constexpr (std::is_same<decltype(Info::member), decltype(Member)>::value)
+    {
+      if (JsonStructBaseDummy<T, T>::js_static_meta_data_info().template get<INDEX>().member == Member)
+        return INDEX;
+    }
+    return projectedMemberIndex<T, Member, INDEX + 1>();
+  }
+}
+
+template <typename T, auto Member>
+struct ProjectedMember
+{
+  using MembersType = decltype(JsonStructBaseDummy<T, T>::js_static_meta_data_info());
+  static constexpr size_t index = projectedMemberIndex<T, Member, 0>();
+  static_assert(index < MembersType::size, "A projected member has to be a member in the JS_OBJ of the type");
+  using Info = typename TypeAt<index, MembersType>::type;
+  using NameTuple = decltype(Info::names);
+
+  static bool matches(const DataRef &name)
+  {
+    const auto &names = JsonStructBaseDummy<T, T>::js_static_meta_data_info().template get<index>().names;
+    return compareDataRefWithStringLiteral(names.template get<0>(), name) ||
+           NameChecker<NameTuple, NameTuple::size>::compare(names, name);
+  }
+
+  static void serialize(const T &from_type, Token &token, Serializer &serializer)
+  {
+    serializeMember(from_type, JsonStructBaseDummy<T, T>::js_static_meta_data_info().template get<index>(), token,
+                    serializer, "", MemberKey<T, index>::key.data);
+  }
+};
+
+template <typename T, auto Member, auto... Rest>
+inline Error unpackProjectedMember(T &to_type, ParseContext &context, bool *seen, size_t &remaining)
+{
+  if (ProjectedMember<T, Member>::matches(context.token.name))
+  {
+    if (!*seen)
+    {
+      *seen = true;
+      remaining--;
+    }
+    using MemberType = typename ProjectedMember<T, Member>::Info::type;
+    return TypeHandler<MemberType>::to(to_type.*Member, context);
+  }
+  if constexpr (sizeof...(Rest) > 0)
+    return unpackProjectedMember<T, Rest...>(to_type, context, seen + 1, remaining);
+  else
+    return Error::MissingPropertyMember;
+}
+
+/* Like MemberChecker::verifyMembers, for the projected members only. */
+template <typename T, auto Member, auto... Rest>
+inline Error verifyProjectedMembers(const bool *seen, bool track_missing_members,
+                                    std::vector<std::string> &unassigned_required_members)
+{
+  bool assigned = *seen;
+  Error error = verifyMember(
+    JsonStructBaseDummy<T, T>::js_static_meta_data_info().template get<ProjectedMember<T, Member>::index>(), 0,
+    &assigned, track_missing_members, unassigned_required_members, "");
+  if constexpr (sizeof...(Rest) > 0)
+  {
+    Error rest_error = verifyProjectedMembers<T, Rest...>(seen + 1, track_missing_members, unassigned_required_members);
+    if (error == Error::NoError)
+      error = rest_error;
+  }
+  return error;
+}
+} // namespace Internal
+
+/// \private
+template <typename T, auto... Members>
+struct TypeHandler<Projection<T, Members...>>
+{
+  static inline Error to(Projection<T, Members...> &to_type, ParseContext &context)
+  {
+    if (context.token.value_type != JS::Type::ObjectStart)
+      return Error::ExpectedObjectStart;
+    Error error = context.nextToken();
+    if (error != JS::Error::NoError)
+      return error;
+    bool seen[sizeof...(Members)] = {};
+    size_t remaining = sizeof...(Members);
+    bool stop_early = context.stop_after_projected_members;
+    while (context.token.value_type != JS::Type::ObjectEnd)
+    {
+      error = Internal::unpackProjectedMember<T, Members...>(to_type.value, context, seen, remaining);
+      if (error == Error::MissingPropertyMember)
+      {
+        if (context.token.value_type == Type::ObjectStart || context.token.value_type == Type::ArrayStart)
+        {
+          Internal::skipArrayOrObject(context);
+          if (context.error != Error::NoError)
+            return context.error;
+        }
+      }
+      else if (error != Error::NoError)
+      {
+        return error;
+      }
+
+      if (remaining == 0 && stop_early)
+      {
+        // The rest of the object is skipped, so its end is the next token.
+        // When it does not end in the current buffer, a root object is left
+        // unread and a nested one is skipped token by token.
+        if (!context.tokenizer.skipToContainerEnd() && context.tokenizer.containerDepth() == 1)
+          return Error::NoError;
+        stop_early = false;
+      }
+      context.nextToken();
+      if (context.error != Error::NoError)
+        return context.error;
+    }
+    std::vector<std::string> unassigned_required_members;
+    error = Internal::verifyProjectedMembers<T, Members...>(seen, context.track_member_assignement_state,
+                                                            unassigned_required_members);
+    if (error == Error::UnassignedRequiredMember)
+    {
+      if (context.track_member_assignement_state)
+        context.unassigned_required_members.insert(context.unassigned_required_members.end(),
+                                                   unassigned_required_members.begin(),
+                                                   unassigned_required_members.end());
+      if (context.allow_unasigned_required_members)
+        error = Error::NoError;
+    }
+    return error;
+  }
+
+  static inline void from(const Projection<T, Members...> &from_type, Token &token, Serializer &serializer)
+  {
+    static const char objectStart[] = "{";
+    static const char objectEnd[] = "}";
+    token.value_type = Type::ObjectStart;
+    token.value = DataRef(objectStart);
+    serializer.write(token);
+    (Internal::ProjectedMember<T, Members>::serialize(from_type.value, token, serializer), ...);
+    token.name.size = 0;
+    token.name.data = "";
+    token.name_type = Type::String;
+    token.value_type = Type::ObjectEnd;
+    token.value = DataRef(objectEnd);
+    serializer.write(token);
+  }
+};
+#endif
+
+namespace Internal
+{
+template <typename T, typename F>
+struct EnumHandler
+{
+  static inline Error to(T &to_type, ParseContext &context)
+  {
+    if (context.token.value_type == Type::String)
+    {
+      auto &strings = F::strings();
+      for (size_t i = 0; i < strings.size(); i++)
+      {
+        const DataRef &ref = strings[i];
+        if (ref.size == context.token.value.size)
+        {
+          if (memcmp(ref.data, context.token.value.data, ref.size) == 0)
+          {
+            to_type = static_cast<T>(i);
+            return Error::NoError;
+          }
+        }
+      }
+    }
+    else if (context.token.value_type == Type::Number)
+    {
+      using enum_int_t = typename std::underlying_type<T>::type;
+      enum_int_t tmp;
+      auto err = TypeHandler<enum_int_t>::to(tmp, context);
+      if (err != Error::NoError)
+        return err;
+      to_type = static_cast<T>(tmp);
+      return Error::NoError;
+    }
+
+    return Error::IllegalDataValue;
+  }
 
   static inline void from(const T &from_type, Token &token, Serializer &serializer)
   {
@@ -4701,7 +7313,8 @@ struct EnumHandler
 
 namespace Internal
 {
-static void push_back_escape(char current_char, std::string &to_type)
+template <typename String>
+static void push_back_escape(char current_char, String &to_type)
 {
   static const char escaped_table[] = {'b', 'f', 'n', 'r', 't', '\"', '\\', '/'};
   static const char replace_table[] = {'\b', '\f', '\n', '\r', '\t', '\"', '\\', '/'};
@@ -4718,145 +7331,182 @@ static void push_back_escape(char current_char, std::string &to_type)
   }
 }
 
-static void handle_json_escapes_in(const DataRef &ref, std::string &to_type)
+static inline bool parse_hex4(const char *data, uint32_t &code)
+{
+  code = 0;
+  for (int k = 0; k < 4; k++)
+  {
+    const char d = data[k];
+    uint32_t value;
+    if (d >= '0' && d <= '9')
+      value = uint32_t(d - '0');
+    else if (d >= 'A' && d <= 'F')
+      value = uint32_t(d - 'A') + 10;
+    else if (d >= 'a' && d <= 'f')
+      value = uint32_t(d - 'a') + 10;
+    else
+      return false;
+    code = (code << 4) | value;
+  }
+  return true;
+}
+
+// UTF-8 bit patterns according to https://en.wikipedia.org/wiki/UTF-8
+template <typename String>
+static void push_back_utf8(uint32_t code, String &to_type)
+{
+  if (code < 0x80)
+  {
+    to_type.push_back(char(code));
+  }
+  else if (code < 0x800)
+  {
+    to_type.push_back(char(0xc0 | (code >> 6)));
+    to_type.push_back(char(0x80 | (code & 0x3f)));
+  }
+  else if (code < 0x10000)
+  {
+    to_type.push_back(char(0xe0 | (code >> 12)));
+    to_type.push_back(char(0x80 | ((code >> 6) & 0x3f)));
+    to_type.push_back(char(0x80 | (code & 0x3f)));
+  }
+  else
+  {
+    to_type.push_back(char(0xf0 | (code >> 18)));
+    to_type.push_back(char(0x80 | ((code >> 12) & 0x3f)));
+    to_type.push_back(char(0x80 | ((code >> 6) & 0x3f)));
+    to_type.push_back(char(0x80 | (code & 0x3f)));
+  }
+}
+
+template <typename String>
+static void handle_json_escapes_in(const DataRef &ref, String &to_type)
 {
   to_type.reserve(ref.size);
   const char *it = ref.data;
-  size_t size = ref.size;
-  while (size)
+  const char *end = ref.data + ref.size;
+  while (it < end)
   {
-    const char *next_it = static_cast<const char *>(memchr(it, '\\', size));
+    const char *next_it = static_cast<const char *>(memchr(it, '\\', size_t(end - it)));
     if (!next_it)
     {
-      to_type.insert(to_type.end(), it, it + size);
+      to_type.insert(to_type.end(), it, end);
       break;
     }
     to_type.insert(to_type.end(), it, next_it);
-    size -= next_it - it;
-    if (!size)
+    if (end - next_it < 2)
     {
+      to_type.push_back('\\');
       break;
     }
-    size -= 2;
     const char current_char = *(next_it + 1);
+    it = next_it + 2;
     // we assume utf-8 encoding when this notation is used and parsing into std::string
-    if (current_char == 'u') // hexadecimal escaped unicode character
-    {
-      // first convert hex ascii digits to values between 0 and 15, then create
-      // UTF-8 bit patterns according to https://en.wikipedia.org/wiki/UTF-8
-      bool ok = (size >= 4);
-      unsigned char hex[4];
-      for (int k = 0; ok && k < 4; k++)
+    uint32_t code;
+    if (current_char == 'u' && end - it >= 4 && parse_hex4(it, code))
+    {
+      it += 4;
+      // A high surrogate followed by an escaped low surrogate is one code point.
+      // Unpaired surrogates can not be encoded as UTF-8 and become U+FFFD.
+      uint32_t low;
+      if (code >= 0xd800 && code < 0xdc00 && end - it >= 6 && it[0] == '\\' && it[1] == 'u' &&
+          parse_hex4(it + 2, low) && low >= 0xdc00 && low < 0xe000)
       {
-        const char d = *(next_it + k + 2);
-        if (d >= '0' && d <= '9')
-          hex[k] = (d - '0');
-        else if (d >= 'A' && d <= 'F')
-          hex[k] = (d - 'A') + 10;
-        else if (d >= 'a' && d <= 'f')
-          hex[k] = (d - 'a') + 10;
-        else
-          ok = false; // stop parsing and revert to fallback
+        code = 0x10000 + ((code - 0xd800) << 10) + (low - 0xdc00);
+        it += 6;
       }
-      if (ok)
+      else if (code >= 0xd800 && code < 0xe000)
       {
-        if (hex[0] || hex[1] & 0x08)
-        {
-          // code points: 0x0800 .. 0xffff
-          to_type.push_back(0xd0 | hex[0]);
-          to_type.push_back(0x80 | (hex[1] << 2) | ((hex[2] & 0x0c) >> 2));
-          to_type.push_back(0x80 | ((hex[2] & 0x03) << 4) | hex[3]);
-        }
-        else if (hex[1] || hex[2] & 0x08)
-        {
-          // code points: 0x0080 .. 0x07ff
-          to_type.push_back(0xc0 | (hex[1] << 2) | ((hex[2] & 0x0c) >> 2));
-          to_type.push_back(0x80 | ((hex[2] & 0x03) << 4) | hex[3]);
-        }
-        else
-        {
-          // code points: 0x0000 .. 0x007f
-          to_type.push_back((hex[2] << 4) | hex[3]);
-        }
-        it = next_it + 6; // advance past hex digits
-        size -= 4;
-      }
-      else
-      {
-        // fallback is to simply push characters as is
-        to_type.push_back('\\');
-        to_type.push_back(current_char);
-        it = next_it + 2;
+        code = 0xfffd;
       }
+      push_back_utf8(code, to_type);
+    }
+    else if (current_char == 'u')
+    {
+      // fallback is to simply push characters as is
+      to_type.push_back('\\');
+      to_type.push_back(current_char);
     }
     else
     {
       push_back_escape(current_char, to_type);
-      it = next_it + 2;
     }
-    if (!size)
-      break;
   }
 }
 
-static DataRef handle_json_escapes_out(const std::string &data, std::string &buffer)
+static inline DataRef handle_json_escapes_out(const DataRef &data, std::string &buffer)
 {
-  int start_index = 0;
-  for (size_t i = 0; i < data.size(); i++)
+  size_t start = 0;
+  size_t pos = findEscapeOut(data.data, 0, data.size);
+  if (pos == data.size)
+    return data;
+  buffer.reserve(data.size + 10);
+  while (pos < data.size)
   {
-    const char cur = data[i];
-    if (static_cast<uint8_t>(cur) <= uint8_t('\r') || cur == '\"' || cur == '\\')
-    {
-      if (buffer.empty())
-      {
-        buffer.reserve(data.size() + 10);
-      }
-      size_t diff = i - start_index;
-      if (diff > 0)
-      {
-        buffer.insert(buffer.end(), data.data() + start_index, data.data() + start_index + diff);
-      }
-      start_index = int(i) + 1;
+    buffer.append(data.data + start, pos - start);
+    const char *escaped = escapeSequenceOut(data.data[pos]);
+    if (escaped)
+      buffer.append(escaped, 2);
+    else
+      buffer.push_back(data.data[pos]);
+    start = pos + 1;
+    pos = findEscapeOut(data.data, start, data.size);
+  }
+  buffer.append(data.data + start, data.size - start);
+  return DataRef(buffer.data(), buffer.size());
+}
 
-      switch (cur)
-      {
-      case '\b':
-        buffer += std::string("\\b");
-        break;
-      case '\t':
-        buffer += std::string("\\t");
-        break;
-      case '\n':
-        buffer += std::string("\\n");
-        break;
-      case '\f':
-        buffer += std::string("\\f");
-        break;
-      case '\r':
-        buffer += std::string("\\r");
-        break;
-      case '\"':
-        buffer += std::string("\\\"");
-        break;
-      case '\\':
-        buffer += std::string("\\\\");
-        break;
-      default:
-        buffer.push_back(cur);
-        break;
-      }
-    }
+static inline DataRef handle_json_escapes_out(const std::string &data, std::string &buffer)
+{
+  return handle_json_escapes_out(DataRef(data.data(), data.size()), buffer);
+}
+
+/// \private
+struct FixedStringWriter
+{
+  char *data;
+  size_t size;
+
+  void reserve(size_t)
+  {
+  }
+  char *end()
+  {
+    return data + size;
   }
-  if (buffer.size())
+  void push_back(char c)
   {
-    size_t diff = data.size() - start_index;
-    if (diff > 0)
-    {
-      buffer.insert(buffer.end(), data.data() + start_index, data.data() + start_index + diff);
-    }
-    return DataRef(buffer.data(), buffer.size());
+    data[size++] = c;
+  }
+  void insert(char *, const char *begin, const char *end)
+  {
+    memcpy(data + size, begin, size_t(end - begin));
+    size += size_t(end - begin);
+  }
+};
+
+/* Points the reference straight into the input when the value has no escapes
+ * and is not split between two buffers. Otherwise the unescaped value is
+ * written into the arena of the context, which can never require more space
+ * than the escaped value. */
+static inline Error bind_string_ref(ParseContext &context, DataRef &ref)
+{
+  const DataRef &value = context.token.value;
+  bool escaped = context.token.value_type == Type::String && value.size && memchr(value.data, '\\', value.size);
+  if (!escaped && !context.tokenizer.isIntermediateValue(context.token))
+  {
+    ref = value;
+    return Error::NoError;
   }
-  return DataRef(data.data(), data.size());
+  if (!context.arena)
+    return Error::NonContigiousMemory;
+  FixedStringWriter writer = {static_cast<char *>(context.arena->allocate(value.size + 1, 1)), 0};
+  if (escaped)
+    handle_json_escapes_in(value, writer);
+  else
+    writer.insert(writer.end(), value.data, value.data + value.size);
+  ref = DataRef(writer.data, writer.size);
+  return Error::NoError;
 }
 } // namespace Internal
 /// \private
@@ -4872,14 +7522,71 @@ struct TypeHandler<std::string>
 
   static inline void from(const std::string &str, Token &token, Serializer &serializer)
   {
-    std::string buffer;
-    DataRef ref = Internal::handle_json_escapes_out(str, buffer);
     token.value_type = Type::String;
-    token.value.data = ref.data;
-    token.value.size = ref.size;
-    serializer.write(token);
+    token.value.data = str.data();
+    token.value.size = str.size();
+    serializer.writeEscaped(token);
+  }
+};
+
+/// \private
+template <typename Traits, typename Allocator>
+struct TypeHandler<std::basic_string<char, Traits, Allocator>>
+{
+  static inline Error to(std::basic_string<char, Traits, Allocator> &to_type, ParseContext &context)
+  {
+    to_type.clear();
+    Internal::ContextAllocator<Allocator>::bind(to_type, context);
+    Internal::handle_json_escapes_in(context.token.value, to_type);
+    return Error::NoError;
+  }
+
+  static inline void from(const std::basic_string<char, Traits, Allocator> &str, Token &token, Serializer &serializer)
+  {
+    token.value_type = Type::String;
+    token.value.data = str.data();
+    token.value.size = str.size();
+    serializer.writeEscaped(token);
+  }
+};
+
+/// \private
+template <>
+struct TypeHandler<DataRef>
+{
+  static inline Error to(DataRef &to_type, ParseContext &context)
+  {
+    return Internal::bind_string_ref(context, to_type);
+  }
+
+  static inline void from(const DataRef &str, Token &token, Serializer &serializer)
+  {
+    token.value_type = Type::String;
+    token.value = str;
+    serializer.writeEscaped(token);
+  }
+};
+
+#ifdef JS_STD_STRING_VIEW
+/// \private
+template <>
+struct TypeHandler<std::string_view>
+{
+  static inline Error to(std::string_view &to_type, ParseContext &context)
+  {
+    DataRef ref;
+    Error error = Internal::bind_string_ref(context, ref);
+    if (error == Error::NoError)
+      to_type = std::string_view(ref.data, ref.size);
+    return error;
+  }
+
+  static inline void from(const std::string_view &str, Token &token, Serializer &serializer)
+  {
+    TypeHandler<DataRef>::from(DataRef(str.data(), str.size()), token, serializer);
   }
 };
+#endif
 
 namespace Internal
 {
@@ -4901,6 +7608,7 @@ template <typename T>
 struct parsed_string : float_base10<T>
 {
   const char *endptr;
+  bool truncated;
 };
 
 enum class parse_string_error
@@ -4909,7 +7617,8 @@ enum class parse_string_error
   invalid_format,
   multiple_commas,
   empty_string,
-  illegal_exponent_value
+  illegal_exponent_value,
+  out_of_range
 };
 
 constexpr static inline uint64_t high(uint64_t x)
@@ -4921,101 +7630,11 @@ constexpr static inline uint64_t low(uint64_t x)
   return x & ~uint32_t(0);
 }
 
-template <int shift = 1>
-inline void left_shift(uint64_t (&a)[2])
-{
-  static_assert(shift < sizeof(*a) * 8,
-                "This functions does only support shifting by sizes smaller than sizeof(*a) * 8");
-  a[1] = a[1] << shift | (a[0] >> (int(sizeof(uint64_t) * 8) - shift));
-  a[0] = a[0] << shift;
-}
-
-template <int shift = 1>
-inline void left_shift(uint64_t &a)
-{
-  static_assert(shift < sizeof(a) * 8,
-                "This functions does only support shifting by sizes smaller than sizeof(*a) * 8");
-  a = a << shift;
-}
-
-inline void left_shift(uint64_t (&a)[2], int shift)
-{
-  if (shift > int(sizeof(*a)) * 8)
-  {
-    auto shift_0 = (int(sizeof(uint64_t) * 8) - shift);
-    if (shift_0 > 0)
-      a[1] = a[0] >> shift_0;
-    else
-      a[1] = a[0] << -shift_0;
-
-    a[0] = 0;
-  }
-  else
-  {
-    a[1] = a[1] << shift | (a[0] >> (int(sizeof(uint64_t) * 8) - shift));
-    a[0] = a[0] << shift;
-  }
-}
-
-inline void left_shift(uint64_t &a, int shift)
-{
-  a = a << shift;
-}
-
-inline void right_shift(uint64_t (&a)[2])
-{
-  a[0] = a[0] >> 1 | (a[1] << ((sizeof(uint64_t) * 8) - 1));
-  a[1] = a[1] >> 1;
-}
-
-inline void right_shift(uint64_t &a)
-{
-  a = a >> 1;
-}
-
 inline uint64_t mask32(uint64_t a)
 {
   return a & ((uint64_t(1) << 32) - 1);
 }
 
-inline void add(const uint64_t (&a)[2], uint64_t (&b)[2])
-{
-  uint64_t tmplow[2];
-  uint64_t tmphigh[2];
-  tmplow[0] = low(a[0]) + low(b[0]);
-  tmplow[1] = low(a[1]) + low(b[1]);
-  tmphigh[0] = high(a[0]) + high(b[0]);
-  tmphigh[1] = high(a[1]) + high(b[1]);
-
-  tmphigh[0] += tmplow[0] >> 32;
-  tmplow[1] += tmphigh[0] >> 32;
-  tmphigh[1] += tmplow[1] >> 32;
-
-  b[0] = mask32(tmplow[0]) | (tmphigh[0] << 32);
-  b[1] = mask32(tmplow[1]) | (tmphigh[1] << 32);
-}
-
-inline void add(const uint64_t &a, uint64_t &b)
-{
-  b += a;
-}
-
-inline void divide_by_10(uint64_t (&a)[2])
-{
-  uint64_t remainder = a[1] % 10;
-  a[1] /= 10;
-  uint64_t high_pluss_reminder = high(a[0]) + (remainder << 32);
-  uint64_t high_d = high_pluss_reminder / 10;
-  uint64_t high_r = high_pluss_reminder % 10;
-  uint64_t low_d = (low(a[0]) + (high_r << 32)) / 10;
-  a[0] = high_d << 32 | low_d;
-}
-
-inline void divide_by_10(uint64_t &a)
-{
-  a /= 10;
-}
-
 template <typename T>
 struct float_info
 {
@@ -5072,90 +7691,31 @@ struct float_info<double>
   {
     return 54;
   } // floor(log_2(1 << (mentissawidth + 2)))
-
-  using str_to_float_conversion_type = uint64_t[2];
-  using uint_alias = uint64_t;
-  static inline constexpr int str_to_float_binary_exponent_init() noexcept
-  {
-    return 64 + 60;
-  }
-  static inline constexpr uint64_t str_to_float_mask() noexcept
-  {
-    return ~((uint64_t(1) << 60) - 1);
-  }
-  static inline constexpr uint64_t str_to_float_top_bit_in_mask() noexcept
+  static inline constexpr int smallest_power_of_ten() noexcept
   {
-    return uint64_t(1) << 63;
-  }
-  static inline constexpr int str_to_float_expanded_length() noexcept
-  {
-    return 19;
-  }
-  static inline constexpr bool conversion_type_has_mask(const str_to_float_conversion_type &a) noexcept
-  {
-    return a[1] & str_to_float_mask();
-  }
-  static inline constexpr bool conversion_type_has_top_bit_in_mask(const str_to_float_conversion_type &a) noexcept
+    return -342;
+  } // any significand times 10^q rounds to zero below this
+  static inline constexpr int largest_power_of_ten() noexcept
   {
-    return a[1] & str_to_float_top_bit_in_mask();
+    return 308;
   }
-  static inline constexpr bool conversion_type_is_null(const str_to_float_conversion_type &a) noexcept
+  static inline constexpr int min_exponent_round_to_even() noexcept
   {
-    return !a[0] && !a[1];
+    return -4;
   }
-  static inline int shift_left_msb_to_index(str_to_float_conversion_type &a, int index)
+  static inline constexpr int max_exponent_round_to_even() noexcept
   {
-    if (a[1])
-    {
-      int msb = bit_scan_reverse(a[1]);
-      int shift_count = index - (msb + 64);
-      if (shift_count < 0)
-        return 0;
-      left_shift(a, shift_count);
-      return shift_count;
-    }
-    else if (a[0])
-    {
-      int msb = bit_scan_reverse(a[0]);
-      int shift_count = index - msb;
-      if (shift_count < 0)
-        return 0;
-      left_shift(a, shift_count);
-      return shift_count;
-    }
-    return 0;
+    return 23;
   }
-  static inline void copy_denormal_to_type(const str_to_float_conversion_type &a, int binary_exponent, bool negative,
-                                           double &to_digit)
+  static inline constexpr int max_exact_power_of_ten() noexcept
   {
-    uint64_t q = a[1];
-    int expo_shift = -binary_exponent + 9;
-    if (expo_shift)
-    {
-      q += uint64_t(1) << (expo_shift - 1);
-      q >>= expo_shift;
-    }
-    if (negative)
-      q |= uint64_t(1) << 63;
-    memcpy(&to_digit, &q, sizeof(q));
-  }
+    return 22;
+  } // largest power of ten that is exactly representable
 
-  static inline void copy_normal_to_type(const str_to_float_conversion_type &a, int binary_exponent, bool negative,
-                                         double &to_digit)
+  using uint_alias = uint64_t;
+  static inline constexpr int str_to_float_expanded_length() noexcept
   {
-    uint64_t q = a[1] & ~str_to_float_mask();
-    uint64_t to_round_off = (q & ((uint64_t(1) << 8) - 1));
-    bool bigger = to_round_off > (uint64_t(1) << (8 - 1)) || (to_round_off == (uint64_t(1) << (8 - 1)) && a[0]);
-    bool tie_odd = (!(q & ((uint64_t(1) << 7) - 1))) && (q & (uint64_t(1) << 8)) && !a[0];
-    if (bigger || tie_odd)
-    {
-      q += uint64_t(1) << (8 - 1);
-    }
-    q >>= 8;
-    q += uint64_t(binary_exponent) << mentissa_width();
-    if (negative)
-      q |= uint64_t(1) << 63;
-    memcpy(&to_digit, &q, sizeof(q));
+    return 19;
   }
 };
 
@@ -5170,18 +7730,6 @@ inline void get_parts(T f, bool &negative, int &exp, uint64_t &mentissa)
   negative = bits >> ((sizeof(f) * 8) - 1);
 }
 
-template <typename T>
-inline void assign_significand_to_float_conversion_type(const float_base10<T> &significand, uint64_t (&a)[2])
-{
-  a[0] = significand.significand;
-  a[1] = 0;
-}
-
-inline void copy_conversion_type(const uint64_t (&a)[2], uint64_t (&b)[2])
-{
-  memcpy(&b, &a, sizeof(b));
-}
-
 template <>
 struct float_info<float>
 {
@@ -5213,81 +7761,31 @@ struct float_info<float>
   {
     return 25;
   } // floor(log_2(1 << (mentissawidth + 2)))
-
-  using str_to_float_conversion_type = uint64_t;
-  using uint_alias = uint32_t;
-  static inline constexpr int str_to_float_binary_exponent_init() noexcept
+  static inline constexpr int smallest_power_of_ten() noexcept
   {
-    return 60;
-  }
-  static inline constexpr uint64_t str_to_float_mask() noexcept
+    return -65;
+  } // any significand times 10^q rounds to zero below this
+  static inline constexpr int largest_power_of_ten() noexcept
   {
-    return ~((uint64_t(1) << 60) - 1);
+    return 38;
   }
-  static inline constexpr uint64_t str_to_float_top_bit_in_mask() noexcept
+  static inline constexpr int min_exponent_round_to_even() noexcept
   {
-    return uint64_t(1) << 63;
+    return -17;
   }
-  static inline constexpr int str_to_float_expanded_length() noexcept
+  static inline constexpr int max_exponent_round_to_even() noexcept
   {
     return 10;
   }
-  static inline constexpr bool conversion_type_has_mask(const str_to_float_conversion_type &a) noexcept
-  {
-    return a & str_to_float_mask();
-  }
-  static inline constexpr bool conversion_type_has_top_bit_in_mask(const str_to_float_conversion_type &a) noexcept
-  {
-    return a & str_to_float_top_bit_in_mask();
-  }
-  static inline constexpr bool conversion_type_is_null(const str_to_float_conversion_type &a) noexcept
-  {
-    return !a;
-  }
-  static inline int shift_left_msb_to_index(str_to_float_conversion_type &a, int index)
+  static inline constexpr int max_exact_power_of_ten() noexcept
   {
-    if (a)
-    {
-      int msb = bit_scan_reverse(a);
-      int shift_count = index - msb;
-      if (shift_count < 0)
-        return 0;
-      left_shift(a, shift_count);
-      return shift_count;
-    }
-    return 0;
-  }
-  static inline void copy_denormal_to_type(const str_to_float_conversion_type &a, int binary_exponent, bool negative,
-                                           float &to_digit)
-  {
-    uint64_t q = a;
-    int expo_shift = -binary_exponent + 38;
-    if (expo_shift)
-    {
-      q += uint64_t(1) << (expo_shift - 1);
-      q >>= expo_shift;
-    }
-    if (negative)
-      q |= uint64_t(1) << 31;
-    uint32_t to_copy = uint32_t(q);
-    memcpy(&to_digit, &to_copy, sizeof(to_copy));
-  }
-  static inline void copy_normal_to_type(const str_to_float_conversion_type &a, int binary_exponent, bool negative,
-                                         float &to_digit)
+    return 10;
+  } // largest power of ten that is exactly representable
+
+  using uint_alias = uint32_t;
+  static inline constexpr int str_to_float_expanded_length() noexcept
   {
-    uint64_t q = a & ~str_to_float_mask();
-    bool bigger = (q & ((uint64_t(1) << 37) - 1)) > (uint64_t(1) << (37 - 1));
-    bool tie_odd = (!(q & ((uint64_t(1) << 36) - 1))) && (q & (uint64_t(1) << 37));
-    if (bigger || tie_odd)
-    {
-      q += (uint64_t(1) << (37 - 1));
-    }
-    q >>= 37;
-    q += uint64_t(binary_exponent) << mentissa_width();
-    if (negative)
-      q |= uint64_t(1) << 31;
-    uint32_t to_copy = uint32_t(q);
-    memcpy(&to_digit, &to_copy, sizeof(to_digit));
+    return 10;
   }
 };
 
@@ -5374,17 +7872,6 @@ I find_if(I first, I last, P p)
   return last;
 }
 
-template <typename T>
-inline void assign_significand_to_float_conversion_type(const float_base10<T> &significand, uint64_t &a)
-{
-  a = significand.significand;
-}
-
-inline void copy_conversion_type(const uint64_t &a, uint64_t &b)
-{
-  b = a;
-}
-
 template <typename T, int COUNT, T SUM>
 struct Pow10
 {
@@ -6690,13 +9177,18 @@ inline bool is_space(char a)
   return false;
 }
 
+/* Splits a number into sign, significand and base 10 exponent. Leading
+ * zeros are not counted as significand digits. Unless NoDigitCount is set
+ * only the first 19 significant digits are kept, which always fit in a
+ * uint64_t, and truncated is set if any of the dropped digits is non zero. */
 template <typename T, bool NoDigitCount>
 inline parse_string_error parseNumber(const char *number, size_t size, parsed_string<T> &parsedString)
 {
   const char *current;
   set_end_ptr<T> setendptr(parsedString, current);
-  int desimal_position = -1;
-  bool increase_significand = true;
+  bool seen_decimal_point = false;
+  bool keep_all_digits = NoDigitCount; // Not a constant condition for MSVC
+  int exponent_adjust = 0;
 
   parsedString.negative = false;
   parsedString.inf = 0;
@@ -6704,6 +9196,7 @@ inline parse_string_error parseNumber(const char *number, size_t size, parsed_st
   parsedString.significand_digit_count = 0;
   parsedString.significand = 0;
   parsedString.exp = 0;
+  parsedString.truncated = false;
 
   const char *number_end = number + size;
   current = find_if(number, number_end, [](const char a) { return !is_space(a); });
@@ -6716,52 +9209,41 @@ inline parse_string_error parseNumber(const char *number, size_t size, parsed_st
     parsedString.negative = true;
     current++;
   }
-  while (current < number_end)
+  for (; current < number_end; current++)
   {
-    if ((*current < '0' || *current > '9') && *current != '.')
-      break;
-
     if (*current == '.')
     {
-      if (desimal_position >= 0)
+      if (seen_decimal_point)
         return parse_string_error::multiple_commas;
-      desimal_position = parsedString.significand_digit_count;
+      seen_decimal_point = true;
+      continue;
+    }
+    if (*current < '0' || *current > '9')
+      break;
+
+    if (parsedString.significand == 0 && *current == '0')
+    {
+      if (seen_decimal_point)
+        exponent_adjust--;
+    }
+    else if (keep_all_digits || parsedString.significand_digit_count < 19)
+    {
+      parsedString.significand = parsedString.significand * T(10) + T(int(*current) - '0');
+      parsedString.significand_digit_count++;
+      if (seen_decimal_point)
+        exponent_adjust--;
     }
     else
     {
-#ifdef _MSC_VER
-      bool localDigitCount = NoDigitCount;
-      if (localDigitCount || parsedString.significand_digit_count < 19)
-#else
-      if (NoDigitCount || parsedString.significand_digit_count < 19)
-#endif
-      {
-        parsedString.significand = parsedString.significand * T(10) + T(int(*current) - '0');
-        parsedString.significand_digit_count++;
-      }
-      else if (increase_significand && parsedString.significand_digit_count < 20)
-      {
-        increase_significand = false;
-        uint64_t digit = uint64_t(*current) - '0';
-        static_assert(NoDigitCount || std::is_same<T, uint64_t>::value,
-                      "When NoDigitCount is used the significand type has to be uint64_t");
-        auto biggest_multiplier = (std::numeric_limits<uint64_t>::max() - digit) / parsedString.significand;
-
-        if (biggest_multiplier >= 10)
-        {
-          parsedString.significand = parsedString.significand * T(10) + T(digit);
-          parsedString.significand_digit_count++;
-        }
-      }
+      if (*current != '0')
+        parsedString.truncated = true;
+      if (!seen_decimal_point)
+        exponent_adjust++;
     }
-    current++;
   }
-  if (*current != 'e' && *current != 'E')
+  if (current == number_end || (*current != 'e' && *current != 'E'))
   {
-    if (desimal_position >= 0)
-      parsedString.exp = desimal_position - parsedString.significand_digit_count;
-    else
-      parsedString.exp = 0;
+    parsedString.exp = exponent_adjust;
     return parse_string_error::ok;
   }
   current++;
@@ -6790,7 +9272,8 @@ inline parse_string_error parseNumber(const char *number, size_t size, parsed_st
     if ((*current < '0' || *current > '9'))
       break;
     exponent_assigned = true;
-    exponent = exponent * 10 + (*current - '0');
+    if (exponent < 100000)
+      exponent = exponent * 10 + (*current - '0');
     current++;
   }
   if (!exponent_assigned)
@@ -6801,110 +9284,973 @@ inline parse_string_error parseNumber(const char *number, size_t size, parsed_st
   if (exponent_nagative)
     exponent = -exponent;
 
-  if (desimal_position >= 0)
-    parsedString.exp = desimal_position - parsedString.significand_digit_count + exponent;
-  else
-    parsedString.exp = exponent;
+  parsedString.exp = exponent_adjust + exponent;
   return parse_string_error::ok;
 }
 
-inline uint64_t getPow10(uint32_t pow)
-{
-  static uint64_t data[] = {UINT64_C(1),
-                            UINT64_C(10),
-                            UINT64_C(100),
-                            UINT64_C(1000),
-                            UINT64_C(10000),
-                            UINT64_C(100000),
-                            UINT64_C(1000000),
-                            UINT64_C(10000000),
-                            UINT64_C(100000000),
-                            UINT64_C(1000000000),
-                            UINT64_C(10000000000),
-                            UINT64_C(100000000000),
-                            UINT64_C(1000000000000),
-                            UINT64_C(10000000000000),
-                            UINT64_C(100000000000000),
-                            UINT64_C(1000000000000000),
-                            UINT64_C(10000000000000000),
-                            UINT64_C(100000000000000000),
-                            UINT64_C(1000000000000000000),
-                            UINT64_C(10000000000000000000)};
-  return data[pow];
+/* The 128 most significant bits of 5^q for q in [-342, 308], rounded up for
+ * negative q, as used by the Eisel-Lemire conversion. */
+inline const uint64_t *power_of_five_128(int q)
+{
+  static const uint64_t data[651][2] = {{/*-342*/ UINT64_C(17218479456385750618), UINT64_C(1242899115359157055)},
+                                         {/*-341*/ UINT64_C(10761549660241094136), UINT64_C(5388497965526861063)},
+                                         {/*-340*/ UINT64_C(13451937075301367670), UINT64_C(6735622456908576329)},
+                                         {/*-339*/ UINT64_C(16814921344126709587), UINT64_C(17642900107990496220)},
+                                         {/*-338*/ UINT64_C(10509325840079193492), UINT64_C(8720969558280366185)},
+                                         {/*-337*/ UINT64_C(13136657300098991865), UINT64_C(10901211947850457732)},
+                                         {/*-336*/ UINT64_C(16420821625123739831), UINT64_C(18238200953240460069)},
+                                         {/*-335*/ UINT64_C(10263013515702337394), UINT64_C(18316404623416369399)},
+                                         {/*-334*/ UINT64_C(12828766894627921743), UINT64_C(13672133742415685941)},
+                                         {/*-333*/ UINT64_C(16035958618284902179), UINT64_C(12478481159592219522)},
+                                         {/*-332*/ UINT64_C(10022474136428063862), UINT64_C(5493207715531443249)},
+                                         {/*-331*/ UINT64_C(12528092670535079827), UINT64_C(16089881681269079869)},
+                                         {/*-330*/ UINT64_C(15660115838168849784), UINT64_C(15500666083158961933)},
+                                         {/*-329*/ UINT64_C(9787572398855531115), UINT64_C(9687916301974351208)},
+                                         {/*-328*/ UINT64_C(12234465498569413894), UINT64_C(7498209359040551106)},
+                                         {/*-327*/ UINT64_C(15293081873211767368), UINT64_C(149389661945913074)},
+                                         {/*-326*/ UINT64_C(9558176170757354605), UINT64_C(93368538716195671)},
+                                         {/*-325*/ UINT64_C(11947720213446693256), UINT64_C(4728396691822632493)},
+                                         {/*-324*/ UINT64_C(14934650266808366570), UINT64_C(5910495864778290617)},
+                                         {/*-323*/ UINT64_C(9334156416755229106), UINT64_C(8305745933913819539)},
+                                         {/*-322*/ UINT64_C(11667695520944036383), UINT64_C(1158810380537498616)},
+                                         {/*-321*/ UINT64_C(14584619401180045478), UINT64_C(15283571030954036982)},
+                                         {/*-320*/ UINT64_C(18230774251475056848), UINT64_C(9881091751837770420)},
+                                         {/*-319*/ UINT64_C(11394233907171910530), UINT64_C(6175682344898606512)},
+                                         {/*-318*/ UINT64_C(14242792383964888162), UINT64_C(16942974967978033949)},
+                                         {/*-317*/ UINT64_C(17803490479956110203), UINT64_C(11955346673117766628)},
+                                         {/*-316*/ UINT64_C(11127181549972568877), UINT64_C(5166248661484910190)},
+                                         {/*-315*/ UINT64_C(13908976937465711096), UINT64_C(11069496845283525642)},
+                                         {/*-314*/ UINT64_C(17386221171832138870), UINT64_C(13836871056604407053)},
+                                         {/*-313*/ UINT64_C(10866388232395086794), UINT64_C(4036358391950366504)},
+                                         {/*-312*/ UINT64_C(13582985290493858492), UINT64_C(14268820026792733938)},
+                                         {/*-311*/ UINT64_C(16978731613117323115), UINT64_C(17836025033490917422)},
+                                         {/*-310*/ UINT64_C(10611707258198326947), UINT64_C(8841672636718129437)},
+                                         {/*-309*/ UINT64_C(13264634072747908684), UINT64_C(6440404777470273892)},
+                                         {/*-308*/ UINT64_C(16580792590934885855), UINT64_C(8050505971837842365)},
+                                         {/*-307*/ UINT64_C(10362995369334303659), UINT64_C(11949095260039733334)},
+                                         {/*-306*/ UINT64_C(12953744211667879574), UINT64_C(10324683056622278764)},
+                                         {/*-305*/ UINT64_C(16192180264584849468), UINT64_C(3682481783923072647)},
+                                         {/*-304*/ UINT64_C(10120112665365530917), UINT64_C(11524923151806696212)},
+                                         {/*-303*/ UINT64_C(12650140831706913647), UINT64_C(571095884476206553)},
+                                         {/*-302*/ UINT64_C(15812676039633642058), UINT64_C(14548927910877421904)},
+                                         {/*-301*/ UINT64_C(9882922524771026286), UINT64_C(13704765962725776594)},
+                                         {/*-300*/ UINT64_C(12353653155963782858), UINT64_C(7907585416552444934)},
+                                         {/*-299*/ UINT64_C(15442066444954728573), UINT64_C(661109733835780360)},
+                                         {/*-298*/ UINT64_C(9651291528096705358), UINT64_C(2719036592861056677)},
+                                         {/*-297*/ UINT64_C(12064114410120881697), UINT64_C(12622167777931096654)},
+                                         {/*-296*/ UINT64_C(15080143012651102122), UINT64_C(1942651667131707105)},
+                                         {/*-295*/ UINT64_C(9425089382906938826), UINT64_C(5825843310384704845)},
+                                         {/*-294*/ UINT64_C(11781361728633673532), UINT64_C(16505676174835656864)},
+                                         {/*-293*/ UINT64_C(14726702160792091916), UINT64_C(2185351144835019464)},
+                                         {/*-292*/ UINT64_C(18408377700990114895), UINT64_C(2731688931043774330)},
+                                         {/*-291*/ UINT64_C(11505236063118821809), UINT64_C(8624834609543440812)},
+                                         {/*-290*/ UINT64_C(14381545078898527261), UINT64_C(15392729280356688919)},
+                                         {/*-289*/ UINT64_C(17976931348623159077), UINT64_C(5405853545163697437)},
+                                         {/*-288*/ UINT64_C(11235582092889474423), UINT64_C(5684501474941004850)},
+                                         {/*-287*/ UINT64_C(14044477616111843029), UINT64_C(2493940825248868159)},
+                                         {/*-286*/ UINT64_C(17555597020139803786), UINT64_C(7729112049988473103)},
+                                         {/*-285*/ UINT64_C(10972248137587377366), UINT64_C(9442381049670183593)},
+                                         {/*-284*/ UINT64_C(13715310171984221708), UINT64_C(2579604275232953683)},
+                                         {/*-283*/ UINT64_C(17144137714980277135), UINT64_C(3224505344041192104)},
+                                         {/*-282*/ UINT64_C(10715086071862673209), UINT64_C(8932844867666826921)},
+                                         {/*-281*/ UINT64_C(13393857589828341511), UINT64_C(15777742103010921555)},
+                                         {/*-280*/ UINT64_C(16742321987285426889), UINT64_C(15110491610336264040)},
+                                         {/*-279*/ UINT64_C(10463951242053391806), UINT64_C(2526528228819083169)},
+                                         {/*-278*/ UINT64_C(13079939052566739757), UINT64_C(12381532322878629770)},
+                                         {/*-277*/ UINT64_C(16349923815708424697), UINT64_C(1641857348316123500)},
+                                         {/*-276*/ UINT64_C(10218702384817765435), UINT64_C(12555375888766046947)},
+                                         {/*-275*/ UINT64_C(12773377981022206794), UINT64_C(11082533842530170780)},
+                                         {/*-274*/ UINT64_C(15966722476277758493), UINT64_C(4629795266307937667)},
+                                         {/*-273*/ UINT64_C(9979201547673599058), UINT64_C(5199465050656154994)},
+                                         {/*-272*/ UINT64_C(12474001934591998822), UINT64_C(15722703350174969551)},
+                                         {/*-271*/ UINT64_C(15592502418239998528), UINT64_C(10430007150863936130)},
+                                         {/*-270*/ UINT64_C(9745314011399999080), UINT64_C(6518754469289960081)},
+                                         {/*-269*/ UINT64_C(12181642514249998850), UINT64_C(8148443086612450102)},
+                                         {/*-268*/ UINT64_C(15227053142812498563), UINT64_C(962181821410786819)},
+                                         {/*-267*/ UINT64_C(9516908214257811601), UINT64_C(16742264702877599426)},
+                                         {/*-266*/ UINT64_C(11896135267822264502), UINT64_C(7092772823314835570)},
+                                         {/*-265*/ UINT64_C(14870169084777830627), UINT64_C(18089338065998320271)},
+                                         {/*-264*/ UINT64_C(9293855677986144142), UINT64_C(8999993282035256217)},
+                                         {/*-263*/ UINT64_C(11617319597482680178), UINT64_C(2026619565689294464)},
+                                         {/*-262*/ UINT64_C(14521649496853350222), UINT64_C(11756646493966393888)},
+                                         {/*-261*/ UINT64_C(18152061871066687778), UINT64_C(5472436080603216552)},
+                                         {/*-260*/ UINT64_C(11345038669416679861), UINT64_C(8031958568804398249)},
+                                         {/*-259*/ UINT64_C(14181298336770849826), UINT64_C(14651634229432885715)},
+                                         {/*-258*/ UINT64_C(17726622920963562283), UINT64_C(9091170749936331336)},
+                                         {/*-257*/ UINT64_C(11079139325602226427), UINT64_C(3376138709496513133)},
+                                         {/*-256*/ UINT64_C(13848924157002783033), UINT64_C(18055231442152805128)},
+                                         {/*-255*/ UINT64_C(17311155196253478792), UINT64_C(8733981247408842698)},
+                                         {/*-254*/ UINT64_C(10819471997658424245), UINT64_C(5458738279630526686)},
+                                         {/*-253*/ UINT64_C(13524339997073030306), UINT64_C(11435108867965546262)},
+                                         {/*-252*/ UINT64_C(16905424996341287883), UINT64_C(5070514048102157020)},
+                                         {/*-251*/ UINT64_C(10565890622713304927), UINT64_C(863228270850154185)},
+                                         {/*-250*/ UINT64_C(13207363278391631158), UINT64_C(14914093393844856443)},
+                                         {/*-249*/ UINT64_C(16509204097989538948), UINT64_C(9419244705451294746)},
+                                         {/*-248*/ UINT64_C(10318252561243461842), UINT64_C(15110399977761835024)},
+                                         {/*-247*/ UINT64_C(12897815701554327303), UINT64_C(9664627935347517973)},
+                                         {/*-246*/ UINT64_C(16122269626942909129), UINT64_C(7469098900757009562)},
+                                         {/*-245*/ UINT64_C(10076418516839318205), UINT64_C(16197401859041600736)},
+                                         {/*-244*/ UINT64_C(12595523146049147757), UINT64_C(6411694268519837208)},
+                                         {/*-243*/ UINT64_C(15744403932561434696), UINT64_C(12626303854077184414)},
+                                         {/*-242*/ UINT64_C(9840252457850896685), UINT64_C(7891439908798240259)},
+                                         {/*-241*/ UINT64_C(12300315572313620856), UINT64_C(14475985904425188227)},
+                                         {/*-240*/ UINT64_C(15375394465392026070), UINT64_C(18094982380531485284)},
+                                         {/*-239*/ UINT64_C(9609621540870016294), UINT64_C(6697677969404790399)},
+                                         {/*-238*/ UINT64_C(12012026926087520367), UINT64_C(17595469498610763806)},
+                                         {/*-237*/ UINT64_C(15015033657609400459), UINT64_C(17382650854836066854)},
+                                         {/*-236*/ UINT64_C(9384396036005875287), UINT64_C(8558313775058847832)},
+                                         {/*-235*/ UINT64_C(11730495045007344109), UINT64_C(6086206200396171886)},
+                                         {/*-234*/ UINT64_C(14663118806259180136), UINT64_C(12219443768922602761)},
+                                         {/*-233*/ UINT64_C(18328898507823975170), UINT64_C(15274304711153253452)},
+                                         {/*-232*/ UINT64_C(11455561567389984481), UINT64_C(14158126462898171311)},
+                                         {/*-231*/ UINT64_C(14319451959237480602), UINT64_C(3862600023340550427)},
+                                         {/*-230*/ UINT64_C(17899314949046850752), UINT64_C(14051622066030463842)},
+                                         {/*-229*/ UINT64_C(11187071843154281720), UINT64_C(8782263791269039901)},
+                                         {/*-228*/ UINT64_C(13983839803942852150), UINT64_C(10977829739086299876)},
+                                         {/*-227*/ UINT64_C(17479799754928565188), UINT64_C(4498915137003099037)},
+                                         {/*-226*/ UINT64_C(10924874846830353242), UINT64_C(12035193997481712706)},
+                                         {/*-225*/ UINT64_C(13656093558537941553), UINT64_C(5820620459997365075)},
+                                         {/*-224*/ UINT64_C(17070116948172426941), UINT64_C(11887461593424094248)},
+                                         {/*-223*/ UINT64_C(10668823092607766838), UINT64_C(9735506505103752857)},
+                                         {/*-222*/ UINT64_C(13336028865759708548), UINT64_C(2946011094524915263)},
+                                         {/*-221*/ UINT64_C(16670036082199635685), UINT64_C(3682513868156144079)},
+                                         {/*-220*/ UINT64_C(10418772551374772303), UINT64_C(4607414176811284001)},
+                                         {/*-219*/ UINT64_C(13023465689218465379), UINT64_C(1147581702586717097)},
+                                         {/*-218*/ UINT64_C(16279332111523081723), UINT64_C(15269535183515560084)},
+                                         {/*-217*/ UINT64_C(10174582569701926077), UINT64_C(7237616480483531100)},
+                                         {/*-216*/ UINT64_C(12718228212127407596), UINT64_C(13658706619031801779)},
+                                         {/*-215*/ UINT64_C(15897785265159259495), UINT64_C(17073383273789752224)},
+                                         {/*-214*/ UINT64_C(9936115790724537184), UINT64_C(17588393573759676996)},
+                                         {/*-213*/ UINT64_C(12420144738405671481), UINT64_C(3538747893490044629)},
+                                         {/*-212*/ UINT64_C(15525180923007089351), UINT64_C(9035120885289943691)},
+                                         {/*-211*/ UINT64_C(9703238076879430844), UINT64_C(12564479580947296663)},
+                                         {/*-210*/ UINT64_C(12129047596099288555), UINT64_C(15705599476184120828)},
+                                         {/*-209*/ UINT64_C(15161309495124110694), UINT64_C(15020313326802763131)},
+                                         {/*-208*/ UINT64_C(9475818434452569184), UINT64_C(4776009810824339053)},
+                                         {/*-207*/ UINT64_C(11844773043065711480), UINT64_C(5970012263530423816)},
+                                         {/*-206*/ UINT64_C(14805966303832139350), UINT64_C(7462515329413029771)},
+                                         {/*-205*/ UINT64_C(9253728939895087094), UINT64_C(52386062455755702)},
+                                         {/*-204*/ UINT64_C(11567161174868858867), UINT64_C(9288854614924470436)},
+                                         {/*-203*/ UINT64_C(14458951468586073584), UINT64_C(6999382250228200141)},
+                                         {/*-202*/ UINT64_C(18073689335732591980), UINT64_C(8749227812785250177)},
+                                         {/*-201*/ UINT64_C(11296055834832869987), UINT64_C(14691639419845557168)},
+                                         {/*-200*/ UINT64_C(14120069793541087484), UINT64_C(13752863256379558556)},
+                                         {/*-199*/ UINT64_C(17650087241926359355), UINT64_C(17191079070474448196)},
+                                         {/*-198*/ UINT64_C(11031304526203974597), UINT64_C(8438581409832836170)},
+                                         {/*-197*/ UINT64_C(13789130657754968246), UINT64_C(15159912780718433117)},
+                                         {/*-196*/ UINT64_C(17236413322193710308), UINT64_C(9726518939043265588)},
+                                         {/*-195*/ UINT64_C(10772758326371068942), UINT64_C(15302446373756816800)},
+                                         {/*-194*/ UINT64_C(13465947907963836178), UINT64_C(9904685930341245193)},
+                                         {/*-193*/ UINT64_C(16832434884954795223), UINT64_C(3157485376071780683)},
+                                         {/*-192*/ UINT64_C(10520271803096747014), UINT64_C(8890957387685944783)},
+                                         {/*-191*/ UINT64_C(13150339753870933768), UINT64_C(1890324697752655170)},
+                                         {/*-190*/ UINT64_C(16437924692338667210), UINT64_C(2362905872190818963)},
+                                         {/*-189*/ UINT64_C(10273702932711667006), UINT64_C(6088502188546649756)},
+                                         {/*-188*/ UINT64_C(12842128665889583757), UINT64_C(16833999772538088003)},
+                                         {/*-187*/ UINT64_C(16052660832361979697), UINT64_C(7207441660390446292)},
+                                         {/*-186*/ UINT64_C(10032913020226237310), UINT64_C(16033866083812498692)},
+                                         {/*-185*/ UINT64_C(12541141275282796638), UINT64_C(10818960567910847557)},
+                                         {/*-184*/ UINT64_C(15676426594103495798), UINT64_C(4300328673033783639)},
+                                         {/*-183*/ UINT64_C(9797766621314684873), UINT64_C(16522763475928278486)},
+                                         {/*-182*/ UINT64_C(12247208276643356092), UINT64_C(6818396289628184396)},
+                                         {/*-181*/ UINT64_C(15309010345804195115), UINT64_C(8522995362035230495)},
+                                         {/*-180*/ UINT64_C(9568131466127621947), UINT64_C(3021029092058325107)},
+                                         {/*-179*/ UINT64_C(11960164332659527433), UINT64_C(17611344420355070096)},
+                                         {/*-178*/ UINT64_C(14950205415824409292), UINT64_C(8179122470161673908)},
+                                         {/*-177*/ UINT64_C(9343878384890255807), UINT64_C(14335323580705822000)},
+                                         {/*-176*/ UINT64_C(11679847981112819759), UINT64_C(13307468457454889596)},
+                                         {/*-175*/ UINT64_C(14599809976391024699), UINT64_C(12022649553391224092)},
+                                         {/*-174*/ UINT64_C(18249762470488780874), UINT64_C(10416625923311642211)},
+                                         {/*-173*/ UINT64_C(11406101544055488046), UINT64_C(11122077220497164286)},
+                                         {/*-172*/ UINT64_C(14257626930069360058), UINT64_C(4679224488766679549)},
+                                         {/*-171*/ UINT64_C(17822033662586700072), UINT64_C(15072402647813125244)},
+                                         {/*-170*/ UINT64_C(11138771039116687545), UINT64_C(9420251654883203278)},
+                                         {/*-169*/ UINT64_C(13923463798895859431), UINT64_C(16387000587031392001)},
+                                         {/*-168*/ UINT64_C(17404329748619824289), UINT64_C(15872064715361852097)},
+                                         {/*-167*/ UINT64_C(10877706092887390181), UINT64_C(3002511419460075705)},
+                                         {/*-166*/ UINT64_C(13597132616109237726), UINT64_C(8364825292752482535)},
+                                         {/*-165*/ UINT64_C(16996415770136547158), UINT64_C(1232659579085827361)},
+                                         {/*-164*/ UINT64_C(10622759856335341973), UINT64_C(14605470292210805812)},
+                                         {/*-163*/ UINT64_C(13278449820419177467), UINT64_C(4421779809981343554)},
+                                         {/*-162*/ UINT64_C(16598062275523971834), UINT64_C(915538744049291538)},
+                                         {/*-161*/ UINT64_C(10373788922202482396), UINT64_C(5183897733458195115)},
+                                         {/*-160*/ UINT64_C(12967236152753102995), UINT64_C(6479872166822743894)},
+                                         {/*-159*/ UINT64_C(16209045190941378744), UINT64_C(3488154190101041964)},
+                                         {/*-158*/ UINT64_C(10130653244338361715), UINT64_C(2180096368813151227)},
+                                         {/*-157*/ UINT64_C(12663316555422952143), UINT64_C(16560178516298602746)},
+                                         {/*-156*/ UINT64_C(15829145694278690179), UINT64_C(16088537126945865529)},
+                                         {/*-155*/ UINT64_C(9893216058924181362), UINT64_C(7749492695127472003)},
+                                         {/*-154*/ UINT64_C(12366520073655226703), UINT64_C(463493832054564196)},
+                                         {/*-153*/ UINT64_C(15458150092069033378), UINT64_C(14414425345350368957)},
+                                         {/*-152*/ UINT64_C(9661343807543145861), UINT64_C(13620701859271368502)},
+                                         {/*-151*/ UINT64_C(12076679759428932327), UINT64_C(3190819268807046916)},
+                                         {/*-150*/ UINT64_C(15095849699286165408), UINT64_C(17823582141290972357)},
+                                         {/*-149*/ UINT64_C(9434906062053853380), UINT64_C(11139738838306857723)},
+                                         {/*-148*/ UINT64_C(11793632577567316725), UINT64_C(13924673547883572154)},
+                                         {/*-147*/ UINT64_C(14742040721959145907), UINT64_C(3570783879572301480)},
+                                         {/*-146*/ UINT64_C(18427550902448932383), UINT64_C(18298537904747540562)},
+                                         {/*-145*/ UINT64_C(11517219314030582739), UINT64_C(18354115218108294707)},
+                                         {/*-144*/ UINT64_C(14396524142538228424), UINT64_C(18330958004207980480)},
+                                         {/*-143*/ UINT64_C(17995655178172785531), UINT64_C(4466953431550423984)},
+                                         {/*-142*/ UINT64_C(11247284486357990957), UINT64_C(486002885505321038)},
+                                         {/*-141*/ UINT64_C(14059105607947488696), UINT64_C(5219189625309039202)},
+                                         {/*-140*/ UINT64_C(17573882009934360870), UINT64_C(6523987031636299002)},
+                                         {/*-139*/ UINT64_C(10983676256208975543), UINT64_C(17912549950054850588)},
+                                         {/*-138*/ UINT64_C(13729595320261219429), UINT64_C(17779001419141175331)},
+                                         {/*-137*/ UINT64_C(17161994150326524287), UINT64_C(8388693718644305452)},
+                                         {/*-136*/ UINT64_C(10726246343954077679), UINT64_C(12160462601793772764)},
+                                         {/*-135*/ UINT64_C(13407807929942597099), UINT64_C(10588892233814828051)},
+                                         {/*-134*/ UINT64_C(16759759912428246374), UINT64_C(8624429273841147159)},
+                                         {/*-133*/ UINT64_C(10474849945267653984), UINT64_C(778582277723329070)},
+                                         {/*-132*/ UINT64_C(13093562431584567480), UINT64_C(973227847154161338)},
+                                         {/*-131*/ UINT64_C(16366953039480709350), UINT64_C(1216534808942701673)},
+                                         {/*-130*/ UINT64_C(10229345649675443343), UINT64_C(14595392310871352257)},
+                                         {/*-129*/ UINT64_C(12786682062094304179), UINT64_C(13632554370161802418)},
+                                         {/*-128*/ UINT64_C(15983352577617880224), UINT64_C(12429006944274865118)},
+                                         {/*-127*/ UINT64_C(9989595361011175140), UINT64_C(7768129340171790699)},
+                                         {/*-126*/ UINT64_C(12486994201263968925), UINT64_C(9710161675214738374)},
+                                         {/*-125*/ UINT64_C(15608742751579961156), UINT64_C(16749388112445810871)},
+                                         {/*-124*/ UINT64_C(9755464219737475723), UINT64_C(1244995533423855986)},
+                                         {/*-123*/ UINT64_C(12194330274671844653), UINT64_C(15391302472061983695)},
+                                         {/*-122*/ UINT64_C(15242912843339805817), UINT64_C(5404070034795315907)},
+                                         {/*-121*/ UINT64_C(9526820527087378635), UINT64_C(14906758817815542202)},
+                                         {/*-120*/ UINT64_C(11908525658859223294), UINT64_C(14021762503842039848)},
+                                         {/*-119*/ UINT64_C(14885657073574029118), UINT64_C(8303831092947774002)},
+                                         {/*-118*/ UINT64_C(9303535670983768199), UINT64_C(578208414664970847)},
+                                         {/*-117*/ UINT64_C(11629419588729710248), UINT64_C(14557818573613377271)},
+                                         {/*-116*/ UINT64_C(14536774485912137810), UINT64_C(18197273217016721589)},
+                                         {/*-115*/ UINT64_C(18170968107390172263), UINT64_C(13523219484416126178)},
+                                         {/*-114*/ UINT64_C(11356855067118857664), UINT64_C(15369541205401160717)},
+                                         {/*-113*/ UINT64_C(14196068833898572081), UINT64_C(765182433041899281)},
+                                         {/*-112*/ UINT64_C(17745086042373215101), UINT64_C(5568164059729762005)},
+                                         {/*-111*/ UINT64_C(11090678776483259438), UINT64_C(5785945546544795205)},
+                                         {/*-110*/ UINT64_C(13863348470604074297), UINT64_C(16455803970035769814)},
+                                         {/*-109*/ UINT64_C(17329185588255092872), UINT64_C(6734696907262548556)},
+                                         {/*-108*/ UINT64_C(10830740992659433045), UINT64_C(4209185567039092847)},
+                                         {/*-107*/ UINT64_C(13538426240824291306), UINT64_C(9873167977226253963)},
+                                         {/*-106*/ UINT64_C(16923032801030364133), UINT64_C(3118087934678041646)},
+                                         {/*-105*/ UINT64_C(10576895500643977583), UINT64_C(4254647968387469981)},
+                                         {/*-104*/ UINT64_C(13221119375804971979), UINT64_C(706623942056949572)},
+                                         {/*-103*/ UINT64_C(16526399219756214973), UINT64_C(14718337982853350677)},
+                                         {/*-102*/ UINT64_C(10328999512347634358), UINT64_C(11504804248497038125)},
+                                         {/*-101*/ UINT64_C(12911249390434542948), UINT64_C(5157633273766521849)},
+                                         {/*-100*/ UINT64_C(16139061738043178685), UINT64_C(6447041592208152311)},
+                                         {/* -99*/ UINT64_C(10086913586276986678), UINT64_C(6335244004343789146)},
+                                         {/* -98*/ UINT64_C(12608641982846233347), UINT64_C(17142427042284512241)},
+                                         {/* -97*/ UINT64_C(15760802478557791684), UINT64_C(16816347784428252397)},
+                                         {/* -96*/ UINT64_C(9850501549098619803), UINT64_C(1286845328412881940)},
+                                         {/* -95*/ UINT64_C(12313126936373274753), UINT64_C(15443614715798266137)},
+                                         {/* -94*/ UINT64_C(15391408670466593442), UINT64_C(5469460339465668959)},
+                                         {/* -93*/ UINT64_C(9619630419041620901), UINT64_C(8030098730593431003)},
+                                         {/* -92*/ UINT64_C(12024538023802026126), UINT64_C(14649309431669176658)},
+                                         {/* -91*/ UINT64_C(15030672529752532658), UINT64_C(9088264752731695015)},
+                                         {/* -90*/ UINT64_C(9394170331095332911), UINT64_C(10291851488884697288)},
+                                         {/* -89*/ UINT64_C(11742712913869166139), UINT64_C(8253128342678483706)},
+                                         {/* -88*/ UINT64_C(14678391142336457674), UINT64_C(5704724409920716729)},
+                                         {/* -87*/ UINT64_C(18347988927920572092), UINT64_C(16354277549255671720)},
+                                         {/* -86*/ UINT64_C(11467493079950357558), UINT64_C(998051431430019017)},
+                                         {/* -85*/ UINT64_C(14334366349937946947), UINT64_C(10470936326142299579)},
+                                         {/* -84*/ UINT64_C(17917957937422433684), UINT64_C(8476984389250486570)},
+                                         {/* -83*/ UINT64_C(11198723710889021052), UINT64_C(14521487280136329914)},
+                                         {/* -82*/ UINT64_C(13998404638611276315), UINT64_C(18151859100170412392)},
+                                         {/* -81*/ UINT64_C(17498005798264095394), UINT64_C(18078137856785627587)},
+                                         {/* -80*/ UINT64_C(10936253623915059621), UINT64_C(15910522178918405146)},
+                                         {/* -79*/ UINT64_C(13670317029893824527), UINT64_C(6053094668365842720)},
+                                         {/* -78*/ UINT64_C(17087896287367280659), UINT64_C(2954682317029915496)},
+                                         {/* -77*/ UINT64_C(10679935179604550411), UINT64_C(17987577512639554849)},
+                                         {/* -76*/ UINT64_C(13349918974505688014), UINT64_C(17872785872372055657)},
+                                         {/* -75*/ UINT64_C(16687398718132110018), UINT64_C(13117610303610293764)},
+                                         {/* -74*/ UINT64_C(10429624198832568761), UINT64_C(12810192458183821506)},
+                                         {/* -73*/ UINT64_C(13037030248540710952), UINT64_C(2177682517447613171)},
+                                         {/* -72*/ UINT64_C(16296287810675888690), UINT64_C(2722103146809516464)},
+                                         {/* -71*/ UINT64_C(10185179881672430431), UINT64_C(6313000485183335694)},
+                                         {/* -70*/ UINT64_C(12731474852090538039), UINT64_C(3279564588051781713)},
+                                         {/* -69*/ UINT64_C(15914343565113172548), UINT64_C(17934513790346890853)},
+                                         {/* -68*/ UINT64_C(9946464728195732843), UINT64_C(1985699082112030975)},
+                                         {/* -67*/ UINT64_C(12433080910244666053), UINT64_C(16317181907922202431)},
+                                         {/* -66*/ UINT64_C(15541351137805832567), UINT64_C(6561419329620589327)},
+                                         {/* -65*/ UINT64_C(9713344461128645354), UINT64_C(11018416108653950185)},
+                                         {/* -64*/ UINT64_C(12141680576410806693), UINT64_C(4549648098962661924)},
+                                         {/* -63*/ UINT64_C(15177100720513508366), UINT64_C(10298746142130715309)},
+                                         {/* -62*/ UINT64_C(9485687950320942729), UINT64_C(1825030320404309164)},
+                                         {/* -61*/ UINT64_C(11857109937901178411), UINT64_C(6892973918932774359)},
+                                         {/* -60*/ UINT64_C(14821387422376473014), UINT64_C(4004531380238580045)},
+                                         {/* -59*/ UINT64_C(9263367138985295633), UINT64_C(16337890167931276240)},
+                                         {/* -58*/ UINT64_C(11579208923731619542), UINT64_C(6587304654631931588)},
+                                         {/* -57*/ UINT64_C(14474011154664524427), UINT64_C(17457502855144690293)},
+                                         {/* -56*/ UINT64_C(18092513943330655534), UINT64_C(17210192550503474962)},
+                                         {/* -55*/ UINT64_C(11307821214581659709), UINT64_C(6144684325637283947)},
+                                         {/* -54*/ UINT64_C(14134776518227074636), UINT64_C(12292541425473992838)},
+                                         {/* -53*/ UINT64_C(17668470647783843295), UINT64_C(15365676781842491048)},
+                                         {/* -52*/ UINT64_C(11042794154864902059), UINT64_C(16521077016292638761)},
+                                         {/* -51*/ UINT64_C(13803492693581127574), UINT64_C(16039660251938410547)},
+                                         {/* -50*/ UINT64_C(17254365866976409468), UINT64_C(10826203278068237376)},
+                                         {/* -49*/ UINT64_C(10783978666860255917), UINT64_C(15989749085647424168)},
+                                         {/* -48*/ UINT64_C(13479973333575319897), UINT64_C(6152128301777116498)},
+                                         {/* -47*/ UINT64_C(16849966666969149871), UINT64_C(12301846395648783526)},
+                                         {/* -46*/ UINT64_C(10531229166855718669), UINT64_C(14606183024921571560)},
+                                         {/* -45*/ UINT64_C(13164036458569648337), UINT64_C(4422670725869800738)},
+                                         {/* -44*/ UINT64_C(16455045573212060421), UINT64_C(10140024425764638826)},
+                                         {/* -43*/ UINT64_C(10284403483257537763), UINT64_C(8643358275316593218)},
+                                         {/* -42*/ UINT64_C(12855504354071922204), UINT64_C(6192511825718353619)},
+                                         {/* -41*/ UINT64_C(16069380442589902755), UINT64_C(7740639782147942024)},
+                                         {/* -40*/ UINT64_C(10043362776618689222), UINT64_C(2532056854628769813)},
+                                         {/* -39*/ UINT64_C(12554203470773361527), UINT64_C(12388443105140738074)},
+                                         {/* -38*/ UINT64_C(15692754338466701909), UINT64_C(10873867862998534689)},
+                                         {/* -37*/ UINT64_C(9807971461541688693), UINT64_C(9102010423587778132)},
+                                         {/* -36*/ UINT64_C(12259964326927110866), UINT64_C(15989199047912110569)},
+                                         {/* -35*/ UINT64_C(15324955408658888583), UINT64_C(10763126773035362404)},
+                                         {/* -34*/ UINT64_C(9578097130411805364), UINT64_C(13644483260788183358)},
+                                         {/* -33*/ UINT64_C(11972621413014756705), UINT64_C(17055604075985229198)},
+                                         {/* -32*/ UINT64_C(14965776766268445882), UINT64_C(7484447039699372786)},
+                                         {/* -31*/ UINT64_C(9353610478917778676), UINT64_C(9289465418239495895)},
+                                         {/* -30*/ UINT64_C(11692013098647223345), UINT64_C(11611831772799369869)},
+                                         {/* -29*/ UINT64_C(14615016373309029182), UINT64_C(679731660717048624)},
+                                         {/* -28*/ UINT64_C(18268770466636286477), UINT64_C(10073036612751086588)},
+                                         {/* -27*/ UINT64_C(11417981541647679048), UINT64_C(8601490892183123070)},
+                                         {/* -26*/ UINT64_C(14272476927059598810), UINT64_C(10751863615228903838)},
+                                         {/* -25*/ UINT64_C(17840596158824498513), UINT64_C(4216457482181353989)},
+                                         {/* -24*/ UINT64_C(11150372599265311570), UINT64_C(14164500972431816003)},
+                                         {/* -23*/ UINT64_C(13937965749081639463), UINT64_C(8482254178684994196)},
+                                         {/* -22*/ UINT64_C(17422457186352049329), UINT64_C(5991131704928854841)},
+                                         {/* -21*/ UINT64_C(10889035741470030830), UINT64_C(15273672361649004036)},
+                                         {/* -20*/ UINT64_C(13611294676837538538), UINT64_C(9868718415206479237)},
+                                         {/* -19*/ UINT64_C(17014118346046923173), UINT64_C(3112525982153323238)},
+                                         {/* -18*/ UINT64_C(10633823966279326983), UINT64_C(4251171748059520976)},
+                                         {/* -17*/ UINT64_C(13292279957849158729), UINT64_C(702278666647013315)},
+                                         {/* -16*/ UINT64_C(16615349947311448411), UINT64_C(5489534351736154548)},
+                                         {/* -15*/ UINT64_C(10384593717069655257), UINT64_C(1125115960621402641)},
+                                         {/* -14*/ UINT64_C(12980742146337069071), UINT64_C(6018080969204141205)},
+                                         {/* -13*/ UINT64_C(16225927682921336339), UINT64_C(2910915193077788602)},
+                                         {/* -12*/ UINT64_C(10141204801825835211), UINT64_C(17960223060169475540)},
+                                         {/* -11*/ UINT64_C(12676506002282294014), UINT64_C(17838592806784456521)},
+                                         {/* -10*/ UINT64_C(15845632502852867518), UINT64_C(13074868971625794844)},
+                                         {/*  -9*/ UINT64_C(9903520314283042199), UINT64_C(3560107088838733873)},
+                                         {/*  -8*/ UINT64_C(12379400392853802748), UINT64_C(18285191916330581054)},
+                                         {/*  -7*/ UINT64_C(15474250491067253436), UINT64_C(4409745821703674701)},
+                                         {/*  -6*/ UINT64_C(9671406556917033397), UINT64_C(11979463175419572496)},
+                                         {/*  -5*/ UINT64_C(12089258196146291747), UINT64_C(1139270913992301908)},
+                                         {/*  -4*/ UINT64_C(15111572745182864683), UINT64_C(15259146697772541097)},
+                                         {/*  -3*/ UINT64_C(9444732965739290427), UINT64_C(7231123676894144234)},
+                                         {/*  -2*/ UINT64_C(11805916207174113034), UINT64_C(4427218577690292388)},
+                                         {/*  -1*/ UINT64_C(14757395258967641292), UINT64_C(14757395258967641293)},
+                                         {/*   0*/ UINT64_C(9223372036854775808), UINT64_C(0)},
+                                         {/*   1*/ UINT64_C(11529215046068469760), UINT64_C(0)},
+                                         {/*   2*/ UINT64_C(14411518807585587200), UINT64_C(0)},
+                                         {/*   3*/ UINT64_C(18014398509481984000), UINT64_C(0)},
+                                         {/*   4*/ UINT64_C(11258999068426240000), UINT64_C(0)},
+                                         {/*   5*/ UINT64_C(14073748835532800000), UINT64_C(0)},
+                                         {/*   6*/ UINT64_C(17592186044416000000), UINT64_C(0)},
+                                         {/*   7*/ UINT64_C(10995116277760000000), UINT64_C(0)},
+                                         {/*   8*/ UINT64_C(13743895347200000000), UINT64_C(0)},
+                                         {/*   9*/ UINT64_C(17179869184000000000), UINT64_C(0)},
+                                         {/*  10*/ UINT64_C(10737418240000000000), UINT64_C(0)},
+                                         {/*  11*/ UINT64_C(13421772800000000000), UINT64_C(0)},
+                                         {/*  12*/ UINT64_C(16777216000000000000), UINT64_C(0)},
+                                         {/*  13*/ UINT64_C(10485760000000000000), UINT64_C(0)},
+                                         {/*  14*/ UINT64_C(13107200000000000000), UINT64_C(0)},
+                                         {/*  15*/ UINT64_C(16384000000000000000), UINT64_C(0)},
+                                         {/*  16*/ UINT64_C(10240000000000000000), UINT64_C(0)},
+                                         {/*  17*/ UINT64_C(12800000000000000000), UINT64_C(0)},
+                                         {/*  18*/ UINT64_C(16000000000000000000), UINT64_C(0)},
+                                         {/*  19*/ UINT64_C(10000000000000000000), UINT64_C(0)},
+                                         {/*  20*/ UINT64_C(12500000000000000000), UINT64_C(0)},
+                                         {/*  21*/ UINT64_C(15625000000000000000), UINT64_C(0)},
+                                         {/*  22*/ UINT64_C(9765625000000000000), UINT64_C(0)},
+                                         {/*  23*/ UINT64_C(12207031250000000000), UINT64_C(0)},
+                                         {/*  24*/ UINT64_C(15258789062500000000), UINT64_C(0)},
+                                         {/*  25*/ UINT64_C(9536743164062500000), UINT64_C(0)},
+                                         {/*  26*/ UINT64_C(11920928955078125000), UINT64_C(0)},
+                                         {/*  27*/ UINT64_C(14901161193847656250), UINT64_C(0)},
+                                         {/*  28*/ UINT64_C(9313225746154785156), UINT64_C(4611686018427387904)},
+                                         {/*  29*/ UINT64_C(11641532182693481445), UINT64_C(5764607523034234880)},
+                                         {/*  30*/ UINT64_C(14551915228366851806), UINT64_C(11817445422220181504)},
+                                         {/*  31*/ UINT64_C(18189894035458564758), UINT64_C(5548434740920451072)},
+                                         {/*  32*/ UINT64_C(11368683772161602973), UINT64_C(17302829768357445632)},
+                                         {/*  33*/ UINT64_C(14210854715202003717), UINT64_C(7793479155164643328)},
+                                         {/*  34*/ UINT64_C(17763568394002504646), UINT64_C(14353534962383192064)},
+                                         {/*  35*/ UINT64_C(11102230246251565404), UINT64_C(4359273333062107136)},
+                                         {/*  36*/ UINT64_C(13877787807814456755), UINT64_C(5449091666327633920)},
+                                         {/*  37*/ UINT64_C(17347234759768070944), UINT64_C(2199678564482154496)},
+                                         {/*  38*/ UINT64_C(10842021724855044340), UINT64_C(1374799102801346560)},
+                                         {/*  39*/ UINT64_C(13552527156068805425), UINT64_C(1718498878501683200)},
+                                         {/*  40*/ UINT64_C(16940658945086006781), UINT64_C(6759809616554491904)},
+                                         {/*  41*/ UINT64_C(10587911840678754238), UINT64_C(6530724019560251392)},
+                                         {/*  42*/ UINT64_C(13234889800848442797), UINT64_C(17386777061305090048)},
+                                         {/*  43*/ UINT64_C(16543612251060553497), UINT64_C(7898413271349198848)},
+                                         {/*  44*/ UINT64_C(10339757656912845935), UINT64_C(16465723340661719040)},
+                                         {/*  45*/ UINT64_C(12924697071141057419), UINT64_C(15970468157399760896)},
+                                         {/*  46*/ UINT64_C(16155871338926321774), UINT64_C(15351399178322313216)},
+                                         {/*  47*/ UINT64_C(10097419586828951109), UINT64_C(4982938468024057856)},
+                                         {/*  48*/ UINT64_C(12621774483536188886), UINT64_C(10840359103457460224)},
+                                         {/*  49*/ UINT64_C(15777218104420236108), UINT64_C(4327076842467049472)},
+                                         {/*  50*/ UINT64_C(9860761315262647567), UINT64_C(11927795063396681728)},
+                                         {/*  51*/ UINT64_C(12325951644078309459), UINT64_C(10298057810818464256)},
+                                         {/*  52*/ UINT64_C(15407439555097886824), UINT64_C(8260886245095692416)},
+                                         {/*  53*/ UINT64_C(9629649721936179265), UINT64_C(5163053903184807760)},
+                                         {/*  54*/ UINT64_C(12037062152420224081), UINT64_C(11065503397408397604)},
+                                         {/*  55*/ UINT64_C(15046327690525280101), UINT64_C(18443565265187884909)},
+                                         {/*  56*/ UINT64_C(9403954806578300063), UINT64_C(13833071299956122020)},
+                                         {/*  57*/ UINT64_C(11754943508222875079), UINT64_C(12679653106517764621)},
+                                         {/*  58*/ UINT64_C(14693679385278593849), UINT64_C(11237880364719817872)},
+                                         {/*  59*/ UINT64_C(18367099231598242312), UINT64_C(212292400617608628)},
+                                         {/*  60*/ UINT64_C(11479437019748901445), UINT64_C(132682750386005392)},
+                                         {/*  61*/ UINT64_C(14349296274686126806), UINT64_C(4777539456409894645)},
+                                         {/*  62*/ UINT64_C(17936620343357658507), UINT64_C(15195296357367144114)},
+                                         {/*  63*/ UINT64_C(11210387714598536567), UINT64_C(7191217214140771119)},
+                                         {/*  64*/ UINT64_C(14012984643248170709), UINT64_C(4377335499248575995)},
+                                         {/*  65*/ UINT64_C(17516230804060213386), UINT64_C(10083355392488107898)},
+                                         {/*  66*/ UINT64_C(10947644252537633366), UINT64_C(10913783138732455340)},
+                                         {/*  67*/ UINT64_C(13684555315672041708), UINT64_C(4418856886560793367)},
+                                         {/*  68*/ UINT64_C(17105694144590052135), UINT64_C(5523571108200991709)},
+                                         {/*  69*/ UINT64_C(10691058840368782584), UINT64_C(10369760970266701674)},
+                                         {/*  70*/ UINT64_C(13363823550460978230), UINT64_C(12962201212833377092)},
+                                         {/*  71*/ UINT64_C(16704779438076222788), UINT64_C(6979379479186945558)},
+                                         {/*  72*/ UINT64_C(10440487148797639242), UINT64_C(13585484211346616781)},
+                                         {/*  73*/ UINT64_C(13050608935997049053), UINT64_C(7758483227328495169)},
+                                         {/*  74*/ UINT64_C(16313261169996311316), UINT64_C(14309790052588006865)},
+                                         {/*  75*/ UINT64_C(10195788231247694572), UINT64_C(18166990819722280098)},
+                                         {/*  76*/ UINT64_C(12744735289059618216), UINT64_C(4261994450943298507)},
+                                         {/*  77*/ UINT64_C(15930919111324522770), UINT64_C(5327493063679123134)},
+                                         {/*  78*/ UINT64_C(9956824444577826731), UINT64_C(7941369183226839863)},
+                                         {/*  79*/ UINT64_C(12446030555722283414), UINT64_C(5315025460606161924)},
+                                         {/*  80*/ UINT64_C(15557538194652854267), UINT64_C(15867153862612478214)},
+                                         {/*  81*/ UINT64_C(9723461371658033917), UINT64_C(7611128154919104931)},
+                                         {/*  82*/ UINT64_C(12154326714572542396), UINT64_C(14125596212076269068)},
+                                         {/*  83*/ UINT64_C(15192908393215677995), UINT64_C(17656995265095336336)},
+                                         {/*  84*/ UINT64_C(9495567745759798747), UINT64_C(8729779031470891258)},
+                                         {/*  85*/ UINT64_C(11869459682199748434), UINT64_C(6300537770911226168)},
+                                         {/*  86*/ UINT64_C(14836824602749685542), UINT64_C(17099044250493808518)},
+                                         {/*  87*/ UINT64_C(9273015376718553464), UINT64_C(6075216638131242420)},
+                                         {/*  88*/ UINT64_C(11591269220898191830), UINT64_C(7594020797664053025)},
+                                         {/*  89*/ UINT64_C(14489086526122739788), UINT64_C(269153960225290473)},
+                                         {/*  90*/ UINT64_C(18111358157653424735), UINT64_C(336442450281613091)},
+                                         {/*  91*/ UINT64_C(11319598848533390459), UINT64_C(7127805559067090038)},
+                                         {/*  92*/ UINT64_C(14149498560666738074), UINT64_C(4298070930406474644)},
+                                         {/*  93*/ UINT64_C(17686873200833422592), UINT64_C(14595960699862869113)},
+                                         {/*  94*/ UINT64_C(11054295750520889120), UINT64_C(9122475437414293195)},
+                                         {/*  95*/ UINT64_C(13817869688151111400), UINT64_C(11403094296767866494)},
+                                         {/*  96*/ UINT64_C(17272337110188889250), UINT64_C(14253867870959833118)},
+                                         {/*  97*/ UINT64_C(10795210693868055781), UINT64_C(13520353437777283602)},
+                                         {/*  98*/ UINT64_C(13494013367335069727), UINT64_C(3065383741939440791)},
+                                         {/*  99*/ UINT64_C(16867516709168837158), UINT64_C(17666787732706464701)},
+                                         {/* 100*/ UINT64_C(10542197943230523224), UINT64_C(6430056314514152534)},
+                                         {/* 101*/ UINT64_C(13177747429038154030), UINT64_C(8037570393142690668)},
+                                         {/* 102*/ UINT64_C(16472184286297692538), UINT64_C(823590954573587527)},
+                                         {/* 103*/ UINT64_C(10295115178936057836), UINT64_C(5126430365035880108)},
+                                         {/* 104*/ UINT64_C(12868893973670072295), UINT64_C(6408037956294850135)},
+                                         {/* 105*/ UINT64_C(16086117467087590369), UINT64_C(3398361426941174765)},
+                                         {/* 106*/ UINT64_C(10053823416929743980), UINT64_C(13653190937906703988)},
+                                         {/* 107*/ UINT64_C(12567279271162179975), UINT64_C(17066488672383379985)},
+                                         {/* 108*/ UINT64_C(15709099088952724969), UINT64_C(16721424822051837077)},
+                                         {/* 109*/ UINT64_C(9818186930595453106), UINT64_C(3533361486141316317)},
+                                         {/* 110*/ UINT64_C(12272733663244316382), UINT64_C(13640073894531421205)},
+                                         {/* 111*/ UINT64_C(15340917079055395478), UINT64_C(7826720331309500698)},
+                                         {/* 112*/ UINT64_C(9588073174409622174), UINT64_C(280014188641050032)},
+                                         {/* 113*/ UINT64_C(11985091468012027717), UINT64_C(9573389772656088348)},
+                                         {/* 114*/ UINT64_C(14981364335015034646), UINT64_C(16578423234247498339)},
+                                         {/* 115*/ UINT64_C(9363352709384396654), UINT64_C(5749828502977298558)},
+                                         {/* 116*/ UINT64_C(11704190886730495817), UINT64_C(16410657665576399005)},
+                                         {/* 117*/ UINT64_C(14630238608413119772), UINT64_C(6678264026688335045)},
+                                         {/* 118*/ UINT64_C(18287798260516399715), UINT64_C(8347830033360418806)},
+                                         {/* 119*/ UINT64_C(11429873912822749822), UINT64_C(2911550761636567802)},
+                                         {/* 120*/ UINT64_C(14287342391028437277), UINT64_C(12862810488900485560)},
+                                         {/* 121*/ UINT64_C(17859177988785546597), UINT64_C(2243455055843443238)},
+                                         {/* 122*/ UINT64_C(11161986242990966623), UINT64_C(3708002419115845976)},
+                                         {/* 123*/ UINT64_C(13952482803738708279), UINT64_C(23317005467419566)},
+                                         {/* 124*/ UINT64_C(17440603504673385348), UINT64_C(13864204312116438170)},
+                                         {/* 125*/ UINT64_C(10900377190420865842), UINT64_C(17888499731927549664)},
+                                         {/* 126*/ UINT64_C(13625471488026082303), UINT64_C(13137252628054661272)},
+                                         {/* 127*/ UINT64_C(17031839360032602879), UINT64_C(11809879766640938686)},
+                                         {/* 128*/ UINT64_C(10644899600020376799), UINT64_C(14298703881791668535)},
+                                         {/* 129*/ UINT64_C(13306124500025470999), UINT64_C(13261693833812197764)},
+                                         {/* 130*/ UINT64_C(16632655625031838749), UINT64_C(11965431273837859301)},
+                                         {/* 131*/ UINT64_C(10395409765644899218), UINT64_C(9784237555362356015)},
+                                         {/* 132*/ UINT64_C(12994262207056124023), UINT64_C(3006924907348169211)},
+                                         {/* 133*/ UINT64_C(16242827758820155028), UINT64_C(17593714189467375226)},
+                                         {/* 134*/ UINT64_C(10151767349262596893), UINT64_C(1772699331562333708)},
+                                         {/* 135*/ UINT64_C(12689709186578246116), UINT64_C(6827560182880305039)},
+                                         {/* 136*/ UINT64_C(15862136483222807645), UINT64_C(8534450228600381299)},
+                                         {/* 137*/ UINT64_C(9913835302014254778), UINT64_C(7639874402088932264)},
+                                         {/* 138*/ UINT64_C(12392294127517818473), UINT64_C(326470965756389522)},
+                                         {/* 139*/ UINT64_C(15490367659397273091), UINT64_C(5019774725622874806)},
+                                         {/* 140*/ UINT64_C(9681479787123295682), UINT64_C(831516194300602802)},
+                                         {/* 141*/ UINT64_C(12101849733904119602), UINT64_C(10262767279730529310)},
+                                         {/* 142*/ UINT64_C(15127312167380149503), UINT64_C(3605087062808385830)},
+                                         {/* 143*/ UINT64_C(9454570104612593439), UINT64_C(9170708441896323000)},
+                                         {/* 144*/ UINT64_C(11818212630765741799), UINT64_C(6851699533943015846)},
+                                         {/* 145*/ UINT64_C(14772765788457177249), UINT64_C(3952938399001381903)},
+                                         {/* 146*/ UINT64_C(9232978617785735780), UINT64_C(13999801545444333449)},
+                                         {/* 147*/ UINT64_C(11541223272232169725), UINT64_C(17499751931805416812)},
+                                         {/* 148*/ UINT64_C(14426529090290212157), UINT64_C(8039631859474607303)},
+                                         {/* 149*/ UINT64_C(18033161362862765196), UINT64_C(14661225842770647033)},
+                                         {/* 150*/ UINT64_C(11270725851789228247), UINT64_C(18386638188586430203)},
+                                         {/* 151*/ UINT64_C(14088407314736535309), UINT64_C(18371611717305649850)},
+                                         {/* 152*/ UINT64_C(17610509143420669137), UINT64_C(9129456591349898601)},
+                                         {/* 153*/ UINT64_C(11006568214637918210), UINT64_C(17235125415662156385)},
+                                         {/* 154*/ UINT64_C(13758210268297397763), UINT64_C(12320534732722919674)},
+                                         {/* 155*/ UINT64_C(17197762835371747204), UINT64_C(10788982397476261688)},
+                                         {/* 156*/ UINT64_C(10748601772107342002), UINT64_C(15966486035277439363)},
+                                         {/* 157*/ UINT64_C(13435752215134177503), UINT64_C(10734735507242023396)},
+                                         {/* 158*/ UINT64_C(16794690268917721879), UINT64_C(8806733365625141341)},
+                                         {/* 159*/ UINT64_C(10496681418073576174), UINT64_C(12421737381156795194)},
+                                         {/* 160*/ UINT64_C(13120851772591970218), UINT64_C(6303799689591218185)},
+                                         {/* 161*/ UINT64_C(16401064715739962772), UINT64_C(17103121648843798539)},
+                                         {/* 162*/ UINT64_C(10250665447337476733), UINT64_C(1466078993672598279)},
+                                         {/* 163*/ UINT64_C(12813331809171845916), UINT64_C(6444284760518135752)},
+                                         {/* 164*/ UINT64_C(16016664761464807395), UINT64_C(8055355950647669691)},
+                                         {/* 165*/ UINT64_C(10010415475915504622), UINT64_C(2728754459941099604)},
+                                         {/* 166*/ UINT64_C(12513019344894380777), UINT64_C(12634315111781150314)},
+                                         {/* 167*/ UINT64_C(15641274181117975972), UINT64_C(1957835834444274180)},
+                                         {/* 168*/ UINT64_C(9775796363198734982), UINT64_C(10447019433382447170)},
+                                         {/* 169*/ UINT64_C(12219745453998418728), UINT64_C(3835402254873283155)},
+                                         {/* 170*/ UINT64_C(15274681817498023410), UINT64_C(4794252818591603944)},
+                                         {/* 171*/ UINT64_C(9546676135936264631), UINT64_C(7608094030047140369)},
+                                         {/* 172*/ UINT64_C(11933345169920330789), UINT64_C(4898431519131537557)},
+                                         {/* 173*/ UINT64_C(14916681462400413486), UINT64_C(10734725417341809851)},
+                                         {/* 174*/ UINT64_C(9322925914000258429), UINT64_C(2097517367411243253)},
+                                         {/* 175*/ UINT64_C(11653657392500323036), UINT64_C(7233582727691441970)},
+                                         {/* 176*/ UINT64_C(14567071740625403795), UINT64_C(9041978409614302462)},
+                                         {/* 177*/ UINT64_C(18208839675781754744), UINT64_C(6690786993590490174)},
+                                         {/* 178*/ UINT64_C(11380524797363596715), UINT64_C(4181741870994056359)},
+                                         {/* 179*/ UINT64_C(14225655996704495894), UINT64_C(615491320315182544)},
+                                         {/* 180*/ UINT64_C(17782069995880619867), UINT64_C(9992736187248753989)},
+                                         {/* 181*/ UINT64_C(11113793747425387417), UINT64_C(3939617107816777291)},
+                                         {/* 182*/ UINT64_C(13892242184281734271), UINT64_C(9536207403198359517)},
+                                         {/* 183*/ UINT64_C(17365302730352167839), UINT64_C(7308573235570561493)},
+                                         {/* 184*/ UINT64_C(10853314206470104899), UINT64_C(11485387299872682789)},
+                                         {/* 185*/ UINT64_C(13566642758087631124), UINT64_C(9745048106413465582)},
+                                         {/* 186*/ UINT64_C(16958303447609538905), UINT64_C(12181310133016831978)},
+                                         {/* 187*/ UINT64_C(10598939654755961816), UINT64_C(695789805494438130)},
+                                         {/* 188*/ UINT64_C(13248674568444952270), UINT64_C(869737256868047663)},
+                                         {/* 189*/ UINT64_C(16560843210556190337), UINT64_C(10310543607939835386)},
+                                         {/* 190*/ UINT64_C(10350527006597618960), UINT64_C(17973304801030866876)},
+                                         {/* 191*/ UINT64_C(12938158758247023701), UINT64_C(4019886927579031980)},
+                                         {/* 192*/ UINT64_C(16172698447808779626), UINT64_C(9636544677901177879)},
+                                         {/* 193*/ UINT64_C(10107936529880487266), UINT64_C(10634526442115624078)},
+                                         {/* 194*/ UINT64_C(12634920662350609083), UINT64_C(4069786015789754290)},
+                                         {/* 195*/ UINT64_C(15793650827938261354), UINT64_C(475546501309804958)},
+                                         {/* 196*/ UINT64_C(9871031767461413346), UINT64_C(4908902581746016003)},
+                                         {/* 197*/ UINT64_C(12338789709326766682), UINT64_C(15359500264037295811)},
+                                         {/* 198*/ UINT64_C(15423487136658458353), UINT64_C(9976003293191843956)},
+                                         {/* 199*/ UINT64_C(9639679460411536470), UINT64_C(17764217104313372233)},
+                                         {/* 200*/ UINT64_C(12049599325514420588), UINT64_C(12981899343536939483)},
+                                         {/* 201*/ UINT64_C(15061999156893025735), UINT64_C(16227374179421174354)},
+                                         {/* 202*/ UINT64_C(9413749473058141084), UINT64_C(17059637889779315827)},
+                                         {/* 203*/ UINT64_C(11767186841322676356), UINT64_C(2877803288514593168)},
+                                         {/* 204*/ UINT64_C(14708983551653345445), UINT64_C(3597254110643241460)},
+                                         {/* 205*/ UINT64_C(18386229439566681806), UINT64_C(9108253656731439729)},
+                                         {/* 206*/ UINT64_C(11491393399729176129), UINT64_C(1080972517029761926)},
+                                         {/* 207*/ UINT64_C(14364241749661470161), UINT64_C(5962901664714590312)},
+                                         {/* 208*/ UINT64_C(17955302187076837701), UINT64_C(12065313099320625794)},
+                                         {/* 209*/ UINT64_C(11222063866923023563), UINT64_C(9846663696289085073)},
+                                         {/* 210*/ UINT64_C(14027579833653779454), UINT64_C(7696643601933968437)},
+                                         {/* 211*/ UINT64_C(17534474792067224318), UINT64_C(397432465562684739)},
+                                         {/* 212*/ UINT64_C(10959046745042015198), UINT64_C(14083453346258841674)},
+                                         {/* 213*/ UINT64_C(13698808431302518998), UINT64_C(8380944645968776284)},
+                                         {/* 214*/ UINT64_C(17123510539128148748), UINT64_C(1252808770606194547)},
+                                         {/* 215*/ UINT64_C(10702194086955092967), UINT64_C(10006377518483647400)},
+                                         {/* 216*/ UINT64_C(13377742608693866209), UINT64_C(7896285879677171346)},
+                                         {/* 217*/ UINT64_C(16722178260867332761), UINT64_C(14482043368023852087)},
+                                         {/* 218*/ UINT64_C(10451361413042082976), UINT64_C(2133748077373825698)},
+                                         {/* 219*/ UINT64_C(13064201766302603720), UINT64_C(2667185096717282123)},
+                                         {/* 220*/ UINT64_C(16330252207878254650), UINT64_C(3333981370896602653)},
+                                         {/* 221*/ UINT64_C(10206407629923909156), UINT64_C(6695424375237764562)},
+                                         {/* 222*/ UINT64_C(12758009537404886445), UINT64_C(8369280469047205703)},
+                                         {/* 223*/ UINT64_C(15947511921756108056), UINT64_C(15073286604736395033)},
+                                         {/* 224*/ UINT64_C(9967194951097567535), UINT64_C(9420804127960246895)},
+                                         {/* 225*/ UINT64_C(12458993688871959419), UINT64_C(7164319141522920715)},
+                                         {/* 226*/ UINT64_C(15573742111089949274), UINT64_C(4343712908476262990)},
+                                         {/* 227*/ UINT64_C(9733588819431218296), UINT64_C(7326506586225052273)},
+                                         {/* 228*/ UINT64_C(12166986024289022870), UINT64_C(9158133232781315341)},
+                                         {/* 229*/ UINT64_C(15208732530361278588), UINT64_C(2224294504121868368)},
+                                         {/* 230*/ UINT64_C(9505457831475799117), UINT64_C(10613556101930943538)},
+                                         {/* 231*/ UINT64_C(11881822289344748896), UINT64_C(17878631145841067327)},
+                                         {/* 232*/ UINT64_C(14852277861680936121), UINT64_C(3901544858591782542)},
+                                         {/* 233*/ UINT64_C(9282673663550585075), UINT64_C(13967680582688333849)},
+                                         {/* 234*/ UINT64_C(11603342079438231344), UINT64_C(12847914709933029407)},
+                                         {/* 235*/ UINT64_C(14504177599297789180), UINT64_C(16059893387416286759)},
+                                         {/* 236*/ UINT64_C(18130221999122236476), UINT64_C(1628122660560806833)},
+                                         {/* 237*/ UINT64_C(11331388749451397797), UINT64_C(10240948699705280078)},
+                                         {/* 238*/ UINT64_C(14164235936814247246), UINT64_C(17412871893058988002)},
+                                         {/* 239*/ UINT64_C(17705294921017809058), UINT64_C(12542717829468959195)},
+                                         {/* 240*/ UINT64_C(11065809325636130661), UINT64_C(12450884661845487401)},
+                                         {/* 241*/ UINT64_C(13832261657045163327), UINT64_C(1728547772024695539)},
+                                         {/* 242*/ UINT64_C(17290327071306454158), UINT64_C(15995742770313033136)},
+                                         {/* 243*/ UINT64_C(10806454419566533849), UINT64_C(5385653213018257806)},
+                                         {/* 244*/ UINT64_C(13508068024458167311), UINT64_C(11343752534700210161)},
+                                         {/* 245*/ UINT64_C(16885085030572709139), UINT64_C(9568004649947874797)},
+                                         {/* 246*/ UINT64_C(10553178144107943212), UINT64_C(3674159897003727796)},
+                                         {/* 247*/ UINT64_C(13191472680134929015), UINT64_C(4592699871254659745)},
+                                         {/* 248*/ UINT64_C(16489340850168661269), UINT64_C(1129188820640936778)},
+                                         {/* 249*/ UINT64_C(10305838031355413293), UINT64_C(3011586022114279438)},
+                                         {/* 250*/ UINT64_C(12882297539194266616), UINT64_C(8376168546070237202)},
+                                         {/* 251*/ UINT64_C(16102871923992833270), UINT64_C(10470210682587796502)},
+                                         {/* 252*/ UINT64_C(10064294952495520794), UINT64_C(1932195658189984910)},
+                                         {/* 253*/ UINT64_C(12580368690619400992), UINT64_C(11638616609592256945)},
+                                         {/* 254*/ UINT64_C(15725460863274251240), UINT64_C(14548270761990321182)},
+                                         {/* 255*/ UINT64_C(9828413039546407025), UINT64_C(9092669226243950738)},
+                                         {/* 256*/ UINT64_C(12285516299433008781), UINT64_C(15977522551232326327)},
+                                         {/* 257*/ UINT64_C(15356895374291260977), UINT64_C(6136845133758244197)},
+                                         {/* 258*/ UINT64_C(9598059608932038110), UINT64_C(15364743254667372383)},
+                                         {/* 259*/ UINT64_C(11997574511165047638), UINT64_C(9982557031479439671)},
+                                         {/* 260*/ UINT64_C(14996968138956309548), UINT64_C(3254824252494523781)},
+                                         {/* 261*/ UINT64_C(9373105086847693467), UINT64_C(11257637194663853171)},
+                                         {/* 262*/ UINT64_C(11716381358559616834), UINT64_C(9460360474902428559)},
+                                         {/* 263*/ UINT64_C(14645476698199521043), UINT64_C(2602078556773259891)},
+                                         {/* 264*/ UINT64_C(18306845872749401303), UINT64_C(17087656251248738576)},
+                                         {/* 265*/ UINT64_C(11441778670468375814), UINT64_C(17597314184671543466)},
+                                         {/* 266*/ UINT64_C(14302223338085469768), UINT64_C(12773270693984653525)},
+                                         {/* 267*/ UINT64_C(17877779172606837210), UINT64_C(15966588367480816906)},
+                                         {/* 268*/ UINT64_C(11173611982879273256), UINT64_C(14590803748102898470)},
+                                         {/* 269*/ UINT64_C(13967014978599091570), UINT64_C(18238504685128623088)},
+                                         {/* 270*/ UINT64_C(17458768723248864463), UINT64_C(13574758819556003052)},
+                                         {/* 271*/ UINT64_C(10911730452030540289), UINT64_C(15401753289863583763)},
+                                         {/* 272*/ UINT64_C(13639663065038175362), UINT64_C(5417133557047315992)},
+                                         {/* 273*/ UINT64_C(17049578831297719202), UINT64_C(15994788983163920798)},
+                                         {/* 274*/ UINT64_C(10655986769561074501), UINT64_C(14608429132904838403)},
+                                         {/* 275*/ UINT64_C(13319983461951343127), UINT64_C(4425478360848884291)},
+                                         {/* 276*/ UINT64_C(16649979327439178909), UINT64_C(920161932633717460)},
+                                         {/* 277*/ UINT64_C(10406237079649486818), UINT64_C(2880944217109767365)},
+                                         {/* 278*/ UINT64_C(13007796349561858522), UINT64_C(12824552308241985014)},
+                                         {/* 279*/ UINT64_C(16259745436952323153), UINT64_C(6807318348447705459)},
+                                         {/* 280*/ UINT64_C(10162340898095201970), UINT64_C(15783789013848285672)},
+                                         {/* 281*/ UINT64_C(12702926122619002463), UINT64_C(10506364230455581282)},
+                                         {/* 282*/ UINT64_C(15878657653273753079), UINT64_C(8521269269642088699)},
+                                         {/* 283*/ UINT64_C(9924161033296095674), UINT64_C(12243322321167387293)},
+                                         {/* 284*/ UINT64_C(12405201291620119593), UINT64_C(6080780864604458308)},
+                                         {/* 285*/ UINT64_C(15506501614525149491), UINT64_C(12212662099182960789)},
+                                         {/* 286*/ UINT64_C(9691563509078218432), UINT64_C(5327070802775656541)},
+                                         {/* 287*/ UINT64_C(12114454386347773040), UINT64_C(6658838503469570676)},
+                                         {/* 288*/ UINT64_C(15143067982934716300), UINT64_C(8323548129336963345)},
+                                         {/* 289*/ UINT64_C(9464417489334197687), UINT64_C(14425589617690377899)},
+                                         {/* 290*/ UINT64_C(11830521861667747109), UINT64_C(13420301003685584469)},
+                                         {/* 291*/ UINT64_C(14788152327084683887), UINT64_C(2940318199324816875)},
+                                         {/* 292*/ UINT64_C(9242595204427927429), UINT64_C(8755227902219092403)},
+                                         {/* 293*/ UINT64_C(11553244005534909286), UINT64_C(15555720896201253407)},
+                                         {/* 294*/ UINT64_C(14441555006918636608), UINT64_C(10221279083396790951)},
+                                         {/* 295*/ UINT64_C(18051943758648295760), UINT64_C(12776598854245988689)},
+                                         {/* 296*/ UINT64_C(11282464849155184850), UINT64_C(7985374283903742931)},
+                                         {/* 297*/ UINT64_C(14103081061443981063), UINT64_C(758345818024902856)},
+                                         {/* 298*/ UINT64_C(17628851326804976328), UINT64_C(14782990327813292282)},
+                                         {/* 299*/ UINT64_C(11018032079253110205), UINT64_C(9239368954883307676)},
+                                         {/* 300*/ UINT64_C(13772540099066387756), UINT64_C(16160897212031522499)},
+                                         {/* 301*/ UINT64_C(17215675123832984696), UINT64_C(1754377441329851508)},
+                                         {/* 302*/ UINT64_C(10759796952395615435), UINT64_C(1096485900831157192)},
+                                         {/* 303*/ UINT64_C(13449746190494519293), UINT64_C(15205665431321110202)},
+                                         {/* 304*/ UINT64_C(16812182738118149117), UINT64_C(5172023733869224041)},
+                                         {/* 305*/ UINT64_C(10507614211323843198), UINT64_C(5538357842881958977)},
+                                         {/* 306*/ UINT64_C(13134517764154803997), UINT64_C(16146319340457224530)},
+                                         {/* 307*/ UINT64_C(16418147205193504997), UINT64_C(6347841120289366950)},
+                                         {/* 308*/ UINT64_C(10261342003245940623), UINT64_C(6273243709394548296)}};
+  return data[q + 342];
+}
+
+static inline void full_multiplication(uint64_t a, uint64_t b, uint64_t &high, uint64_t &low)
+{
+#if defined(__SIZEOF_INT128__)
+  __extension__ typedef unsigned __int128 uint128;
+  uint128 product = uint128(a) * b;
+  high = uint64_t(product >> 64);
+  low = uint64_t(product);
+#elif defined(_MSC_VER) && defined(_M_X64)
+  low = _umul128(a, b, &high);
+#else
+  uint64_t a_low = mask32(a), a_high = a >> 32;
+  uint64_t b_low = mask32(b), b_high = b >> 32;
+  uint64_t low_low = a_low * b_low;
+  uint64_t high_low = a_high * b_low;
+  uint64_t low_high = a_low * b_high;
+  uint64_t middle = high_low + (low_low >> 32) + mask32(low_high);
+  high = a_high * b_high + (middle >> 32) + (low_high >> 32);
+  low = (middle << 32) | mask32(low_low);
+#endif
 }
 
-template <typename T, typename SignificandType>
-inline T convertToNumber(const parsed_string<SignificandType> &parsed)
+/* A float as its stored mantissa, without the implicit bit, and its biased
+ * binary exponent. */
+struct binary_float
 {
-  int base10exponent = parsed.exp + parsed.significand_digit_count - 1;
-  if (base10exponent > float_info<T>::max_base10_exponent())
+  uint64_t mantissa;
+  int exponent;
+};
+
+/* Eisel-Lemire: computes the correctly rounded binary_float closest to
+ * w * 10^q from a single, rarely two, 64 by 64 bit multiplication with the
+ * truncated power of five. */
+template <typename T>
+inline binary_float eisel_lemire(int q, uint64_t w)
+{
+  using info = float_info<T>;
+  binary_float answer;
+  answer.mantissa = 0;
+  answer.exponent = 0;
+  if (w == 0 || q < info::smallest_power_of_ten())
+    return answer;
+  if (q > info::largest_power_of_ten())
   {
-    return make_inf<T>(parsed.negative);
+    answer.exponent = (1 << info::exponent_width()) - 1;
+    return answer;
   }
-  else if (base10exponent < float_info<T>::min_base10_exponent())
+
+  int leading_zeros = 63 - bit_scan_reverse(w);
+  w <<= leading_zeros;
+  const uint64_t *power = power_of_five_128(q);
+  uint64_t high, low;
+  full_multiplication(w, power[0], high, low);
+  const uint64_t precision_mask = ~uint64_t(0) >> (info::mentissa_width() + 3);
+  if ((high & precision_mask) == precision_mask)
   {
-    return make_zero<T>(parsed.negative);
+    uint64_t second_high, second_low;
+    full_multiplication(w, power[1], second_high, second_low);
+    low += second_high;
+    if (second_high > low)
+      high++;
   }
-  if (parsed.significand == 0)
+
+  int upper_bit = int(high >> 63);
+  int shift = upper_bit + 64 - info::mentissa_width() - 3;
+  answer.mantissa = high >> shift;
+  answer.exponent = (((152170 + 65536) * q) >> 16) + 63 + upper_bit - leading_zeros + info::bias();
+  if (answer.exponent <= 0)
   {
-    return make_zero<T>(parsed.negative);
+    if (-answer.exponent + 1 >= 64)
+    {
+      answer.mantissa = 0;
+      answer.exponent = 0;
+      return answer;
+    }
+    answer.mantissa >>= -answer.exponent + 1;
+    answer.mantissa += answer.mantissa & 1;
+    answer.mantissa >>= 1;
+    answer.exponent = answer.mantissa < (uint64_t(1) << info::mentissa_width()) ? 0 : 1;
+    answer.mantissa &= ~(uint64_t(1) << info::mentissa_width());
+    return answer;
   }
 
-#if 1
-  if (parsed.significand < ((uint64_t(1) << 53)) && iabs<int>(parsed.exp) < count_chars((uint64_t(1) << 53)))
+  // A product that is exactly between two floats has to round to even.
+  if (low <= 1 && q >= info::min_exponent_round_to_even() && q <= info::max_exponent_round_to_even() &&
+      (answer.mantissa & 3) == 1 && (answer.mantissa << shift) == high)
   {
-    double ds(double(parsed.significand));
-    double de(double(getPow10(iabs<int>(parsed.exp))));
-    if (parsed.negative)
-      ds = -ds;
-    return parsed.exp < 0 ? T(ds / de) : T(ds * de);
+    answer.mantissa &= ~uint64_t(1);
+  }
+  answer.mantissa += answer.mantissa & 1;
+  answer.mantissa >>= 1;
+  if (answer.mantissa >= (uint64_t(2) << info::mentissa_width()))
+  {
+    answer.mantissa = uint64_t(1) << info::mentissa_width();
+    answer.exponent++;
+  }
+  answer.mantissa &= ~(uint64_t(1) << info::mentissa_width());
+  if (answer.exponent >= (1 << info::exponent_width()) - 1)
+  {
+    answer.mantissa = 0;
+    answer.exponent = (1 << info::exponent_width()) - 1;
+  }
+  return answer;
+}
+
+template <typename T>
+inline T make_float(const binary_float &value, bool negative)
+{
+  using uint_ft = typename float_info<T>::uint_alias;
+  uint_ft bits = uint_ft(value.mantissa) | (uint_ft(value.exponent) << float_info<T>::mentissa_width()) |
+                 (uint_ft(negative) << ((sizeof(T) * 8) - 1));
+  T ret;
+  memcpy(&ret, &bits, sizeof(ret));
+  return ret;
+}
+
+/* Just enough of an unsigned big integer to compare a decimal string with
+ * the point halfway between two floats. */
+struct big_integer
+{
+  std::vector<uint32_t> limbs;
+
+  void multiply(uint32_t factor, uint32_t add = 0)
+  {
+    uint64_t carry = add;
+    for (auto &limb : limbs)
+    {
+      uint64_t product = uint64_t(limb) * factor + carry;
+      limb = uint32_t(product);
+      carry = product >> 32;
+    }
+    if (carry)
+      limbs.push_back(uint32_t(carry));
+  }
+
+  void multiply_pow5(int exponent)
+  {
+    for (; exponent >= 13; exponent -= 13)
+      multiply(1220703125);
+    uint32_t factor = 1;
+    for (; exponent > 0; exponent--)
+      factor *= 5;
+    multiply(factor);
+  }
+
+  void shift_left(int bits)
+  {
+    if (limbs.empty())
+      return;
+    int words = bits / 32;
+    bits %= 32;
+    if (bits)
+    {
+      uint32_t carry = 0;
+      for (auto &limb : limbs)
+      {
+        uint32_t next = limb >> (32 - bits);
+        limb = (limb << bits) | carry;
+        carry = next;
+      }
+      if (carry)
+        limbs.push_back(carry);
+    }
+    limbs.insert(limbs.begin(), size_t(words), uint32_t(0));
   }
-#endif
 
-  using uint_conversion_type = typename float_info<T>::str_to_float_conversion_type;
-  uint_conversion_type a;
-  uint_conversion_type b;
-  assign_significand_to_float_conversion_type(parsed, a);
-  int desimal_exponent = parsed.exp;
-  auto binary_exponent = float_info<T>::str_to_float_binary_exponent_init();
-  for (; desimal_exponent > 0; desimal_exponent--)
+  int compare(const big_integer &other) const
   {
-    left_shift(a);
-    copy_conversion_type(a, b);
-    left_shift<2>(b);
-    add(b, a);
+    if (limbs.size() != other.limbs.size())
+      return limbs.size() < other.limbs.size() ? -1 : 1;
+    for (size_t i = limbs.size(); i > 0; i--)
+    {
+      if (limbs[i - 1] != other.limbs[i - 1])
+        return limbs[i - 1] < other.limbs[i - 1] ? -1 : 1;
+    }
+    return 0;
+  }
+};
+
+/* Settles a conversion where the digits dropped from the significand decide
+ * between lower and upper, the next float up, by comparing all the digits of
+ * the number with the point halfway between them. */
+template <typename T>
+inline binary_float round_by_digit_comparison(const char *number, const char *number_end, const binary_float &lower,
+                                              const binary_float &upper)
+{
+  // The halfway point between two doubles has at most 767 significant digits.
+  const int max_digits = 800;
+  big_integer digits;
+  int digit_count = 0;
+  int exponent = 0;
+  bool seen_decimal_point = false;
+  bool sticky = false;
 
-    while (float_info<T>::conversion_type_has_mask(a))
+  const char *current = find_if(number, number_end, [](const char a) { return !is_space(a); });
+  if (current < number_end && *current == '-')
+    current++;
+  for (; current < number_end; current++)
+  {
+    if (*current == '.')
+    {
+      seen_decimal_point = true;
+      continue;
+    }
+    if (*current < '0' || *current > '9')
+      break;
+    if (digit_count == 0 && *current == '0')
+    {
+      if (seen_decimal_point)
+        exponent--;
+    }
+    else if (digit_count < max_digits)
+    {
+      if (digits.limbs.empty())
+        digits.limbs.push_back(uint32_t(*current - '0'));
+      else
+        digits.multiply(10, uint32_t(*current - '0'));
+      digit_count++;
+      if (seen_decimal_point)
+        exponent--;
+    }
+    else
     {
-      right_shift(a);
-      binary_exponent++;
+      sticky |= *current != '0';
+      if (!seen_decimal_point)
+        exponent++;
     }
   }
+  if (current < number_end && (*current == 'e' || *current == 'E'))
+  {
+    current++;
+    bool negative_exponent = current < number_end && *current == '-';
+    if (current < number_end && (*current == '-' || *current == '+'))
+      current++;
+    int written_exponent = 0;
+    for (; current < number_end && *current >= '0' && *current <= '9'; current++)
+    {
+      if (written_exponent < 100000)
+        written_exponent = written_exponent * 10 + (*current - '0');
+    }
+    exponent += negative_exponent ? -written_exponent : written_exponent;
+  }
 
-  for (; desimal_exponent < 0; desimal_exponent++)
+  // Compare digits * 10^exponent with (2 * mantissa + 1) * 2^(binary_exponent - 1).
+  uint64_t mantissa = lower.mantissa;
+  int binary_exponent = 1 - float_info<T>::bias() - float_info<T>::mentissa_width();
+  if (lower.exponent > 0)
   {
-    binary_exponent -= float_info<T>::shift_left_msb_to_index(a, float_info<T>::str_to_float_binary_exponent_init());
+    mantissa |= uint64_t(1) << float_info<T>::mentissa_width();
+    binary_exponent += lower.exponent - 1;
+  }
+  big_integer halfway;
+  uint64_t halfway_significand = 2 * mantissa + 1;
+  halfway.limbs.push_back(uint32_t(halfway_significand));
+  if (halfway_significand >> 32)
+    halfway.limbs.push_back(uint32_t(halfway_significand >> 32));
+
+  if (exponent >= 0)
+    digits.multiply_pow5(exponent);
+  else
+    halfway.multiply_pow5(-exponent);
+  int shift = binary_exponent - 1 - exponent;
+  if (shift >= 0)
+    halfway.shift_left(shift);
+  else
+    digits.shift_left(-shift);
 
-    divide_by_10(a);
-  }
+  int order = digits.compare(halfway);
+  if (order < 0)
+    return lower;
+  if (order > 0 || sticky)
+    return upper;
+  return lower.mantissa & 1 ? upper : lower;
+}
 
-  binary_exponent -= float_info<T>::shift_left_msb_to_index(a, float_info<T>::str_to_float_binary_exponent_init());
+/* Converts a parsed number to the closest T. Numbers with few digits and a
+ * small exponent are computed exactly with one floating point operation, the
+ * rest with Eisel-Lemire. Only when digits were dropped from the significand
+ * and they change the result is the whole number string compared digit by
+ * digit. */
+template <typename T>
+inline T convertToNumber(const parsed_string<uint64_t> &parsed, const char *number, const char *number_end)
+{
+  if (parsed.significand == 0)
+    return make_zero<T>(parsed.negative);
 
-  binary_exponent += float_info<T>::bias();
-  T to_digit;
-  if (binary_exponent <= 0)
-  {
-    float_info<T>::copy_denormal_to_type(a, binary_exponent, parsed.negative, to_digit);
-  }
-  else if (binary_exponent < (int(1) << float_info<T>::exponent_width()) - 1)
+  if (!parsed.truncated && parsed.significand <= (uint64_t(1) << (float_info<T>::mentissa_width() + 1)) &&
+      iabs<int>(parsed.exp) <= float_info<T>::max_exact_power_of_ten())
   {
-    float_info<T>::copy_normal_to_type(a, binary_exponent, parsed.negative, to_digit);
+    static const double exact_powers_of_ten[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,
+                                                 1e8,  1e9,  1e10, 1e11, 1e12, 1e13, 1e14, 1e15,
+                                                 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+    T value = T(parsed.significand);
+    T power = T(exact_powers_of_ten[iabs<int>(parsed.exp)]);
+    value = parsed.exp < 0 ? value / power : value * power;
+    return parsed.negative ? -value : value;
   }
-  else
+
+  binary_float result = eisel_lemire<T>(parsed.exp, parsed.significand);
+  if (parsed.truncated)
   {
-    to_digit = make_inf<T>(parsed.negative);
+    binary_float upper = eisel_lemire<T>(parsed.exp, parsed.significand + 1);
+    if (upper.mantissa != result.mantissa || upper.exponent != result.exponent)
+      result = round_by_digit_comparison<T>(number, number_end, result, upper);
   }
-  return to_digit;
+  return make_float<T>(result, parsed.negative);
 }
 
 namespace ryu
@@ -6931,117 +10277,394 @@ inline std::string to_string(T f)
 
 namespace integer
 {
+inline const char *digit_pairs()
+{
+  static const char pairs[] = "00010203040506070809"
+                              "10111213141516171819"
+                              "20212223242526272829"
+                              "30313233343536373839"
+                              "40414243444546474849"
+                              "50515253545556575859"
+                              "60616263646566676869"
+                              "70717273747576777879"
+                              "80818283848586878889"
+                              "90919293949596979899";
+  return pairs;
+}
+
+/* Writes exactly eight digits, with leading zeros, of a value below 10^8.
+ * On little endian targets all eight digits are split out in parallel in one
+ * 64 bit register. */
+#if defined(_MSC_VER) || (defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+#define JS_INTEGER_SWAR_DIGITS 1
+static inline uint64_t eight_digits_register(uint32_t value)
+{
+  uint64_t merged = uint64_t(value / 10000) | (uint64_t(value % 10000) << 32);
+  uint64_t divided = ((merged * 10486) >> 20) & ((uint64_t(0x7F) << 32) | 0x7F);
+  merged = divided | ((merged - 100 * divided) << 16);
+  divided = ((merged * 103) >> 10) & ((uint64_t(0xF) << 48) | (uint64_t(0xF) << 32) | (uint64_t(0xF) << 16) | 0xF);
+  merged = divided | ((merged - 10 * divided) << 8);
+  return merged + UINT64_C(0x3030303030303030);
+}
+#endif
+
+static inline void write_eight_digits(uint32_t value, char *out)
+{
+#ifdef JS_INTEGER_SWAR_DIGITS
+  uint64_t merged = eight_digits_register(value);
+  memcpy(out, &merged, sizeof(merged));
+#else
+  const char *pairs = digit_pairs();
+  uint32_t high = value / 10000;
+  uint32_t low = value % 10000;
+  memcpy(out, pairs + (high / 100) * 2, 2);
+  memcpy(out + 2, pairs + (high % 100) * 2, 2);
+  memcpy(out + 4, pairs + (low / 100) * 2, 2);
+  memcpy(out + 6, pairs + (low % 100) * 2, 2);
+#endif
+}
+
+/* Counts digits without branching on the length, which is unpredictable in
+ * arrays of mixed magnitudes. 1233 / 4096 approximates log10(2). */
+static inline int count_digits_below_10e8(uint32_t value)
+{
+  static const uint32_t powers[] = {1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000};
+  value |= 1;
+  int log10 = ((bit_scan_reverse(value) + 1) * 1233) >> 12;
+  return log10 + int(value >= powers[log10]);
+}
+
+/* Writes the digits of a value below 10^8 into out, two digits per step. */
+static inline void write_leading_digits(uint32_t value, int digits, char *out)
+{
+  const char *pairs = digit_pairs();
+  char *end = out + digits;
+  while (value >= 100)
+  {
+    end -= 2;
+    memcpy(end, pairs + (value % 100) * 2, 2);
+    value /= 100;
+  }
+  if (value >= 10)
+    memcpy(out, pairs + value * 2, 2);
+  else
+    *out = char('0' + value);
+}
+
+/* An unsigned integer split into a leading value below 10^8 and groups of
+ * exactly eight digits, least significant group first. */
+struct decimal_groups
+{
+  uint32_t leading;
+  uint32_t groups[5];
+  int group_count;
+  int leading_digits;
+
+  int size() const
+  {
+    return leading_digits + group_count * 8;
+  }
+
+  void write(char *out) const
+  {
+    write_leading_digits(leading, leading_digits, out);
+    writeGroups(out + leading_digits);
+  }
+
+  // Like write, but out must have room for eight bytes even when fewer
+  // digits are written, so the leading digits are written as one word.
+  void writePadded(char *out) const
+  {
+#ifdef JS_INTEGER_SWAR_DIGITS
+    uint64_t digits = eight_digits_register(leading) >> (8 * (8 - leading_digits));
+    memcpy(out, &digits, sizeof(digits));
+#else
+    write_leading_digits(leading, leading_digits, out);
+#endif
+    writeGroups(out + leading_digits);
+  }
+
+  void writeGroups(char *out) const
+  {
+    for (int i = group_count; i > 0; i--, out += 8)
+      write_eight_digits(groups[i - 1], out);
+  }
+};
+
+template <typename U>
+inline decimal_groups split_decimal_groups(U value)
+{
+  using Wide = typename std::conditional<(sizeof(U) > sizeof(uint64_t)), U, uint64_t>::type;
+  Wide wide = value;
+  decimal_groups result;
+  result.group_count = 0;
+  while (wide >= 100000000)
+  {
+    result.groups[result.group_count++] = uint32_t(wide % 100000000);
+    wide /= 100000000;
+  }
+  result.leading = uint32_t(wide);
+  result.leading_digits = count_digits_below_10e8(result.leading);
+  return result;
+}
+
+/* The room write_integer needs: every digit and a sign, and at least the
+ * eight bytes plus sign of a padded leading write. */
+template <typename T>
+constexpr int max_chars()
+{
+  return std::numeric_limits<T>::digits10 + 2 > 9 ? std::numeric_limits<T>::digits10 + 2 : 9;
+}
+
+/* Writes integer into out, which must have room for max_chars<T>() bytes.
+ * Returns the number of characters written. */
+
+template <typename T>
+inline int write_integer(T integer, char *out)
+{
+  using Unsigned = typename std::make_unsigned<T>::type;
+  bool negative = std::is_signed<T>::value && integer < T(0);
+  *out = '-';
+  out += negative;
+  Unsigned magnitude = negative ? Unsigned(Unsigned(0) - Unsigned(integer)) : Unsigned(integer);
+  decimal_groups groups = split_decimal_groups(magnitude);
+  groups.writePadded(out);
+  return groups.size() + int(negative);
+}
+
 template <typename T>
 inline int to_buffer(T integer, char *buffer, int buffer_size, int *digits_truncated = nullptr)
 {
   static_assert(std::is_integral<T>::value, "Tryint to convert non int to string");
-  int chars_to_write = ft::count_chars(integer);
-  char *target_buffer = buffer;
+  using Unsigned = typename std::make_unsigned<T>::type;
   bool negative = false;
   if (std::is_signed<T>::value)
   {
     if (integer < 0)
-    {
-      target_buffer[0] = '-';
-      target_buffer++;
-      buffer_size--;
       negative = true;
-    }
+  }
+  Unsigned magnitude = negative ? Unsigned(Unsigned(0) - Unsigned(integer)) : Unsigned(integer);
+  decimal_groups groups = split_decimal_groups(magnitude);
+  int chars_to_write = groups.size();
+
+  char *target_buffer = buffer;
+  if (negative)
+  {
+    target_buffer[0] = '-';
+    target_buffer++;
+    buffer_size--;
   }
   int to_remove = chars_to_write - buffer_size;
   if (to_remove > 0)
   {
-    for (int i = 0; i < to_remove; i++)
-    {
-      integer /= 10;
-    }
+    char digits[48];
+    groups.write(digits);
+    chars_to_write = chars_to_write > to_remove ? chars_to_write - to_remove : 0;
+    memcpy(target_buffer, digits, size_t(chars_to_write));
     if (digits_truncated)
       *digits_truncated = to_remove;
-    chars_to_write -= to_remove;
+    return chars_to_write + negative;
   }
-  else if (digits_truncated)
+  if (digits_truncated)
     *digits_truncated = 0;
-
-  for (int i = 0; i < chars_to_write; i++)
-  {
-    int remainder = integer % 10;
-    if (std::is_signed<T>::value)
-    {
-      if (negative)
-        remainder = -remainder;
-    }
-    integer /= 10;
-    target_buffer[chars_to_write - 1 - i] = '0' + char(remainder);
-  }
-
+  if (buffer_size >= 8)
+    groups.writePadded(target_buffer);
+  else
+    groups.write(target_buffer);
   return chars_to_write + negative;
 }
 
-template <typename T, typename SignificandType>
-inline typename std::enable_if<std::is_signed<T>::value, T>::type make_integer_return_value(SignificandType significand,
-                                                                                            bool negative)
-{
-  return negative ? -T(significand) : T(significand);
-}
-
-template <typename T, typename SignificandType>
-inline typename std::enable_if<std::is_unsigned<T>::value, T>::type make_integer_return_value(
-  SignificandType significand, bool)
+/* Converts eight ASCII digits with a handful of 64 bit operations. Returns
+ * false if any of the eight characters is not a digit. */
+static inline bool parse_eight_digits(const char *str, uint32_t &value)
 {
-  return T(significand);
+#if defined(_MSC_VER) || (defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+  uint64_t chunk;
+  memcpy(&chunk, str, sizeof(chunk));
+  if (((chunk + 0x4646464646464646) | (chunk - 0x3030303030303030)) & 0x8080808080808080)
+    return false;
+  chunk -= 0x3030303030303030;
+  chunk = (chunk * 10) + (chunk >> 8);
+  chunk = (((chunk & 0x000000FF000000FF) * (100 + (uint64_t(1000000) << 32))) +
+           (((chunk >> 16) & 0x000000FF000000FF) * (1 + (uint64_t(10000) << 32)))) >>
+          32;
+  value = uint32_t(chunk);
+  return true;
+#else
+  uint32_t result = 0;
+  for (int i = 0; i < 8; i++)
+  {
+    uint32_t digit = uint32_t(uint8_t(str[i])) - '0';
+    if (digit > 9)
+      return false;
+    result = result * 10 + digit;
+  }
+  value = result;
+  return true;
+#endif
 }
 
-template <typename T, typename SignificandType>
-inline T convert_to_integer(const parsed_string<SignificandType> &parsed)
+/* Accumulates decimal digits into an integer wide enough for T and checks
+ * the result against the exact range of T. */
+template <typename T>
+struct IntegerAccumulator
 {
-  if (parsed.inf)
-    return parsed.negative ? std::numeric_limits<T>::min() : std::numeric_limits<T>::max();
-  if (parsed.nan)
-    return T(0);
+  using Unsigned = typename std::make_unsigned<T>::type;
+  using Accumulator = typename std::conditional<(sizeof(Unsigned) > sizeof(uint64_t)), Unsigned, uint64_t>::type;
 
-  int exp = parsed.exp;
-  auto significand = parsed.significand;
-  if (exp < 0)
+  void push(uint32_t digit)
   {
-    int chars_in_sig = count_chars(significand);
-    if (-exp >= chars_in_sig)
-      return T(0);
-    while (exp < 0)
+    if (value > Accumulator(~Accumulator(0)) / 10)
     {
-      significand /= 10;
-      exp++;
+      overflow = true;
+      return;
     }
+    value *= 10;
+    overflow |= value > Accumulator(~Accumulator(0)) - digit;
+    value += digit;
   }
-  else if (exp > 0)
+
+  void pushEight(uint32_t chunk)
   {
-    int chars_in_sig = count_chars(significand);
-    if (exp > ft::StaticLog10<T, std::numeric_limits<T>::max(), 0, 0, true>::get() - chars_in_sig)
-      return parsed.negative ? std::numeric_limits<T>::min() : std::numeric_limits<T>::max();
-    while (exp > 0)
+    if (value > Accumulator(~Accumulator(0)) / 100000000)
     {
-      significand *= 10;
-      exp--;
+      overflow = true;
+      return;
     }
+    value *= 100000000;
+    overflow |= value > Accumulator(~Accumulator(0)) - chunk;
+    value += chunk;
   }
-  return make_integer_return_value<T>(significand, bool(parsed.negative));
+
+  // A negative value only fits an unsigned T when it is zero.
+  parse_string_error assign(bool negative, T &target) const
+  {
+    const Accumulator unsigned_max = Accumulator(Unsigned(~Unsigned(0)));
+    Accumulator limit = unsigned_max;
+    if (std::is_signed<T>::value)
+      limit = (unsigned_max >> 1) + Accumulator(negative);
+    else if (negative)
+      limit = 0;
+    if (overflow || value > limit)
+      return parse_string_error::out_of_range;
+    target = negative && value ? T(-T(value - 1) - 1) : T(value);
+    return parse_string_error::ok;
+  }
+
+  Accumulator value = 0;
+  bool overflow = false;
+};
+
+/* Fast path for the common token form: an optional '-' followed by digits
+ * only. Returns invalid_format without touching target for anything else, so
+ * the caller can fall back to to_integer, and out_of_range if the value does
+ * not fit in T. */
+template <typename T>
+inline parse_string_error to_integer_plain(const char *str, size_t size, T &target)
+{
+  const char *current = str;
+  const char *end = str + size;
+  bool negative = current < end && *current == '-';
+  if (negative)
+  {
+    if (!std::is_signed<T>::value)
+      return parse_string_error::invalid_format;
+    current++;
+  }
+  if (current == end)
+    return parse_string_error::invalid_format;
+
+  IntegerAccumulator<T> accumulator;
+  while (end - current >= 8)
+  {
+    uint32_t chunk;
+    if (!parse_eight_digits(current, chunk))
+      break;
+    accumulator.pushEight(chunk);
+    current += 8;
+  }
+  for (; current < end; current++)
+  {
+    uint32_t digit = uint32_t(uint8_t(*current)) - '0';
+    if (digit > 9)
+      return parse_string_error::invalid_format;
+    accumulator.push(digit);
+  }
+  return accumulator.assign(negative, target);
 }
 
+/* Converts a number with a fraction and exponent to T, truncating the
+ * fraction toward zero. The integral part is taken from the digits exactly,
+ * and out_of_range is returned when it does not fit in T, which includes
+ * negative values for an unsigned T. */
 template <typename T>
 inline parse_string_error to_integer(const char *str, size_t size, T &target, const char *(&endptr))
 {
-  using SignificandType = typename std::make_unsigned<T>::type;
-  parsed_string<SignificandType> ps;
-  auto parseResult = parseNumber<SignificandType, true>(str, size, ps);
-  endptr = ps.endptr;
-  if (parseResult != parse_string_error::ok)
+  const char *current = str;
+  const char *end = str + size;
+  endptr = str;
+  target = 0;
+  while (current < end && is_space(*current))
+    current++;
+  if (current == end)
+    return parse_string_error::empty_string;
+  bool negative = *current == '-';
+  if (negative)
+    current++;
+
+  const char *integer_begin = current;
+  while (current < end && *current >= '0' && *current <= '9')
+    current++;
+  const size_t integer_digits = size_t(current - integer_begin);
+  const char *fraction_begin = current;
+  if (current < end && *current == '.')
   {
-    target = 0;
+    fraction_begin = ++current;
+    while (current < end && *current >= '0' && *current <= '9')
+      current++;
   }
-  else
+  const size_t fraction_digits = size_t(current - fraction_begin);
+  if (!integer_digits && !fraction_digits)
+    return parse_string_error::invalid_format;
+  if (current < end && *current == '.')
+    return parse_string_error::multiple_commas;
+
+  int64_t exponent = 0;
+  if (current < end && (*current == 'e' || *current == 'E'))
   {
-    target = convert_to_integer<T>(ps);
+    current++;
+    bool exponent_negative = current < end && *current == '-';
+    if (current < end && (*current == '-' || *current == '+'))
+      current++;
+    if (current == end || *current < '0' || *current > '9')
+      return parse_string_error::illegal_exponent_value;
+    for (; current < end && *current >= '0' && *current <= '9'; current++)
+    {
+      if (exponent < 100000)
+        exponent = exponent * 10 + (*current - '0');
+    }
+    if (exponent_negative)
+      exponent = -exponent;
+  }
+  endptr = current;
+
+  // The integral part is the first integer_digits + exponent digits of the
+  // integer and fraction digits, padded with zeros.
+  IntegerAccumulator<T> accumulator;
+  const int64_t integral_digits = int64_t(integer_digits) + exponent;
+  for (int64_t i = 0; i < integral_digits && !accumulator.overflow; i++)
+  {
+    size_t index = size_t(i);
+    if (index < integer_digits)
+      accumulator.push(uint32_t(integer_begin[index] - '0'));
+    else if (index - integer_digits < fraction_digits)
+      accumulator.push(uint32_t(fraction_begin[index - integer_digits] - '0'));
+    else if (accumulator.value)
+      accumulator.push(0);
+    else
+      break;
   }
-  return parseResult;
+  return accumulator.assign(negative, target);
 }
 
 template <typename T>
@@ -7063,7 +10686,7 @@ inline parse_string_error to_ieee_t(const char *str, size_t size, T &target, con
   }
   else
   {
-    target = convertToNumber<T>(ps);
+    target = convertToNumber<T>(ps, str, str + size);
   }
   return parseResult;
 }
@@ -7150,6 +10773,13 @@ struct TypeHandlerIntType
 {
   static inline Error to(T &to_type, ParseContext &context)
   {
+    auto plain_error =
+      Internal::ft::integer::to_integer_plain(context.token.value.data, context.token.value.size, to_type);
+    if (plain_error == Internal::ft::parse_string_error::ok)
+      return Error::NoError;
+    if (plain_error == Internal::ft::parse_string_error::out_of_range)
+      return Error::FailedToParseInt;
+
     const char *pointer;
     auto parse_error =
       Internal::ft::integer::to_integer(context.token.value.data, context.token.value.size, to_type, pointer);
@@ -7160,19 +10790,10 @@ struct TypeHandlerIntType
 
   static inline void from(const T &from_type, Token &token, Serializer &serializer)
   {
-    char buf[40];
-    int digits_truncated;
-    int size = Internal::ft::integer::to_buffer(from_type, buf, sizeof(buf), &digits_truncated);
-    if (size <= 0 || digits_truncated)
-    {
-      fprintf(stderr, "error serializing int token\n");
-      return;
-    }
-
     token.value_type = Type::Number;
-    token.value.data = buf;
-    token.value.size = size_t(size);
-    serializer.write(token);
+    serializer.writeNumber<Internal::ft::integer::max_chars<T>()>(token, [&from_type](char *out) {
+      return size_t(Internal::ft::integer::write_integer(from_type, out));
+    });
   }
 };
 
@@ -7498,10 +11119,10 @@ struct TypeHandler<T, typename std::enable_if_t<Internal::is_specialization<T, s
 #endif
 
 /// \private
-template <typename T>
-struct TypeHandler<std::vector<T>>
+template <typename T, typename Allocator>
+struct TypeHandler<std::vector<T, Allocator>>
 {
-  static inline Error to(std::vector<T> &to_type, ParseContext &context)
+  static inline Error to(std::vector<T, Allocator> &to_type, ParseContext &context)
   {
     if (context.token.value_type != JS::Type::ArrayStart)
       return Error::ExpectedArrayStart;
@@ -7509,10 +11130,11 @@ struct TypeHandler<std::vector<T>>
     if (error != JS::Error::NoError)
       return error;
     to_type.clear();
+    Internal::ContextAllocator<Allocator>::bind(to_type, context);
     to_type.reserve(10);
     while (context.token.value_type != JS::Type::ArrayEnd)
     {
-      to_type.push_back(T());
+      to_type.emplace_back();
       error = TypeHandler<T>::to(to_type.back(), context);
       if (error != JS::Error::NoError)
         break;
@@ -7524,7 +11146,7 @@ struct TypeHandler<std::vector<T>>
     return error;
   }
 
-  static inline void from(const std::vector<T> &vec, Token &token, Serializer &serializer)
+  static inline void from(const std::vector<T, Allocator> &vec, Token &token, Serializer &serializer)
   {
     token.value_type = Type::ArrayStart;
     token.value = DataRef("[");
@@ -7713,6 +11335,53 @@ public:
   }
 };
 
+/// \private
+template <>
+struct TypeHandler<CompactJsonTokens>
+{
+public:
+  static inline Error to(CompactJsonTokens &to_type, ParseContext &context)
+  {
+    const DataRef buffer = context.tokenizer.currentBuffer();
+    to_type.reset(buffer.data, buffer.size);
+    if (!to_type.push_back(context.token))
+      return Error::TokenTooLarge;
+    if (context.token.value_type != JS::Type::ArrayStart && context.token.value_type != JS::Type::ObjectStart)
+      return context.error;
+    bool buffer_change = false;
+    auto ref = context.tokenizer.registerNeedMoreDataCallback([&buffer_change](JS::Tokenizer &tokenizer) {
+      JS_UNUSED(tokenizer);
+      buffer_change = true;
+    });
+
+    size_t level = 1;
+    Error error = Error::NoError;
+    while (error == JS::Error::NoError && level && buffer_change == false)
+    {
+      error = context.nextToken();
+      if (!to_type.push_back(context.token))
+        return Error::TokenTooLarge;
+      if (context.token.value_type == Type::ArrayStart || context.token.value_type == Type::ObjectStart)
+        level++;
+      else if (context.token.value_type == Type::ArrayEnd || context.token.value_type == Type::ObjectEnd)
+        level--;
+    }
+    if (buffer_change)
+      return Error::NonContigiousMemory;
+
+    return error;
+  }
+
+  static inline void from(const CompactJsonTokens &from_type, Token &token, Serializer &serializer)
+  {
+    for (size_t i = 0; i < from_type.size(); i++)
+    {
+      token = from_type[i];
+      serializer.write(token);
+    }
+  }
+};
+
 /// \private
 template <>
 struct TypeHandler<JsonArrayRef>
@@ -8241,6 +11910,28 @@ public:
   }
 };
 
+namespace Internal
+{
+template <typename Key>
+struct MapKey
+{
+  static Key make(const DataRef &name, const ParseContext &)
+  {
+    return Key(name.data, name.size);
+  }
+};
+
+template <typename Traits, typename Allocator>
+struct MapKey<std::basic_string<char, Traits, Allocator>>
+{
+  static std::basic_string<char, Traits, Allocator> make(const DataRef &name, const ParseContext &context)
+  {
+    return std::basic_string<char, Traits, Allocator>(name.data, name.size,
+                                                      ContextAllocator<Allocator>::select(Allocator(), context));
+  }
+};
+} // namespace Internal
+
 template <typename Key, typename Value, typename Map>
 struct TypeHandlerMap
 {
@@ -8254,70 +11945,205 @@ struct TypeHandlerMap
     Error error = context.nextToken();
     if (error != JS::Error::NoError)
       return error;
+    Internal::ContextAllocator<typename Map::allocator_type>::bind(to_type, context);
     while (context.token.value_type != Type::ObjectEnd)
     {
-      Key key(context.token.name.data, context.token.name.size);
-      Value v;
-      error = TypeHandler<Value>::to(v, context);
-      to_type[std::move(key)] = std::move(v);
+      Key key = Internal::MapKey<Key>::make(context.token.name, context);
+      size_t size = to_type.size();
+      // Parse in place, so the value is constructed with the allocator of the map.
+      Value &value = to_type[std::move(key)];
+      if (to_type.size() == size)
+        value = Value();
+      error = TypeHandler<Value>::to(value, context);
       if (error != JS::Error::NoError)
         return error;
       error = context.nextToken();
     }
 
-    return error;
+    return error;
+  }
+
+  static void from(const Map &from, Token &token, Serializer &serializer)
+  {
+    token.value_type = Type::ObjectStart;
+    token.value = DataRef("{");
+    serializer.write(token);
+    for (auto it = from.begin(); it != from.end(); ++it)
+    {
+      token.name = DataRef(it->first);
+      token.name_type = Type::String;
+      TypeHandler<Value>::from(it->second, token, serializer);
+    }
+    token.name.size = 0;
+    token.name.data = "";
+    token.name_type = Type::String;
+    token.value_type = Type::ObjectEnd;
+    token.value = DataRef("}");
+    serializer.write(token);
+  }
+};
+
+#ifdef JS_STD_UNORDERED_MAP
+template <typename Key, typename Value, typename Hash, typename KeyEqual, typename Allocator>
+struct TypeHandler<std::unordered_map<Key, Value, Hash, KeyEqual, Allocator>>
+  : TypeHandlerMap<Key, Value, std::unordered_map<Key, Value, Hash, KeyEqual, Allocator>>
+{
+};
+
+#endif
+
+namespace Internal
+{
+inline bool compareDataRefWithString(const DataRef &a, const std::string &b)
+{
+  return a.size == b.size() && memcmp(a.data, b.data(), a.size) == 0;
+}
+
+/* Open addressing hash table from names to entry numbers. The names are not
+ * stored, name_at(entry) returns the name of an entry. Of duplicate names the
+ * entry inserted first is found, as with a linear search. */
+class NameHashTable
+{
+public:
+  bool empty() const
+  {
+    return table.empty();
+  }
+
+  void clear()
+  {
+    table.clear();
+  }
+
+  template <typename NameAt>
+  void rebuild(size_t entries, NameAt name_at)
+  {
+    size_t table_size = 4;
+    while (table_size < entries * 2)
+      table_size *= 2;
+    table.assign(table_size, 0);
+    for (size_t i = 0; i < entries; i++)
+      insert(i, name_at);
+  }
+
+  // Adds entry, which has to be the last one.
+  template <typename NameAt>
+  void add(size_t entry, NameAt name_at)
+  {
+    if ((entry + 1) * 2 > table.size())
+      rebuild(entry + 1, name_at);
+    else
+      insert(entry, name_at);
+  }
+
+  template <typename NameAt>
+  size_t find(const char *name, size_t size, NameAt name_at) const
+  {
+    if (table.empty())
+      return size_t(-1);
+    size_t mask = table.size() - 1;
+    size_t slot = hashName(name, size) & mask;
+    while (table[slot])
+    {
+      const DataRef existing = name_at(table[slot] - 1);
+      if (existing.size == size && memcmp(existing.data, name, size) == 0)
+        return table[slot] - 1;
+      slot = (slot + 1) & mask;
+    }
+    return size_t(-1);
+  }
+
+private:
+  template <typename NameAt>
+  void insert(size_t entry, NameAt name_at)
+  {
+    const DataRef name = name_at(entry);
+    if (find(name.data, name.size, name_at) != size_t(-1))
+      return;
+    size_t mask = table.size() - 1;
+    size_t slot = hashName(name.data, name.size) & mask;
+    while (table[slot])
+      slot = (slot + 1) & mask;
+    table[slot] = uint32_t(entry + 1);
+  }
+
+  std::vector<uint32_t> table;
+};
+
+/* How a map reaches the tokens in its token storage. */
+template <typename Tokens>
+struct MapTokens;
+
+template <>
+struct MapTokens<JsonTokens>
+{
+  // The tokens are stored unpacked, so the iterator refers to them directly.
+  struct Current
+  {
+  };
+  static uint32_t size(const JsonTokens &tokens)
+  {
+    return uint32_t(tokens.data.size());
   }
-
-  static void from(const Map &from, Token &token, Serializer &serializer)
+  static const Token &at(const JsonTokens &tokens, uint32_t index, Current &)
   {
-    token.value_type = Type::ObjectStart;
-    token.value = DataRef("{");
-    serializer.write(token);
-    for (auto it = from.begin(); it != from.end(); ++it)
-    {
-      token.name = DataRef(it->first);
-      token.name_type = Type::String;
-      TypeHandler<Value>::from(it->second, token, serializer);
-    }
-    token.name.size = 0;
-    token.name.data = "";
-    token.name_type = Type::String;
-    token.value_type = Type::ObjectEnd;
-    token.value = DataRef("}");
-    serializer.write(token);
+    return tokens.data[index];
+  }
+  static Type valueType(const JsonTokens &tokens, uint32_t index)
+  {
+    return tokens.data[index].value_type;
+  }
+  static const std::vector<Token> *source(const JsonTokens &tokens)
+  {
+    return &tokens.data;
   }
 };
 
-#ifdef JS_STD_UNORDERED_MAP
-template <typename Key, typename Value>
-struct TypeHandler<std::unordered_map<Key, Value>> : TypeHandlerMap<Key, Value, std::unordered_map<Key, Value>>
+template <>
+struct MapTokens<CompactJsonTokens>
 {
+  // The iterator unpacks the token it points to on access.
+  using Current = Token;
+  static uint32_t size(const CompactJsonTokens &tokens)
+  {
+    return uint32_t(tokens.size());
+  }
+  static const Token &at(const CompactJsonTokens &tokens, uint32_t index, Current &current)
+  {
+    current = tokens[index];
+    return current;
+  }
+  static Type valueType(const CompactJsonTokens &tokens, uint32_t index)
+  {
+    return tokens.valueType(index);
+  }
+  static const CompactJsonTokens *source(const CompactJsonTokens &tokens)
+  {
+    return &tokens;
+  }
 };
 
-#endif
-
-namespace Internal
-{
-inline bool compareDataRefWithString(const DataRef &a, const std::string &b)
-{
-  return a.size == b.size() && memcmp(a.data, b.data(), a.size) == 0;
-}
-} // namespace Internal
-struct Map
+/* The iteration and casting shared by JS::Map and JS::CompactMap. Derived
+ * can replace find(), which the cast by name uses. */
+template <typename Derived, typename Tokens>
+struct MapBase
 {
+  using Access = MapTokens<Tokens>;
+
   struct It
   {
     using iterator_category = std::forward_iterator_tag;
     using difference_type = int;
     using value_type = Token;
-    using pointer = Token *;
-    using reference = Token &;
-    const Map &map;
+    using pointer = const Token *;
+    using reference = const Token &;
+    const MapBase &map;
     uint32_t index = 0;
     uint32_t next_meta = 0;
     uint32_t next_complex = 0;
+    typename Access::Current current;
 
-    It(const Map &map)
+    It(const MapBase &map)
       : map(map)
     {
     }
@@ -8330,12 +12156,12 @@ struct Map
     }
     inline const Token &operator*()
     {
-      return map.tokens.data[index];
+      return Access::at(map.tokens, index, current);
     }
 
     inline const Token *operator->()
     {
-      return &map.tokens.data[index];
+      return &Access::at(map.tokens, index, current);
     }
 
     inline It &operator++()
@@ -8345,7 +12171,7 @@ struct Map
         index += map.meta[next_meta].size;
         next_meta += map.meta[next_meta].skip;
         next_complex = next_meta < uint32_t(map.meta.size()) ? uint32_t(map.meta[next_meta].position)
-                                                             : uint32_t(map.tokens.data.size());
+                                                             : Access::size(map.tokens);
       }
       else
       {
@@ -8371,24 +12197,22 @@ struct Map
     }
   };
 
-  JS::JsonTokens tokens;
+  Tokens tokens;
   std::vector<JsonMeta> meta;
-  std::vector<std::pair<int, std::string>> json_data;
 
   inline It begin() const
   {
     It b(*this);
     b.index = 1;
     b.next_meta = 1;
-    b.next_complex =
-      b.next_meta < uint32_t(meta.size()) ? uint32_t(meta[b.next_meta].position) : uint32_t(tokens.data.size());
+    b.next_complex = b.next_meta < uint32_t(meta.size()) ? uint32_t(meta[b.next_meta].position) : Access::size(tokens);
     return b;
   }
 
   inline It end() const
   {
     It e(*this);
-    e.index = uint32_t(tokens.data.size());
+    e.index = Access::size(tokens);
     e.next_meta = 0;
     e.next_complex = 0;
     return e;
@@ -8403,7 +12227,7 @@ struct Map
   template <typename T>
   JS::Error castToType(JS::ParseContext &parseContext, T &to) const
   {
-    parseContext.tokenizer.resetData(&tokens.data, 0);
+    parseContext.tokenizer.resetData(Access::source(tokens), 0);
     parseContext.nextToken();
     return JS::TypeHandler<T>::to(to, parseContext);
   }
@@ -8411,8 +12235,8 @@ struct Map
   template <typename T>
   JS::Error castToType(const It &iterator, JS::ParseContext &parseContext, T &to) const
   {
-    assert(iterator.index < tokens.data.size());
-    parseContext.tokenizer.resetData(&tokens.data, iterator.index);
+    assert(iterator.index < Access::size(tokens));
+    parseContext.tokenizer.resetData(Access::source(tokens), iterator.index);
     parseContext.nextToken();
     return JS::TypeHandler<T>::to(to, parseContext);
   }
@@ -8420,13 +12244,13 @@ struct Map
   template <typename T>
   JS::Error castToType(const std::string &name, JS::ParseContext &parseContext, T &to) const
   {
-    if (tokens.data.empty() || tokens.data.front().value_type != JS::Type::ObjectStart)
+    if (!Access::size(tokens) || Access::valueType(tokens, 0) != JS::Type::ObjectStart)
     {
       parseContext.error = JS::Error::ExpectedObjectStart;
       return parseContext.error;
     }
 
-    It it = find(name);
+    It it = static_cast<const Derived &>(*this).find(name);
     if (it != end())
       return castToType(it, parseContext, to);
     parseContext.error = JS::Error::KeyNotFound;
@@ -8448,6 +12272,35 @@ struct Map
     castToType<T>(name, parseContext, t);
     return t;
   }
+};
+} // namespace Internal
+
+struct Map : Internal::MapBase<Map, JsonTokens>
+{
+  // The json the tokens of values set with setValue point into. A vector
+  // keeps its data in place when it is moved.
+  std::vector<std::pair<int, std::vector<char>>> json_data;
+  // When set, find() and the functions taking a member name look the name up
+  // in a hash index of the members of the root object instead of comparing
+  // every name. The index is built by the first lookup and updated by
+  // setValue, so concurrent lookups in the same Map are only safe after that.
+  bool use_index = false;
+
+  inline It find(const std::string &name) const
+  {
+    if (use_index && tokens.data.size() && tokens.data.front().value_type == JS::Type::ObjectStart)
+      return findInIndex(name);
+    return MapBase::find(name);
+  }
+
+  // Drops the index. It has to be called when tokens or meta are changed
+  // other than through setValue.
+  inline void resetIndex()
+  {
+    index_entries.clear();
+    index_table.clear();
+    index_token_count = 0;
+  }
 
   template <typename T>
   JS::Error setValue(JS::ParseContext &parseContext, const T &value)
@@ -8455,11 +12308,13 @@ struct Map
     static_assert(sizeof(JS::Internal::HasJsonStructBase<T>::template test_in_base<T>(nullptr)) ==
                     sizeof(typename JS::Internal::HasJsonStructBase<T>::yes),
                   "Not a Json Object type\n");
-    std::string obj = JS::serializeStruct(value);
+    std::string serialized = JS::serializeStruct(value);
+    std::vector<char> obj(serialized.begin(), serialized.end());
     parseContext.tokenizer.resetData(obj.data(), obj.size(), 0);
     tokens.data.clear();
     meta.clear();
     json_data.clear();
+    resetIndex();
     auto error = parseContext.parseTo(tokens);
     if (error == JS::Error::NoError)
       assert(tokens.data.size() && tokens.data[0].value_type == JS::Type::ObjectStart);
@@ -8490,12 +12345,15 @@ struct Map
     auto it = find(name);
     if (it != end())
     {
+      const bool update_index = indexIsBuilt();
       meta[0].children--;
       int tokens_removed = 0;
+      uint32_t meta_removed = 0;
       if (it.index == it.next_complex)
       {
         auto theMeta = meta[it.next_meta];
         tokens_removed = theMeta.size;
+        meta_removed = theMeta.skip;
         meta[0].complex_children--;
         meta[0].size -= theMeta.size;
         meta[0].skip -= theMeta.skip;
@@ -8514,6 +12372,10 @@ struct Map
         meta[0].size--;
         tokens.data.erase(tokens.data.begin() + it.index);
         tokens_removed = 1;
+        for (size_t i = it.next_meta; i < meta.size(); i++)
+        {
+          meta[i].position--;
+        }
       }
       {
         int index_to_remove = -1;
@@ -8529,11 +12391,13 @@ struct Map
           json_data.erase(json_data.begin() + index_to_remove);
         }
       }
+      if (update_index)
+        removeFromIndex(it, tokens_removed, meta_removed);
     }
     static const char objectStart[] = "{";
     static const char objectEnd[] = "}";
-    std::string out;
-    JS::SerializerContext serializeContext(out);
+    std::string serialized;
+    JS::SerializerContext serializeContext(serialized);
     serializeContext.serializer.setOptions(SerializerOptions(JS::SerializerOptions::Compact));
     JS::Token token;
     token.value_type = Type::ObjectStart;
@@ -8550,11 +12414,13 @@ struct Map
     serializeContext.serializer.write(token);
 
     serializeContext.flush();
+    std::vector<char> out(serialized.begin(), serialized.end());
     JS::JsonTokens new_tokens;
-    JS::ParseContext pc(out.c_str(), out.size(), new_tokens);
+    JS::ParseContext pc(out.data(), out.size(), new_tokens);
     auto new_meta = metaForTokens(new_tokens);
 
     json_data.emplace_back(int(tokens.data.size() - 1), std::move(out));
+    const bool update_index = indexIsBuilt();
     int old_tokens_size = int(tokens.data.size());
     tokens.data.insert(tokens.data.end() - 1, new_tokens.data.begin() + 1, new_tokens.data.end() - 1);
     meta[0].children++;
@@ -8575,9 +12441,103 @@ struct Map
     {
       meta[0].size++;
     }
+    if (update_index)
+      addToIndex(uint32_t(old_tokens_size - 1),
+                 new_meta[0].complex_children ? uint32_t(meta.size() - (new_meta.size() - 1)) : uint32_t(meta.size()));
 
     return JS::Error::NoError;
   }
+
+private:
+  struct IndexEntry
+  {
+    uint32_t index;
+    uint32_t next_meta;
+  };
+
+  inline bool indexIsBuilt() const
+  {
+    return !index_table.empty() && index_token_count == tokens.data.size();
+  }
+
+  inline It iteratorAt(const IndexEntry &entry) const
+  {
+    It it(*this);
+    it.index = entry.index;
+    it.next_meta = entry.next_meta;
+    it.next_complex =
+      it.next_meta < uint32_t(meta.size()) ? uint32_t(meta[it.next_meta].position) : uint32_t(tokens.data.size());
+    return it;
+  }
+
+  inline It findInIndex(const std::string &name) const
+  {
+    if (!indexIsBuilt())
+      buildIndex();
+    size_t entry = index_table.find(name.data(), name.size(), indexName());
+    if (entry == size_t(-1))
+      return end();
+    return iteratorAt(index_entries[entry]);
+  }
+
+  struct IndexName
+  {
+    const Map &map;
+    DataRef operator()(size_t entry) const
+    {
+      return map.tokens.data[map.index_entries[entry].index].name;
+    }
+  };
+
+  inline IndexName indexName() const
+  {
+    return IndexName{*this};
+  }
+
+  inline void buildIndex() const
+  {
+    index_entries.clear();
+    const It e = end();
+    for (It it = begin(); it != e; ++it)
+    {
+      if (it.index + 1 < tokens.data.size())
+        index_entries.push_back({it.index, it.next_meta});
+    }
+    index_token_count = tokens.data.size();
+    index_table.rebuild(index_entries.size(), indexName());
+  }
+
+  // Called after the tokens and meta of the member at removed have been
+  // erased, which moves every later member.
+  inline void removeFromIndex(const It &removed, int tokens_removed, uint32_t meta_removed)
+  {
+    size_t out = 0;
+    for (size_t i = 0; i < index_entries.size(); i++)
+    {
+      IndexEntry entry = index_entries[i];
+      if (entry.index == removed.index)
+        continue;
+      if (entry.index > removed.index)
+        entry.index -= uint32_t(tokens_removed);
+      if (entry.next_meta > removed.next_meta)
+        entry.next_meta -= meta_removed;
+      index_entries[out++] = entry;
+    }
+    index_entries.resize(out);
+    index_token_count = tokens.data.size();
+    index_table.rebuild(index_entries.size(), indexName());
+  }
+
+  inline void addToIndex(uint32_t index, uint32_t next_meta)
+  {
+    index_entries.push_back({index, next_meta});
+    index_token_count = tokens.data.size();
+    index_table.add(index_entries.size() - 1, indexName());
+  }
+
+  mutable std::vector<IndexEntry> index_entries;
+  mutable Internal::NameHashTable index_table;
+  mutable size_t index_token_count = 0;
 };
 
 template <>
@@ -8585,6 +12545,7 @@ struct TypeHandler<Map>
 {
   static inline Error to(Map &to_type, ParseContext &context)
   {
+    to_type.resetIndex();
     Error error = TypeHandler<JS::JsonTokens>::to(to_type.tokens, context);
     if (error == Error::NoError)
     {
@@ -8603,6 +12564,265 @@ struct TypeHandler<Map>
   }
 };
 
+/*!
+ * \brief A read only JS::Map backed by a CompactJsonTokens tape.
+ *
+ * It iterates, finds and casts members like JS::Map, but keeps the tokens in
+ * 16 bytes each. The iterator unpacks the token it points to on access.
+ */
+struct CompactMap : Internal::MapBase<CompactMap, CompactJsonTokens>
+{
+};
+
+template <>
+struct TypeHandler<CompactMap>
+{
+  static inline Error to(CompactMap &to_type, ParseContext &context)
+  {
+    Error error = TypeHandler<JS::CompactJsonTokens>::to(to_type.tokens, context);
+    if (error == Error::NoError)
+    {
+      to_type.meta = metaForTokens(to_type.tokens);
+    }
+
+    return error;
+  }
+
+  static inline void from(const CompactMap &from_type, Token &token, Serializer &serializer)
+  {
+    TypeHandler<JS::CompactJsonTokens>::from(from_type.tokens, token, serializer);
+  }
+};
+
+/*!
+ * \brief A json object that is edited member by member.
+ *
+ * Every member of the root object is a segment holding the tokens of its
+ * value, and members are found through a hash index. setValue only
+ * serializes and tokenizes the new value and replaces or appends one
+ * segment, so an edit costs the size of the value and not of the document.
+ * Parsed members point into the parsed json, which has to outlive the map,
+ * while members set with setValue own their json.
+ */
+struct EditableMap
+{
+  struct Member
+  {
+    std::vector<Token> tokens;
+    // The json the tokens point into when the member was set with setValue.
+    // A vector keeps its data in place when the member is moved.
+    std::vector<char> json;
+
+    DataRef name() const
+    {
+      return tokens.front().name;
+    }
+  };
+
+  std::vector<Member> members;
+
+  inline const Member *find(const std::string &name) const
+  {
+    size_t index = findIndex(name);
+    return index < members.size() ? &members[index] : nullptr;
+  }
+
+  inline Member *find(const std::string &name)
+  {
+    size_t index = findIndex(name);
+    return index < members.size() ? &members[index] : nullptr;
+  }
+
+  template <typename T>
+  JS::Error castToType(const std::string &name, JS::ParseContext &parseContext, T &to) const
+  {
+    const Member *member = find(name);
+    if (!member)
+    {
+      parseContext.error = JS::Error::KeyNotFound;
+      return parseContext.error;
+    }
+    parseContext.tokenizer.resetData(&member->tokens, 0);
+    parseContext.nextToken();
+    return JS::TypeHandler<T>::to(to, parseContext);
+  }
+
+  template <typename T>
+  T castTo(const std::string &name, JS::ParseContext &parseContext) const
+  {
+    T t = {};
+    castToType<T>(name, parseContext, t);
+    return t;
+  }
+
+  // Casts the whole object, which joins the tokens of all the members.
+  template <typename T>
+  JS::Error castToType(JS::ParseContext &parseContext, T &to) const
+  {
+    std::vector<Token> tokens;
+    Token token;
+    token.value_type = Type::ObjectStart;
+    token.value = DataRef("{");
+    tokens.push_back(token);
+    for (auto &member : members)
+      tokens.insert(tokens.end(), member.tokens.begin(), member.tokens.end());
+    token.value_type = Type::ObjectEnd;
+    token.value = DataRef("}");
+    tokens.push_back(token);
+
+    parseContext.tokenizer.resetData(&tokens, 0);
+    parseContext.nextToken();
+    JS::Error error = JS::TypeHandler<T>::to(to, parseContext);
+    parseContext.tokenizer.resetData(static_cast<const std::vector<Token> *>(nullptr), 0);
+    return error;
+  }
+
+  template <typename T>
+  JS::Error setValue(const std::string &name, JS::ParseContext &parseContext, const T &value)
+  {
+    std::string serialized;
+    {
+      JS::SerializerContext serializeContext(serialized);
+      serializeContext.serializer.setOptions(SerializerOptions(JS::SerializerOptions::Compact));
+      JS::Token token;
+      token.value_type = Type::ObjectStart;
+      token.value = DataRef("{");
+      serializeContext.serializer.write(token);
+      token.name = DataRef(name);
+      token.name_type = Type::String;
+      JS::TypeHandler<T>::from(value, token, serializeContext.serializer);
+      token.name = DataRef();
+      token.value_type = Type::ObjectEnd;
+      token.value = DataRef("}");
+      serializeContext.serializer.write(token);
+    }
+
+    std::vector<char> json(serialized.begin(), serialized.end());
+    std::vector<Token> tokens;
+    parseContext.reset(json.data(), json.size());
+    JS::Error error = parseContext.parseTo(tokens);
+    if (error != JS::Error::NoError)
+      return error;
+    tokens.pop_back();
+    tokens.erase(tokens.begin());
+
+    size_t index = findIndex(name);
+    if (index < members.size())
+    {
+      members[index].tokens.swap(tokens);
+      members[index].json.swap(json);
+      return JS::Error::NoError;
+    }
+    members.emplace_back();
+    members.back().tokens.swap(tokens);
+    members.back().json.swap(json);
+    if (index_member_count + 1 == members.size())
+    {
+      index_member_count++;
+      index_table.add(members.size() - 1, IndexName{*this});
+    }
+    return JS::Error::NoError;
+  }
+
+  inline bool remove(const std::string &name)
+  {
+    size_t index = findIndex(name);
+    if (index >= members.size())
+      return false;
+    members.erase(members.begin() + index);
+    rebuildIndex();
+    return true;
+  }
+
+  // Has to be called when members is changed other than through setValue
+  // and remove. Until then members are found by comparing every name.
+  inline void rebuildIndex()
+  {
+    index_member_count = members.size();
+    index_table.rebuild(members.size(), IndexName{*this});
+  }
+
+  // Drops the index, so members are found by comparing every name.
+  inline void resetIndex()
+  {
+    index_table.clear();
+    index_member_count = 0;
+  }
+
+private:
+  struct IndexName
+  {
+    const EditableMap &map;
+    DataRef operator()(size_t entry) const
+    {
+      return map.members[entry].name();
+    }
+  };
+
+  inline size_t findIndex(const std::string &name) const
+  {
+    if (index_member_count == members.size() && !index_table.empty())
+      return index_table.find(name.data(), name.size(), IndexName{*this});
+    for (size_t i = 0; i < members.size(); i++)
+    {
+      if (Internal::compareDataRefWithString(members[i].name(), name))
+        return i;
+    }
+    return size_t(-1);
+  }
+
+  Internal::NameHashTable index_table;
+  size_t index_member_count = 0;
+};
+
+template <>
+struct TypeHandler<EditableMap>
+{
+  static inline Error to(EditableMap &to_type, ParseContext &context)
+  {
+    to_type.resetIndex();
+    if (context.token.value_type != Type::ObjectStart)
+      return Error::ExpectedObjectStart;
+    to_type.members.clear();
+    bool buffer_change = false;
+    auto ref = context.tokenizer.registerNeedMoreDataCallback([&buffer_change](JS::Tokenizer &tokenizer) {
+      JS_UNUSED(tokenizer);
+      buffer_change = true;
+    });
+
+    Error error = context.nextToken();
+    while (error == Error::NoError && context.token.value_type != Type::ObjectEnd && !buffer_change)
+    {
+      to_type.members.emplace_back();
+      error = TypeHandler<std::vector<Token>>::to(to_type.members.back().tokens, context);
+      if (error == Error::NoError)
+        error = context.nextToken();
+    }
+    if (buffer_change)
+      return Error::NonContigiousMemory;
+    to_type.rebuildIndex();
+    return error;
+  }
+
+  static inline void from(const EditableMap &from_type, Token &token, Serializer &serializer)
+  {
+    token.value_type = Type::ObjectStart;
+    token.value = DataRef("{");
+    serializer.write(token);
+    for (auto &member : from_type.members)
+    {
+      for (auto &member_token : member.tokens)
+        serializer.write(member_token);
+    }
+    token.name.size = 0;
+    token.name.data = "";
+    token.name_type = Type::String;
+    token.value_type = Type::ObjectEnd;
+    token.value = DataRef("}");
+    serializer.write(token);
+  }
+};
+
 template <typename T, size_t COUNT>
 struct ArrayVariableContent
 {
@@ -8668,6 +12888,7 @@ struct TypeHandlerSet
     if (error != JS::Error::NoError)
       return error;
     to_type.clear();
+    Internal::ContextAllocator<typename Set::allocator_type>::bind(to_type, context);
     while (context.token.value_type != JS::Type::ArrayEnd)
     {
       T t;
@@ -8714,8 +12935,15 @@ struct TypeHandlerSet
 #include <map>
 namespace JS
 {
-template <typename Key, typename Value>
-struct TypeHandler<std::map<Key, Value>> : TypeHandlerMap<Key, Value, std::map<Key, Value>>
+template <typename Key, typename Value, typename Compare, typename Allocator>
+struct TypeHandler<std::map<Key, Value, Compare, Allocator>>
+  : TypeHandlerMap<Key, Value, std::map<Key, Value, Compare, Allocator>>
+{
+};
+
+/// \private
+template <typename Key, typename Value, typename Compare, typename Allocator>
+struct ValidateHandler<std::map<Key, Value, Compare, Allocator>> : Internal::ValidateHandlerMap<Value>
 {
 };
 } // namespace JS
@@ -8726,8 +12954,8 @@ struct TypeHandler<std::map<Key, Value>> : TypeHandlerMap<Key, Value, std::map<K
 #include <set>
 namespace JS
 {
-template <typename Key>
-struct TypeHandler<std::set<Key>> : TypeHandlerSet<Key, std::set<Key>>
+template <typename Key, typename Compare, typename Allocator>
+struct TypeHandler<std::set<Key, Compare, Allocator>> : TypeHandlerSet<Key, std::set<Key, Compare, Allocator>>
 {
 };
 } // namespace JS
@@ -8738,8 +12966,9 @@ struct TypeHandler<std::set<Key>> : TypeHandlerSet<Key, std::set<Key>>
 #include <unordered_set>
 namespace JS
 {
-template <typename Key>
-struct TypeHandler<std::unordered_set<Key>> : TypeHandlerSet<Key, std::unordered_set<Key>>
+template <typename Key, typename Hash, typename KeyEqual, typename Allocator>
+struct TypeHandler<std::unordered_set<Key, Hash, KeyEqual, Allocator>>
+  : TypeHandlerSet<Key, std::unordered_set<Key, Hash, KeyEqual, Allocator>>
 {
 };
 } // namespace JS
@@ -8791,6 +13020,16 @@ public:
     serializer.write(token);
   }
 };
+
+/// \private
+template <typename T, size_t N>
+struct ValidateHandler<std::array<T, N>>
+{
+  static inline Error validate(ParseContext &context)
+  {
+    return Internal::validateFixedArray<T, N>(context);
+  }
+};
 } // namespace JS
 #endif
 
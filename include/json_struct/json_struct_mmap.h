@@ -0,0 +1,288 @@
+/*
+* Copyright © 2020 Jørgen Lind
+
+* Permission to use, copy, modify, distribute, and sell this software and its
+* documentation for any purpose is hereby granted without fee, provided that
+* the above copyright notice appear in all copies and that both that copyright
+* notice and this permission notice appear in supporting documentation, and
+* that the name of the copyright holders not be used in advertising or
+* publicity pertaining to distribution of the software without specific,
+* written prior permission.  The copyright holders make no representations
+* about the suitability of this software for any purpose.  It is provided "as
+* is" without express or implied warranty.
+
+* THE COPYRIGHT HOLDERS DISCLAIM ALL WARRANTIES WITH REGARD TO THIS SOFTWARE,
+* INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS, IN NO
+* EVENT SHALL THE COPYRIGHT HOLDERS BE LIABLE FOR ANY SPECIAL, INDIRECT OR
+* CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE,
+* DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER
+* TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE
+* OF THIS SOFTWARE.
+*/
+
+/*! \file */
+
+/*
+ * json_struct_mmap is an extension to json_struct for parsing JSON files
+ * without reading them into memory first. The file is memory mapped one
+ * window at a time and the windows are fed to the Tokenizer as they are
+ * needed and unmapped as soon as the Tokenizer releases them, so parsing a
+ * file larger than the available memory only keeps a window or two resident.
+ *
+ * Platforms without mmap, or builds that define JS_MAPPED_INPUT_NO_MMAP,
+ * read the windows with stdio into heap buffers instead.
+ *
+ * Values that point into the input, DataRef and std::string_view members, are
+ * only valid while the window they point into is mapped. JS::parseFile closes
+ * the file before returning, so use owning types like std::string with it.
+ */
+
+#ifndef JSON_STRUCT_MMAP_H
+#define JSON_STRUCT_MMAP_H
+
+#include "json_struct.h"
+
+#include <stdio.h>
+
+#if !defined(_WIN32) && !defined(JS_MAPPED_INPUT_NO_MMAP)
+#define JS_MAPPED_INPUT_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace JS
+{
+class MappedInput
+{
+public:
+  static const size_t default_window_size = size_t(64) << 20;
+
+  MappedInput() = default;
+  MappedInput(const MappedInput &) = delete;
+  MappedInput &operator=(const MappedInput &) = delete;
+  ~MappedInput()
+  {
+    close();
+  }
+
+  /* Opens the file at path for reading. window_size and use_huge_pages are
+   * read when the windows are mapped, so set them before attach(). */
+  bool open(const std::string &path);
+  void close();
+  bool isOpen() const;
+
+  /* Makes the tokenizer pull its data from the file. The tokenizer has to
+   * outlive this object, or the input has to be closed first. Closing drops
+   * the data the tokenizer still holds from the file. */
+  void attach(Tokenizer &tokenizer);
+
+  /* The number of bytes of the file currently mapped or buffered. */
+  size_t residentBytes() const;
+
+  /* Size of each window. It is rounded up to whole pages, and the whole file
+   * is mapped at once when it is not larger than this. */
+  size_t window_size = default_window_size;
+  /* Asks the kernel to back the mapping with huge pages where supported. */
+  bool use_huge_pages = false;
+
+private:
+  struct Window
+  {
+    char *data;
+    size_t size;
+  };
+
+  bool addNextWindow(Tokenizer &tokenizer);
+  void releaseWindow(const char *data);
+  void freeWindow(const Window &window);
+
+  std::vector<Window> m_windows;
+  uint64_t m_next_offset = 0;
+  bool m_end_of_file = false;
+#ifdef JS_MAPPED_INPUT_MMAP
+  int m_fd = -1;
+  uint64_t m_file_size = 0;
+#else
+  FILE *m_file = nullptr;
+#endif
+  Tokenizer *m_tokenizer = nullptr;
+  NeedMoreDataCBRef m_need_more_data_ref;
+  ReleaseCBRef m_release_ref;
+};
+
+inline bool MappedInput::open(const std::string &path)
+{
+  close();
+#ifdef JS_MAPPED_INPUT_MMAP
+  m_fd = ::open(path.c_str(), O_RDONLY);
+  if (m_fd < 0)
+    return false;
+  struct stat file_stat;
+  if (fstat(m_fd, &file_stat) != 0)
+  {
+    close();
+    return false;
+  }
+  m_file_size = uint64_t(file_stat.st_size);
+#else
+  m_file = fopen(path.c_str(), "rb");
+  if (!m_file)
+    return false;
+#endif
+  m_next_offset = 0;
+  m_end_of_file = false;
+  return true;
+}
+
+inline void MappedInput::close()
+{
+  if (m_tokenizer)
+    m_tokenizer->resetData(static_cast<const std::vector<Token> *>(nullptr), 0);
+  m_tokenizer = nullptr;
+  m_need_more_data_ref = NeedMoreDataCBRef();
+  m_release_ref = ReleaseCBRef();
+  for (auto &window : m_windows)
+    freeWindow(window);
+  m_windows.clear();
+#ifdef JS_MAPPED_INPUT_MMAP
+  if (m_fd >= 0)
+    ::close(m_fd);
+  m_fd = -1;
+  m_file_size = 0;
+#else
+  if (m_file)
+    fclose(m_file);
+  m_file = nullptr;
+#endif
+}
+
+inline bool MappedInput::isOpen() const
+{
+#ifdef JS_MAPPED_INPUT_MMAP
+  return m_fd >= 0;
+#else
+  return m_file != nullptr;
+#endif
+}
+
+inline void MappedInput::attach(Tokenizer &tokenizer)
+{
+  std::function<void(Tokenizer &)> need_more_data = [this](Tokenizer &t) { addNextWindow(t); };
+  std::function<void(const char *)> release = [this](const char *data) { releaseWindow(data); };
+  m_need_more_data_ref = tokenizer.registerNeedMoreDataCallback(need_more_data);
+  m_release_ref = tokenizer.registerReleaseCallback(release);
+  m_tokenizer = &tokenizer;
+  addNextWindow(tokenizer);
+}
+
+inline size_t MappedInput::residentBytes() const
+{
+  size_t bytes = 0;
+  for (auto &window : m_windows)
+    bytes += window.size;
+  return bytes;
+}
+
+inline bool MappedInput::addNextWindow(Tokenizer &tokenizer)
+{
+  if (!isOpen() || m_end_of_file)
+    return false;
+  Window window;
+#ifdef JS_MAPPED_INPUT_MMAP
+  size_t page_size = size_t(sysconf(_SC_PAGESIZE));
+  size_t window_bytes = (std::max(window_size, page_size) + page_size - 1) / page_size * page_size;
+  uint64_t remaining = m_file_size - m_next_offset;
+  if (remaining == 0)
+  {
+    m_end_of_file = true;
+    return false;
+  }
+  window.size = remaining < window_bytes ? size_t(remaining) : window_bytes;
+  void *mapped = mmap(nullptr, window.size, PROT_READ, MAP_PRIVATE, m_fd, off_t(m_next_offset));
+  if (mapped == MAP_FAILED)
+  {
+    m_end_of_file = true;
+    return false;
+  }
+  window.data = static_cast<char *>(mapped);
+#ifdef MADV_SEQUENTIAL
+  madvise(mapped, window.size, MADV_SEQUENTIAL);
+#endif
+#ifdef MADV_HUGEPAGE
+  if (use_huge_pages)
+    madvise(mapped, window.size, MADV_HUGEPAGE);
+#endif
+#else
+  size_t window_bytes = std::max(window_size, size_t(4096));
+  window.data = static_cast<char *>(malloc(window_bytes));
+  if (!window.data)
+  {
+    m_end_of_file = true;
+    return false;
+  }
+  window.size = fread(window.data, 1, window_bytes, m_file);
+  if (window.size < window_bytes)
+    m_end_of_file = true;
+  if (window.size == 0)
+  {
+    free(window.data);
+    return false;
+  }
+#endif
+  m_next_offset += window.size;
+  m_windows.push_back(window);
+  tokenizer.addData(window.data, window.size);
+  return true;
+}
+
+inline void MappedInput::releaseWindow(const char *data)
+{
+  for (auto it = m_windows.begin(); it != m_windows.end(); ++it)
+  {
+    if (it->data == data)
+    {
+      freeWindow(*it);
+      m_windows.erase(it);
+      return;
+    }
+  }
+}
+
+inline void MappedInput::freeWindow(const Window &window)
+{
+#ifdef JS_MAPPED_INPUT_MMAP
+  munmap(window.data, window.size);
+#else
+  free(window.data);
+#endif
+}
+
+/* Parses the JSON file at path into to_type through a MappedInput. context
+ * keeps the error information afterwards, but its tokenizer no longer holds
+ * any data from the file. */
+template <typename T>
+inline Error parseFile(const std::string &path, T &to_type, ParseContext &context,
+                       size_t window_size = MappedInput::default_window_size)
+{
+  MappedInput input;
+  input.window_size = window_size;
+  if (!input.open(path))
+  {
+    context.error = Error::FailedToOpenFile;
+    return context.error;
+  }
+  input.attach(context.tokenizer);
+  return context.parseTo(to_type);
+}
+
+template <typename T>
+inline Error parseFile(const std::string &path, T &to_type)
+{
+  ParseContext context;
+  return parseFile(path, to_type, context);
+}
+} // namespace JS
+
+#endif // JSON_STRUCT_MMAP_H
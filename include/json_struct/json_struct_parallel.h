@@ -0,0 +1,363 @@
+/*
+* Copyright © 2020 Jørgen Lind
+
+* Permission to use, copy, modify, distribute, and sell this software and its
+* documentation for any purpose is hereby granted without fee, provided that
+* the above copyright notice appear in all copies and that both that copyright
+* notice and this permission notice appear in supporting documentation, and
+* that the name of the copyright holders not be used in advertising or
+* publicity pertaining to distribution of the software without specific,
+* written prior permission.  The copyright holders make no representations
+* about the suitability of this software for any purpose.  It is provided "as
+* is" without express or implied warranty.
+
+* THE COPYRIGHT HOLDERS DISCLAIM ALL WARRANTIES WITH REGARD TO THIS SOFTWARE,
+* INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS, IN NO
+* EVENT SHALL THE COPYRIGHT HOLDERS BE LIABLE FOR ANY SPECIAL, INDIRECT OR
+* CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE,
+* DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER
+* TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE
+* OF THIS SOFTWARE.
+*/
+
+/*! \file */
+
+/*
+ * json_struct_parallel is an extension to json_struct for parsing documents
+ * where the root is a large array, into a std::vector, on several threads.
+ *
+ * The document is scanned once with the structural index to find the
+ * elements of the root array, tracking string state so brackets and commas
+ * inside strings are not mistaken for structure. The elements are split into
+ * contiguous chunks of roughly the same size, each chunk is parsed by its own
+ * thread with its own ParseContext, and the results are moved into the
+ * destination vector in document order.
+ *
+ * Serializing a std::vector works the other way around. Every thread
+ * serializes a contiguous slice of the elements with its own Serializer,
+ * resumed with the delimiter and indentation state the serial path has at
+ * the start of the slice, so the slices joined are byte identical to
+ * serializeStruct.
+ */
+
+#ifndef JSON_STRUCT_PARALLEL_H
+#define JSON_STRUCT_PARALLEL_H
+
+#include "json_struct.h"
+
+#include <iterator>
+#include <thread>
+
+namespace JS
+{
+/*!
+ * \brief Parses a root array into a std::vector using several threads.
+ *
+ * The parse and tokenizer options of context, like allow_missing_members and
+ * allowNewLineAsTokenDelimiter, are used for every chunk. Arenas are not
+ * shared with the worker threads. When parsing fails, context holds the error of the first failing
+ * element as if only its chunk had been parsed, and error_offset the offset
+ * of the error in the document.
+ */
+class ParallelParseContext
+{
+public:
+  ParallelParseContext(const char *data, size_t size)
+    : data(data)
+    , size(size)
+  {
+  }
+  explicit ParallelParseContext(const std::string &data)
+    : ParallelParseContext(data.data(), data.size())
+  {
+  }
+
+  template <typename T>
+  JS_NODISCARD Error parseTo(std::vector<T> &to_type);
+
+  std::string makeErrorString() const
+  {
+    return context.makeErrorString();
+  }
+
+  /* Number of threads to use, 0 uses std::thread::hardware_concurrency. */
+  size_t thread_count = 0;
+  /* Documents are not split into chunks smaller than this. */
+  size_t min_chunk_size = size_t(256) << 10;
+
+  ParseContext context;
+  Error error = Error::NoError;
+  size_t error_offset = 0;
+
+private:
+  struct Chunk
+  {
+    size_t begin;
+    size_t end;
+  };
+
+  bool splitRootArray(size_t chunk_count, std::vector<Chunk> &chunks) const;
+  void prepareChunkContext(ParseContext &chunk_context, const Chunk &chunk) const;
+
+  template <typename T>
+  Error parseSerial(std::vector<T> &to_type);
+
+  const char *data;
+  size_t size;
+};
+
+/* Finds the element boundaries of the root array and splits them into at
+ * most chunk_count chunks. Each chunk holds whole elements without the commas
+ * separating it from its neighbours. Returns false when the root is not an
+ * array, or the structure can not be split. */
+inline bool ParallelParseContext::splitRootArray(size_t chunk_count, std::vector<Chunk> &chunks) const
+{
+  size_t start = 0;
+  while (start < size && (Internal::lookup()[(unsigned char)data[start]] & Internal::WhiteSpaceOrNull))
+    start++;
+  if (start == size || data[start] != '[')
+    return false;
+
+  Internal::StructuralIndex index;
+  index.build(data, size, start, false, false);
+  if (!index.valid)
+    return false;
+
+  size_t target = size / chunk_count;
+  size_t chunk_begin = start + 1;
+  int depth = 0;
+  for (size_t pos = index.nextEntry(start); pos < size; pos = index.nextEntry(pos + 1))
+  {
+    switch (data[pos])
+    {
+    case '[':
+    case '{':
+      depth++;
+      break;
+    case ']':
+    case '}':
+      depth--;
+      if (depth == 0)
+      {
+        if (data[pos] != ']')
+          return false;
+        chunks.push_back({chunk_begin, pos});
+        return true;
+      }
+      if (depth < 0)
+        return false;
+      break;
+    case ',':
+      if (depth == 1 && pos >= target && chunks.size() + 1 < chunk_count)
+      {
+        chunks.push_back({chunk_begin, pos});
+        chunk_begin = pos + 1;
+        target = pos + (size - pos) / (chunk_count - chunks.size());
+      }
+      break;
+    default:
+      break;
+    }
+  }
+  return false;
+}
+
+inline void ParallelParseContext::prepareChunkContext(ParseContext &chunk_context, const Chunk &chunk) const
+{
+  static const char array_start[] = "[";
+  static const char array_end[] = "]";
+  chunk_context.allow_missing_members = context.allow_missing_members;
+  chunk_context.allow_unasigned_required_members = context.allow_unasigned_required_members;
+  chunk_context.track_member_assignement_state = context.track_member_assignement_state;
+  chunk_context.fast_skip_missing_members = context.fast_skip_missing_members;
+  chunk_context.stop_after_projected_members = context.stop_after_projected_members;
+  chunk_context.user_data = context.user_data;
+  if (&chunk_context != &context)
+    chunk_context.tokenizer.copyOptions(context.tokenizer);
+  chunk_context.reset(array_start, 1);
+  chunk_context.tokenizer.addData(data + chunk.begin, chunk.end - chunk.begin);
+  chunk_context.tokenizer.addData(array_end, 1);
+}
+
+template <typename T>
+inline Error ParallelParseContext::parseSerial(std::vector<T> &to_type)
+{
+  context.reset(data, size);
+  error = context.parseTo(to_type);
+  if (error != Error::NoError)
+  {
+    const char *position = context.tokenizer.currentPosition();
+    error_offset = position >= data && position <= data + size ? size_t(position - data) : size;
+  }
+  return error;
+}
+
+template <typename T>
+inline Error ParallelParseContext::parseTo(std::vector<T> &to_type)
+{
+  error = Error::NoError;
+  error_offset = 0;
+  size_t threads = thread_count ? thread_count : size_t(std::thread::hardware_concurrency());
+  size_t chunk_count = std::min(std::max(threads, size_t(1)), size / std::max(min_chunk_size, size_t(1)));
+  std::vector<Chunk> chunks;
+  if (chunk_count < 2 || !splitRootArray(chunk_count, chunks) || chunks.size() < 2)
+    return parseSerial(to_type);
+
+  std::vector<std::vector<T>> results(chunks.size());
+  std::vector<std::unique_ptr<ParseContext>> contexts(chunks.size());
+  std::vector<Error> errors(chunks.size(), Error::NoError);
+  auto parse_chunk = [this, &chunks, &results, &contexts, &errors](size_t i) {
+    contexts[i].reset(new ParseContext());
+    prepareChunkContext(*contexts[i], chunks[i]);
+    errors[i] = contexts[i]->parseTo(results[i]);
+  };
+
+  std::vector<std::thread> workers;
+  workers.reserve(chunks.size() - 1);
+  for (size_t i = 1; i < chunks.size(); i++)
+    workers.emplace_back(parse_chunk, i);
+  parse_chunk(0);
+  for (auto &worker : workers)
+    worker.join();
+
+  context.missing_members.clear();
+  context.unassigned_required_members.clear();
+  for (size_t i = 0; i < chunks.size(); i++)
+  {
+    if (errors[i] != Error::NoError)
+    {
+      // Parse the failing chunk again with the callers context, so it holds
+      // the complete error information.
+      prepareChunkContext(context, chunks[i]);
+      std::vector<T> discarded;
+      error = context.parseTo(discarded);
+      // The chunk failed in the worker, so it must not be reported as parsed
+      // even if the parse with the callers context differs.
+      if (error == Error::NoError)
+      {
+        error = errors[i];
+        context.error = error;
+      }
+      const char *position = context.tokenizer.currentPosition();
+      if (position >= data + chunks[i].begin && position <= data + chunks[i].end)
+        error_offset = size_t(position - data);
+      else
+        error_offset = chunks[i].end;
+      return error;
+    }
+    for (auto &member : contexts[i]->missing_members)
+      context.missing_members.push_back(std::move(member));
+    for (auto &member : contexts[i]->unassigned_required_members)
+      context.unassigned_required_members.push_back(std::move(member));
+  }
+
+  size_t total = 0;
+  for (auto &result : results)
+    total += result.size();
+  to_type.clear();
+  to_type.reserve(total);
+  for (auto &result : results)
+    std::move(result.begin(), result.end(), std::back_inserter(to_type));
+  context.error = Error::NoError;
+  return error;
+}
+
+/* Parses the root array in data into to_type with thread_count threads, 0
+ * meaning one per hardware thread. */
+template <typename T>
+JS_NODISCARD inline Error parallelParseTo(const char *data, size_t size, std::vector<T> &to_type,
+                                          size_t thread_count = 0)
+{
+  ParallelParseContext context(data, size);
+  context.thread_count = thread_count;
+  return context.parseTo(to_type);
+}
+namespace Internal
+{
+template <typename T, typename A>
+inline void serializeSlice(const std::vector<T, A> &vec, size_t begin, size_t end, const SerializerOptions &options,
+                           std::string &out)
+{
+  Serializer serializer;
+  serializer.useStringBuffer(out);
+  serializer.setOptions(options);
+  Token token;
+  if (begin == 0)
+  {
+    token.value_type = Type::ArrayStart;
+    token.value = DataRef("[");
+    serializer.write(token);
+  }
+  else
+  {
+    serializer.resume(options.depth() + 1, true);
+  }
+
+  token.name = DataRef("");
+  for (size_t i = begin; i < end; i++)
+    TypeHandler<T>::from(vec[i], token, serializer);
+
+  if (end == vec.size())
+  {
+    token.name = DataRef("");
+    token.value_type = Type::ArrayEnd;
+    token.value = DataRef("]");
+    serializer.write(token);
+  }
+  serializer.flushStringBuffer();
+}
+} // namespace Internal
+
+/*!
+ * Serializes vec on thread_count threads, 0 meaning one per hardware thread,
+ * into consecutive chunks that joined together are identical to the output of
+ * serializeStruct(vec, options). The chunks can be written out one after the
+ * other, for instance with writev, without joining them. Vectors shorter than
+ * min_chunk_elements per thread are serialized into fewer chunks.
+ */
+template <typename T, typename A>
+JS_NODISCARD inline std::vector<std::string> serializeStructChunks(const std::vector<T, A> &vec,
+                                                                   const SerializerOptions &options,
+                                                                   size_t thread_count = 0,
+                                                                   size_t min_chunk_elements = 1024)
+{
+  size_t threads = thread_count ? thread_count : size_t(std::thread::hardware_concurrency());
+  size_t chunk_count =
+    std::max(size_t(1), std::min(std::max(threads, size_t(1)), vec.size() / std::max(min_chunk_elements, size_t(1))));
+  std::vector<std::string> chunks(chunk_count);
+  auto serialize_chunk = [&vec, &options, &chunks, chunk_count](size_t i) {
+    size_t begin = vec.size() * i / chunk_count;
+    size_t end = vec.size() * (i + 1) / chunk_count;
+    Internal::serializeSlice(vec, begin, end, options, chunks[i]);
+  };
+
+  std::vector<std::thread> workers;
+  workers.reserve(chunk_count - 1);
+  for (size_t i = 1; i < chunk_count; i++)
+    workers.emplace_back(serialize_chunk, i);
+  serialize_chunk(0);
+  for (auto &worker : workers)
+    worker.join();
+  return chunks;
+}
+
+template <typename T, typename A>
+JS_NODISCARD inline std::string serializeStructParallel(const std::vector<T, A> &vec,
+                                                        const SerializerOptions &options = SerializerOptions(),
+                                                        size_t thread_count = 0)
+{
+  std::vector<std::string> chunks = serializeStructChunks(vec, options, thread_count);
+  if (chunks.size() == 1)
+    return std::move(chunks.front());
+  size_t size = 0;
+  for (auto &chunk : chunks)
+    size += chunk.size();
+  std::string json;
+  json.reserve(size);
+  for (auto &chunk : chunks)
+    json += chunk;
+  return json;
+}
+} // namespace JS
+
+#endif // JSON_STRUCT_PARALLEL_H
@@ -388,3 +388,171 @@ TEST_CASE("Benchmarks", "[performance]")
 
 }
 
+
+namespace
+{
+struct LogLine
+{
+  int64_t timestamp;
+  std::string level;
+  std::string message;
+  int status;
+  double latency;
+  JS_OBJ(timestamp, level, message, status, latency);
+};
+
+static std::string generateJsonLines(size_t lines)
+{
+  static const char *levels[] = {"debug", "info", "warning", "error"};
+  std::string json;
+  json.reserve(lines * 100);
+  char buffer[256];
+  for (size_t i = 0; i < lines; i++)
+  {
+    int size = snprintf(buffer, sizeof(buffer),
+                        "{\"timestamp\":%lld,\"level\":\"%s\",\"message\":\"request %zu handled\",\"status\":%d,"
+                        "\"latency\":%.3f}\n",
+                        1600000000000ll + (long long)i * 7, levels[i % 4], i, 200 + int(i % 5) * 100,
+                        double(i % 1000) / 7.0);
+    json.append(buffer, size_t(size));
+  }
+  return json;
+}
+
+// Benchmarks reading line_count lines with the JsonLinesReader and with a
+// ParseContext per line.
+static void benchmarkJsonLines(size_t line_count)
+{
+  std::string json = generateJsonLines(line_count);
+
+  BENCHMARK("JsonStruct_JsonLinesReader")
+  {
+    size_t parsed = JS::parseJsonLines<LogLine>(
+      json.data(), json.size(), [](LogLine &, size_t) {}, [](const JS::ParseContext &, size_t) {});
+    REQUIRE(parsed == line_count);
+    return parsed;
+  };
+
+  BENCHMARK("JsonStruct_ParseContext_PerLine")
+  {
+    size_t parsed = 0;
+    size_t position = 0;
+    while (position < json.size())
+    {
+      size_t newline = json.find('\n', position);
+      JS::ParseContext context(json.data() + position, newline - position);
+      LogLine line;
+      if (context.parseTo(line) == JS::Error::NoError)
+        parsed++;
+      position = newline + 1;
+    }
+    REQUIRE(parsed == line_count);
+    return parsed;
+  };
+}
+} // namespace
+
+TEST_CASE("JsonLines", "[performance]")
+{
+  benchmarkJsonLines(100000);
+}
+
+// About 200 MB of input, so it only runs when asked for by name.
+TEST_CASE("JsonLinesLarge", "[.][performance]")
+{
+  benchmarkJsonLines(2000000);
+}
+
+namespace
+{
+static std::string generateNestedJson(size_t documents, size_t depth)
+{
+  std::string json = "[";
+  for (size_t i = 0; i < documents; i++)
+  {
+    if (i)
+      json += ",";
+    for (size_t d = 0; d < depth; d++)
+      json += d % 2 ? "{\"value\":" : "[1,";
+    json += "true";
+    for (size_t d = depth; d > 0; d--)
+      json += (d - 1) % 2 ? ",\"after\":2}" : "]";
+  }
+  json += "]";
+  return json;
+}
+
+static std::string generateWideJson(size_t elements)
+{
+  std::string json = "[";
+  for (size_t i = 0; i < elements; i++)
+  {
+    if (i)
+      json += ",";
+    json += "{\"id\":" + std::to_string(i) + ",\"tags\":[\"a\",\"b\"],\"position\":{\"x\":1,\"y\":2}}";
+  }
+  json += "]";
+  return json;
+}
+
+} // namespace
+
+TEST_CASE("MetaForTokens", "[performance]")
+{
+  // The tokens point into the json, so it has to outlive them.
+  std::string depth_128_json = generateNestedJson(2000, 128);
+  std::string depth_512_json = generateNestedJson(500, 512);
+  std::string wide_json = generateWideJson(100000);
+  JS::JsonTokens depth_128;
+  JS::JsonTokens depth_512;
+  JS::JsonTokens wide;
+  REQUIRE(JS::ParseContext(depth_128_json).parseTo(depth_128) == JS::Error::NoError);
+  REQUIRE(JS::ParseContext(depth_512_json).parseTo(depth_512) == JS::Error::NoError);
+  REQUIRE(JS::ParseContext(wide_json).parseTo(wide) == JS::Error::NoError);
+
+  BENCHMARK("JsonStruct_MetaForTokens_Depth128")
+  {
+    return JS::metaForTokens(depth_128);
+  };
+
+  BENCHMARK("JsonStruct_MetaForTokens_Depth512")
+  {
+    return JS::metaForTokens(depth_512);
+  };
+
+  BENCHMARK("JsonStruct_MetaForTokens_Wide")
+  {
+    return JS::metaForTokens(wide);
+  };
+}
+
+TEST_CASE("SerializeIntegerArrays", "[performance]")
+{
+  std::vector<int64_t> twelve_digits(20000);
+  std::vector<int64_t> mixed(20000);
+  std::vector<int32_t> small(20000);
+  uint64_t state = 1;
+  for (size_t i = 0; i < mixed.size(); i++)
+  {
+    state = state * 6364136223846793005ull + 1442695040888963407ull;
+    twelve_digits[i] = int64_t(100000000000 + (state >> 16) % 900000000000);
+    mixed[i] = int64_t(state) >> (state >> 58);
+    small[i] = int32_t((state >> 32) % 1000);
+  }
+  JS::SerializerOptions compact(JS::SerializerOptions::Compact);
+
+  BENCHMARK("JsonStruct_Serialize_TwelveDigitArray")
+  {
+    return JS::serializeStruct(twelve_digits, compact);
+  };
+
+  BENCHMARK("JsonStruct_Serialize_MixedIntegerArray")
+  {
+    return JS::serializeStruct(mixed, compact);
+  };
+
+  BENCHMARK("JsonStruct_Serialize_SmallIntegerArray")
+  {
+    return JS::serializeStruct(small, compact);
+  };
+}
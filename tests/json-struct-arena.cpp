@@ -0,0 +1,189 @@
+/*
+ * Copyright � 2021 Jorgen Lind
+ *
+ * Permission to use, copy, modify, distribute, and sell this software and its
+ * documentation for any purpose is hereby granted without fee, provided that
+ * the above copyright notice appear in all copies and that both that copyright
+ * notice and this permission notice appear in supporting documentation, and
+ * that the name of the copyright holders not be used in advertising or
+ * publicity pertaining to distribution of the software without specific,
+ * written prior permission.  The copyright holders make no representations
+ * about the suitability of this software for any purpose.  It is provided "as
+ * is" without express or implied warranty.
+ *
+ * THE COPYRIGHT HOLDERS DISCLAIM ALL WARRANTIES WITH REGARD TO THIS SOFTWARE,
+ * INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS, IN NO
+ * EVENT SHALL THE COPYRIGHT HOLDERS BE LIABLE FOR ANY SPECIAL, INDIRECT OR
+ * CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE,
+ * DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER
+ * TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE
+ * OF THIS SOFTWARE.
+ */
+
+#define JS_STL_MAP
+#include <json_struct/json_struct.h>
+
+#include "catch2/catch.hpp"
+
+#if __cplusplus >= 201703L && __has_include(<memory_resource>)
+#include <memory_resource>
+#define JS_TEST_PMR 1
+#endif
+
+namespace
+{
+
+using ArenaMap = std::map<JS::ArenaString, JS::ArenaVector<int>, std::less<JS::ArenaString>,
+                          JS::ArenaAllocator<std::pair<const JS::ArenaString, JS::ArenaVector<int>>>>;
+
+struct Request
+{
+  JS::ArenaString method;
+  JS::ArenaVector<JS::ArenaString> tags;
+  ArenaMap counters;
+
+  JS_OBJ(method, tags, counters);
+};
+
+const char requests_json[] = R"json([
+  {
+    "method": "a method name that does not fit in the small string buffer",
+    "tags": [ "first tag that is too long for the small string buffer", "second" ],
+    "counters": { "one": [ 1 ], "two": [ 1, 2 ], "one": [ 3, 4, 5 ] }
+  },
+  {
+    "method": "get",
+    "tags": [],
+    "counters": {}
+  }
+])json";
+
+TEST_CASE("arena_containers_allocate_from_context_arena", "[json_struct][arena]")
+{
+  JS::Arena arena;
+  JS::ArenaVector<Request> requests{JS::ArenaAllocator<Request>(&arena)};
+  JS::ParseContext context(requests_json);
+  context.arena = &arena;
+  REQUIRE(context.parseTo(requests) == JS::Error::NoError);
+  REQUIRE(JS::Arena::current() == nullptr);
+
+  REQUIRE(requests.size() == 2);
+  REQUIRE(arena.owns(requests.data()));
+  const Request &request = requests[0];
+  REQUIRE(request.method == "a method name that does not fit in the small string buffer");
+  REQUIRE(arena.owns(request.method.data()));
+  REQUIRE(request.tags.size() == 2);
+  REQUIRE(arena.owns(request.tags.data()));
+  REQUIRE(arena.owns(request.tags[0].data()));
+  REQUIRE(request.counters.size() == 2);
+  REQUIRE(request.counters.at("one") == JS::ArenaVector<int>({3, 4, 5}));
+  REQUIRE(arena.owns(request.counters.at("two").data()));
+  REQUIRE(requests[1].method == "get");
+
+  std::string serialized = JS::serializeStruct(requests[0], JS::SerializerOptions(JS::SerializerOptions::Compact));
+  REQUIRE(serialized == R"json({"method":"a method name that does not fit in the small string buffer",)json"
+                        R"json("tags":["first tag that is too long for the small string buffer","second"],)json"
+                        R"json("counters":{"one":[3,4,5],"two":[1,2]}})json");
+}
+
+TEST_CASE("arena_default_constructed_containers_bind_to_context_arena", "[json_struct][arena]")
+{
+  JS::Arena arena;
+  JS::ArenaVector<Request> requests;
+  REQUIRE(requests.get_allocator().arena == nullptr);
+  JS::ParseContext context(requests_json);
+  context.arena = &arena;
+  REQUIRE(context.parseTo(requests) == JS::Error::NoError);
+  REQUIRE(requests.get_allocator().arena == &arena);
+  REQUIRE(arena.owns(requests.data()));
+  REQUIRE(arena.owns(requests[0].method.data()));
+  REQUIRE(arena.owns(requests[0].tags[0].data()));
+  REQUIRE(requests[0].counters.get_allocator().arena == &arena);
+  REQUIRE(requests[0].counters.begin()->first.get_allocator().arena == &arena);
+  REQUIRE(arena.owns(requests[0].counters.at("two").data()));
+
+  // A container with an arena of its own keeps it.
+  JS::Arena own_arena;
+  JS::ArenaVector<int> numbers{JS::ArenaAllocator<int>(&own_arena)};
+  JS::ParseContext numbers_context("[ 1, 2, 3 ]");
+  numbers_context.arena = &arena;
+  REQUIRE(numbers_context.parseTo(numbers) == JS::Error::NoError);
+  REQUIRE(numbers.get_allocator().arena == &own_arena);
+  REQUIRE(own_arena.owns(numbers.data()));
+}
+
+TEST_CASE("arena_containers_without_arena_use_heap", "[json_struct][arena]")
+{
+  JS::Arena arena;
+  std::vector<Request> requests;
+  JS::ParseContext context(requests_json);
+  REQUIRE(context.parseTo(requests) == JS::Error::NoError);
+  REQUIRE(requests.size() == 2);
+  REQUIRE(requests[0].tags[0] == "first tag that is too long for the small string buffer");
+  REQUIRE(requests[0].tags.get_allocator().arena == nullptr);
+  REQUIRE(!arena.owns(requests[0].tags.data()));
+
+  JS::ArenaScope scope(&arena);
+  Request root;
+  REQUIRE(root.tags.get_allocator().arena == &arena);
+}
+
+#ifdef JS_TEST_PMR
+struct PmrRequest
+{
+  std::pmr::string method;
+  std::pmr::vector<std::pmr::string> tags;
+  JS_OBJ(method, tags);
+};
+
+TEST_CASE("arena_pmr_containers_bind_to_context_arena", "[json_struct][arena]")
+{
+  JS::Arena arena;
+  std::pmr::vector<PmrRequest> requests;
+  JS::ParseContext context(requests_json);
+  context.arena = &arena;
+  REQUIRE(context.parseTo(requests) == JS::Error::NoError);
+  REQUIRE(requests.get_allocator().resource() == &arena);
+  REQUIRE(requests.size() == 2);
+  REQUIRE(arena.owns(requests.data()));
+  REQUIRE(requests[0].method == "a method name that does not fit in the small string buffer");
+  REQUIRE(requests[0].method.get_allocator().resource() == &arena);
+  REQUIRE(arena.owns(requests[0].method.data()));
+  REQUIRE(requests[0].tags.get_allocator().resource() == &arena);
+  REQUIRE(arena.owns(requests[0].tags[0].data()));
+
+  // A container with a memory resource of its own keeps it.
+  std::pmr::monotonic_buffer_resource resource;
+  std::pmr::vector<std::pmr::string> tags(&resource);
+  JS::ParseContext tags_context(R"json([ "tag" ])json");
+  tags_context.arena = &arena;
+  REQUIRE(tags_context.parseTo(tags) == JS::Error::NoError);
+  REQUIRE(tags.get_allocator().resource() == &resource);
+  REQUIRE(tags[0].get_allocator().resource() == &resource);
+}
+
+TEST_CASE("arena_pmr_containers_propagate_resource", "[json_struct][arena]")
+{
+  // Only containers propagate the memory resource to their elements, so the
+  // whole tree has to be made of allocator aware types.
+  std::pmr::monotonic_buffer_resource resource;
+  std::pmr::vector<std::pmr::vector<std::pmr::string>> tags(&resource);
+  JS::ParseContext context(R"json([ [ "first tag that is too long for the small string buffer", "second" ], [] ])json");
+  REQUIRE(context.parseTo(tags) == JS::Error::NoError);
+  REQUIRE(tags.size() == 2);
+  REQUIRE(tags[0].size() == 2);
+  REQUIRE(tags[0][0] == "first tag that is too long for the small string buffer");
+  REQUIRE(tags[0].get_allocator().resource() == &resource);
+  REQUIRE(tags[0][1].get_allocator().resource() == &resource);
+
+  std::pmr::map<std::pmr::string, std::pmr::vector<int>> counters(&resource);
+  JS::ParseContext map_context(R"json({ "one": [ 1 ], "two": [ 2, 3 ] })json");
+  REQUIRE(map_context.parseTo(counters) == JS::Error::NoError);
+  REQUIRE(counters.size() == 2);
+  REQUIRE(counters.at("two").size() == 2);
+  REQUIRE(counters.begin()->first.get_allocator().resource() == &resource);
+  REQUIRE(counters.at("two").get_allocator().resource() == &resource);
+}
+#endif
+
+} // namespace
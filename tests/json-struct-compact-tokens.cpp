@@ -0,0 +1,177 @@
+/*
+ * Copyright � 2021 Jorgen Lind
+ *
+ * Permission to use, copy, modify, distribute, and sell this software and its
+ * documentation for any purpose is hereby granted without fee, provided that
+ * the above copyright notice appear in all copies and that both that copyright
+ * notice and this permission notice appear in supporting documentation, and
+ * that the name of the copyright holders not be used in advertising or
+ * publicity pertaining to distribution of the software without specific,
+ * written prior permission.  The copyright holders make no representations
+ * about the suitability of this software for any purpose.  It is provided "as
+ * is" without express or implied warranty.
+ *
+ * THE COPYRIGHT HOLDERS DISCLAIM ALL WARRANTIES WITH REGARD TO THIS SOFTWARE,
+ * INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS, IN NO
+ * EVENT SHALL THE COPYRIGHT HOLDERS BE LIABLE FOR ANY SPECIAL, INDIRECT OR
+ * CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE,
+ * DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER
+ * TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE
+ * OF THIS SOFTWARE.
+ */
+
+#include <json_struct/json_struct.h>
+
+#include "catch2/catch.hpp"
+
+namespace
+{
+static const char json[] = R"json(
+{
+  "name": "compact",
+  "escaped": "a \"quoted\" word",
+  "count": 42,
+  "enabled": true,
+  "nothing": null,
+  "values": [ 1, 2, [ 3, 4 ], { "five": 5 } ],
+  "child": { "name": "inner", "count": 7, "values": [] },
+  "last": 1.5
+}
+)json";
+
+struct Child
+{
+  std::string name;
+  int count = 0;
+  std::vector<int> values;
+  JS_OBJ(name, count, values);
+};
+
+struct Root
+{
+  std::string name;
+  std::string escaped;
+  int count = 0;
+  bool enabled = false;
+  Child child;
+  double last = 0;
+  JS_OBJ(name, escaped, count, enabled, child, last);
+};
+
+static std::string str(const JS::DataRef &ref)
+{
+  return std::string(ref.data, ref.size);
+}
+
+static void requireSameTokens(const JS::JsonTokens &tokens, const JS::CompactJsonTokens &compact)
+{
+  REQUIRE(tokens.data.size() == compact.size());
+  for (size_t i = 0; i < tokens.data.size(); i++)
+  {
+    INFO("token " << i);
+    JS::Token token = compact[i];
+    REQUIRE(token.name_type == tokens.data[i].name_type);
+    REQUIRE(token.value_type == tokens.data[i].value_type);
+    REQUIRE(str(token.name) == str(tokens.data[i].name));
+    REQUIRE(str(token.value) == str(tokens.data[i].value));
+  }
+}
+
+TEST_CASE("compact_tokens_parse", "[json_struct][compact_tokens]")
+{
+  STATIC_REQUIRE(sizeof(JS::CompactToken) == 16);
+
+  JS::JsonTokens tokens;
+  JS::ParseContext context(json);
+  REQUIRE(context.parseTo(tokens) == JS::Error::NoError);
+
+  JS::CompactJsonTokens compact;
+  JS::ParseContext compact_context(json);
+  REQUIRE(compact_context.parseTo(compact) == JS::Error::NoError);
+  requireSameTokens(tokens, compact);
+  REQUIRE(compact.baseData() == json);
+
+  // The values point into the parsed json, not into a copy.
+  for (size_t i = 0; i < compact.size(); i++)
+  {
+    JS::Token token = compact[i];
+    REQUIRE(token.value.data >= json);
+    REQUIRE(token.value.data + token.value.size <= json + sizeof(json));
+  }
+}
+
+TEST_CASE("compact_tokens_copy_data_outside_of_base", "[json_struct][compact_tokens]")
+{
+  JS::CompactJsonTokens compact;
+  JS::JsonTokens tokens;
+  {
+    std::string copy(json);
+    JS::ParseContext context(copy);
+    REQUIRE(context.parseTo(tokens) == JS::Error::NoError);
+    for (auto &token : tokens.data)
+      REQUIRE(compact.push_back(token));
+    context.reset(json, sizeof(json) - 1);
+    JS::JsonTokens original;
+    REQUIRE(context.parseTo(original) == JS::Error::NoError);
+    tokens = original;
+  }
+  requireSameTokens(tokens, compact);
+}
+
+TEST_CASE("compact_tokens_tokenizer", "[json_struct][compact_tokens]")
+{
+  JS::CompactJsonTokens compact;
+  JS::ParseContext context(json);
+  REQUIRE(context.parseTo(compact) == JS::Error::NoError);
+
+  JS::ParseContext from_tape;
+  from_tape.tokenizer.resetData(&compact, 0);
+  Root root;
+  REQUIRE(from_tape.parseTo(root) == JS::Error::NoError);
+  REQUIRE(root.name == "compact");
+  REQUIRE(root.escaped == "a \"quoted\" word");
+  REQUIRE(root.count == 42);
+  REQUIRE(root.enabled);
+  REQUIRE(root.child.name == "inner");
+  REQUIRE(root.child.count == 7);
+  REQUIRE(root.last == 1.5);
+  REQUIRE(from_tape.missing_members.size() == 2);
+}
+
+TEST_CASE("compact_map", "[json_struct][compact_tokens]")
+{
+  JS::Map map;
+  JS::ParseContext map_context(json);
+  REQUIRE(map_context.parseTo(map) == JS::Error::NoError);
+
+  JS::CompactMap compact_map;
+  JS::ParseContext compact_context(json);
+  REQUIRE(compact_context.parseTo(compact_map) == JS::Error::NoError);
+  REQUIRE(compact_map.meta.size() == map.meta.size());
+
+  std::vector<std::string> names;
+  std::vector<std::string> compact_names;
+  for (auto &token : map)
+    names.push_back(str(token.name));
+  for (auto it = compact_map.begin(); it != compact_map.end(); ++it)
+    compact_names.push_back(str(it->name));
+  REQUIRE(names[0] == "name");
+  REQUIRE(names[7] == "last");
+  REQUIRE(compact_names == names);
+
+  JS::ParseContext context;
+  Child child;
+  REQUIRE(compact_map.castToType("child", context, child) == JS::Error::NoError);
+  REQUIRE(child.name == "inner");
+  REQUIRE(child.count == 7);
+  REQUIRE(compact_map.castTo<int>("count", context) == 42);
+  REQUIRE(compact_map.castTo<std::string>("escaped", context) == "a \"quoted\" word");
+  REQUIRE(compact_map.castToType("missing", context, child) == JS::Error::KeyNotFound);
+
+  Root root;
+  REQUIRE(compact_map.castToType(context, root) == JS::Error::NoError);
+  REQUIRE(root.last == 1.5);
+
+  REQUIRE(JS::serializeStruct(compact_map) == JS::serializeStruct(map));
+}
+} // namespace
@@ -0,0 +1,142 @@
+/*
+ * Copyright � 2021 Jorgen Lind
+ *
+ * Permission to use, copy, modify, distribute, and sell this software and its
+ * documentation for any purpose is hereby granted without fee, provided that
+ * the above copyright notice appear in all copies and that both that copyright
+ * notice and this permission notice appear in supporting documentation, and
+ * that the name of the copyright holders not be used in advertising or
+ * publicity pertaining to distribution of the software without specific,
+ * written prior permission.  The copyright holders make no representations
+ * about the suitability of this software for any purpose.  It is provided "as
+ * is" without express or implied warranty.
+ *
+ * THE COPYRIGHT HOLDERS DISCLAIM ALL WARRANTIES WITH REGARD TO THIS SOFTWARE,
+ * INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS, IN NO
+ * EVENT SHALL THE COPYRIGHT HOLDERS BE LIABLE FOR ANY SPECIAL, INDIRECT OR
+ * CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE,
+ * DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER
+ * TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE
+ * OF THIS SOFTWARE.
+ */
+
+#include <json_struct/json_struct.h>
+
+#include "catch2/catch.hpp"
+
+namespace
+{
+
+struct Message
+{
+  int id = 0;
+  std::string name;
+  std::vector<int> values;
+
+  JS_OBJ(id, name, values);
+};
+
+TEST_CASE("context_reset_reuses_context", "[json_struct][context_reset]")
+{
+  JS::ParseContext context;
+  context.allow_missing_members = false;
+  for (int i = 0; i < 3; i++)
+  {
+    std::string json = R"json({ "id": )json" + std::to_string(i) + R"json(, "name": "message", "values": [ 1, 2 ] })json";
+    context.reset(json);
+    Message message;
+    REQUIRE(context.parseTo(message) == JS::Error::NoError);
+    REQUIRE(message.id == i);
+    REQUIRE(message.name == "message");
+    REQUIRE(message.values.size() == 2);
+  }
+
+  // An unknown member stops the parse in the middle of the object, the next
+  // document should not see any of that state.
+  const char unknown_member[] = R"json({ "id": 1, "unknown": { "nested": [ 1, 2 ] }, "name": "x" })json";
+  context.reset(unknown_member, sizeof(unknown_member) - 1);
+  Message message;
+  REQUIRE(context.parseTo(message) == JS::Error::MissingPropertyMember);
+  REQUIRE(context.missing_members.size() == 1);
+  REQUIRE(context.makeErrorString().size());
+  size_t missing_capacity = context.missing_members.capacity();
+
+  const char next[] = R"json({ "id": 2, "name": "next", "values": [] })json";
+  context.reset(next, sizeof(next) - 1);
+  REQUIRE(context.missing_members.size() == 0);
+  REQUIRE(context.missing_members.capacity() == missing_capacity);
+  REQUIRE(context.error == JS::Error::NoError);
+  REQUIRE(context.tokenizer.errorContext().error == JS::Error::NoError);
+  Message next_message;
+  REQUIRE(context.parseTo(next_message) == JS::Error::NoError);
+  REQUIRE(next_message.id == 2);
+  REQUIRE(next_message.name == "next");
+  REQUIRE(context.allow_missing_members == false);
+}
+
+TEST_CASE("context_reset_after_split_buffer", "[json_struct][context_reset]")
+{
+  const char json[] = R"json({ "id": 1, "name": "split name", "values": [ 3 ] })json";
+  JS::ParseContext context;
+  context.tokenizer.addData(json, 20);
+  Message message;
+  REQUIRE(context.parseTo(message) == JS::Error::NeedMoreData);
+
+  context.reset(json, sizeof(json) - 1);
+  REQUIRE(context.parseTo(message) == JS::Error::NoError);
+  REQUIRE(message.id == 1);
+  REQUIRE(message.name == "split name");
+  REQUIRE(message.values.size() == 1);
+}
+
+TEST_CASE("context_pool_hands_out_distinct_contexts", "[json_struct][context_reset]")
+{
+  const char json[] = R"json({ "id": 7, "name": "pooled", "values": [ 1 ] })json";
+  JS::ParseContext *first_context;
+  {
+    JS::PooledParseContext pooled(json, sizeof(json) - 1);
+    first_context = &*pooled;
+    pooled->allow_missing_members = false;
+    Message message;
+    REQUIRE(pooled.parseTo(message) == JS::Error::NoError);
+    REQUIRE(message.id == 7);
+
+    JS::PooledParseContext nested(json, sizeof(json) - 1);
+    REQUIRE(&*nested != first_context);
+    Message nested_message;
+    REQUIRE(nested.parseTo(nested_message) == JS::Error::NoError);
+    REQUIRE(nested_message.name == "pooled");
+  }
+
+  std::string other = R"json({ "id": 8, "extra": true })json";
+  JS::PooledParseContext pooled(other);
+  REQUIRE(pooled->allow_missing_members);
+  Message message;
+  REQUIRE(pooled.parseTo(message) == JS::Error::NoError);
+  REQUIRE(message.id == 8);
+  REQUIRE(pooled->missing_members.size() == 1);
+}
+
+TEST_CASE("pooled_context_restores_tokenizer_options", "[json_struct][reset]")
+{
+  const char json[] = R"json({ "id": 7, "name": "pooled", "values": [ 1, ], })json";
+  JS::Arena arena;
+  {
+    JS::PooledParseContext pooled(json, sizeof(json) - 1);
+    pooled->tokenizer.allowSuperfluousComma(true);
+    pooled->tokenizer.useStructuralIndex(true);
+    pooled->fast_skip_missing_members = true;
+    pooled->arena = &arena;
+    Message message;
+    REQUIRE(pooled.parseTo(message) == JS::Error::NoError);
+    REQUIRE(message.values.size() == 1);
+  }
+
+  JS::PooledParseContext pooled(json, sizeof(json) - 1);
+  REQUIRE(!pooled->fast_skip_missing_members);
+  REQUIRE(pooled->arena == nullptr);
+  Message message;
+  REQUIRE(pooled.parseTo(message) != JS::Error::NoError);
+}
+
+} // namespace
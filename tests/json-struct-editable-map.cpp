@@ -0,0 +1,176 @@
+/*
+ * Copyright � 2021 Jorgen Lind
+ *
+ * Permission to use, copy, modify, distribute, and sell this software and its
+ * documentation for any purpose is hereby granted without fee, provided that
+ * the above copyright notice appear in all copies and that both that copyright
+ * notice and this permission notice appear in supporting documentation, and
+ * that the name of the copyright holders not be used in advertising or
+ * publicity pertaining to distribution of the software without specific,
+ * written prior permission.  The copyright holders make no representations
+ * about the suitability of this software for any purpose.  It is provided "as
+ * is" without express or implied warranty.
+ *
+ * THE COPYRIGHT HOLDERS DISCLAIM ALL WARRANTIES WITH REGARD TO THIS SOFTWARE,
+ * INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS, IN NO
+ * EVENT SHALL THE COPYRIGHT HOLDERS BE LIABLE FOR ANY SPECIAL, INDIRECT OR
+ * CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE,
+ * DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER
+ * TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE
+ * OF THIS SOFTWARE.
+ */
+
+#include <json_struct/json_struct.h>
+
+#include "catch2/catch.hpp"
+
+namespace
+{
+struct Point
+{
+  int x = 0;
+  int y = 0;
+  JS_OBJ(x, y);
+};
+
+struct Document
+{
+  std::string name;
+  int count = 0;
+  Point point;
+  JS_OBJ(name, count, point);
+};
+
+const char json[] = R"json({
+  "name": "first",
+  "count": 3,
+  "point": { "x": 1, "y": 2 },
+  "list": [ 1, [ 2, 3 ], { "a": 4 } ],
+  "last": true
+})json";
+
+static bool pointsInto(const JS::DataRef &ref, const char *data, size_t size)
+{
+  return ref.data >= data && ref.data + ref.size <= data + size;
+}
+
+TEST_CASE("editable_map_parse", "[json_struct][map]")
+{
+  JS::EditableMap map;
+  JS::ParseContext context(json);
+  REQUIRE(context.parseTo(map) == JS::Error::NoError);
+  REQUIRE(map.members.size() == 5);
+  REQUIRE(std::string(map.members[3].name().data, map.members[3].name().size) == "list");
+  REQUIRE(map.members[3].tokens.size() == 10);
+
+  REQUIRE(map.castTo<std::string>("name", context) == "first");
+  REQUIRE(map.castTo<int>("count", context) == 3);
+  REQUIRE(map.castTo<Point>("point", context).y == 2);
+  REQUIRE(map.castTo<bool>("last", context));
+  int missing = 0;
+  REQUIRE(map.castToType("missing", context, missing) == JS::Error::KeyNotFound);
+  REQUIRE(map.find("missing") == nullptr);
+
+  Document document;
+  REQUIRE(map.castToType(context, document) == JS::Error::NoError);
+  REQUIRE(document.point.x == 1);
+  REQUIRE(document.count == 3);
+
+  std::string compact = JS::serializeStruct(map, JS::SerializerOptions(JS::SerializerOptions::Compact));
+  REQUIRE(compact == R"json({"name":"first","count":3,"point":{"x":1,"y":2},"list":[1,[2,3],{"a":4}],"last":true})json");
+}
+
+TEST_CASE("editable_map_set_value", "[json_struct][map]")
+{
+  JS::EditableMap map;
+  JS::ParseContext context(json);
+  REQUIRE(context.parseTo(map) == JS::Error::NoError);
+
+  Point point;
+  point.x = 10;
+  point.y = 20;
+  JS::ParseContext edit_context;
+  REQUIRE(map.setValue("count", edit_context, point) == JS::Error::NoError);
+  REQUIRE(map.setValue("name", edit_context, std::string("second")) == JS::Error::NoError);
+  REQUIRE(map.setValue("added", edit_context, 42) == JS::Error::NoError);
+  REQUIRE(map.setValue("added_point", edit_context, point) == JS::Error::NoError);
+  REQUIRE(map.members.size() == 7);
+
+  // The members that were not edited still point into the parsed json.
+  REQUIRE(pointsInto(map.members[2].tokens.front().value, json, sizeof(json)));
+  REQUIRE(pointsInto(map.members[3].tokens.back().value, json, sizeof(json)));
+  REQUIRE(!pointsInto(map.members[0].tokens.front().value, json, sizeof(json)));
+
+  REQUIRE(map.castTo<Point>("count", edit_context).y == 20);
+  REQUIRE(map.castTo<std::string>("name", edit_context) == "second");
+  REQUIRE(map.castTo<int>("added", edit_context) == 42);
+  REQUIRE(map.castTo<Point>("added_point", edit_context).x == 10);
+
+  REQUIRE(map.remove("last"));
+  REQUIRE(!map.remove("last"));
+  REQUIRE(map.castTo<int>("added", edit_context) == 42);
+
+  std::string compact = JS::serializeStruct(map, JS::SerializerOptions(JS::SerializerOptions::Compact));
+  REQUIRE(compact == R"json({"name":"second","count":{"x":10,"y":20},"point":{"x":1,"y":2},)json"
+                     R"json("list":[1,[2,3],{"a":4}],"added":42,"added_point":{"x":10,"y":20}})json");
+
+  JS::Map reparsed;
+  JS::ParseContext reparse_context(compact);
+  REQUIRE(reparse_context.parseTo(reparsed) == JS::Error::NoError);
+  REQUIRE(reparsed.castTo<int>("added", reparse_context) == 42);
+  REQUIRE(JS::serializeStruct(reparsed) == JS::serializeStruct(map));
+}
+
+TEST_CASE("editable_map_many_members", "[json_struct][map]")
+{
+  JS::EditableMap map;
+  JS::ParseContext context;
+  for (int i = 0; i < 200; i++)
+    REQUIRE(map.setValue("key_" + std::to_string(i), context, i) == JS::Error::NoError);
+  map.members.front().tokens.front().name = JS::DataRef("renamed");
+  map.rebuildIndex();
+  REQUIRE(map.find("key_0") == nullptr);
+  REQUIRE(map.castTo<int>("renamed", context) == 0);
+  for (int i = 1; i < 200; i++)
+    REQUIRE(map.castTo<int>("key_" + std::to_string(i), context) == i);
+  REQUIRE(map.remove("key_100"));
+  REQUIRE(map.find("key_100") == nullptr);
+  REQUIRE(map.castTo<int>("key_199", context) == 199);
+}
+
+TEST_CASE("editable_map_duplicate_keys", "[json_struct][map]")
+{
+  const char duplicate[] = R"json({ "a": 1, "b": 2, "a": 3 })json";
+  JS::EditableMap map;
+  JS::ParseContext context(duplicate);
+  REQUIRE(context.parseTo(map) == JS::Error::NoError);
+  REQUIRE(map.castTo<int>("a", context) == 1);
+  REQUIRE(map.setValue("a", context, 5) == JS::Error::NoError);
+  REQUIRE(map.members.size() == 3);
+  REQUIRE(map.castTo<int>("a", context) == 5);
+  REQUIRE(map.members[2].tokens.front().value.data[0] == '3');
+}
+
+TEST_CASE("editable_map_failed_parse_drops_index", "[json_struct][map]")
+{
+  JS::EditableMap map;
+  JS::ParseContext context(R"json({ "x": 1, "y": 2 })json");
+  REQUIRE(context.parseTo(map) == JS::Error::NoError);
+  REQUIRE(map.castTo<int>("y", context) == 2);
+
+  // Both members are parsed before the error, in the opposite order.
+  const char truncated[] = R"json({ "y": 3, "x": 4, )json";
+  JS::ParseContext truncated_context(truncated, sizeof(truncated) - 1);
+  REQUIRE(truncated_context.parseTo(map) != JS::Error::NoError);
+  REQUIRE(map.members.size() == 2);
+  REQUIRE(map.find("y") == &map.members[0]);
+  REQUIRE(map.find("x") == &map.members[1]);
+}
+
+TEST_CASE("editable_map_expects_object", "[json_struct][map]")
+{
+  JS::EditableMap map;
+  JS::ParseContext context("[ 1, 2 ]");
+  REQUIRE(context.parseTo(map) == JS::Error::ExpectedObjectStart);
+}
+} // namespace
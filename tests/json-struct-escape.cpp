@@ -60,4 +60,95 @@ TEST_CASE("test_forward_slash", "[json_struct][escape]")
 
 
 }
+static std::string reference_escape(const std::string &str)
+{
+  std::string ret;
+  for (char c : str)
+  {
+    switch (c)
+    {
+    case '\b': ret += "\\b"; break;
+    case '\t': ret += "\\t"; break;
+    case '\n': ret += "\\n"; break;
+    case '\f': ret += "\\f"; break;
+    case '\r': ret += "\\r"; break;
+    case '"': ret += "\\\""; break;
+    case '\\': ret += "\\\\"; break;
+    default: ret.push_back(c); break;
+    }
+  }
+  return ret;
+}
+
+struct Single
+{
+  std::string value;
+  JS_OBJ(value);
+};
+
+TEST_CASE("test_escape_out_all_positions", "[json_struct][escape]")
+{
+  const char special[] = {'"', '\\', '\n', '\r', '\t', '\b', '\f', '\0', '\x01', '\x0d', '\x0e', '\x1f', '/', 'x', '\x7f', char(0xc3)};
+  for (size_t length = 0; length < 70; length += 3)
+  {
+    for (char c : special)
+    {
+      for (size_t pos = 0; pos < length; pos += 5)
+      {
+        Single single;
+        single.value = std::string(length, 'a');
+        single.value[pos] = c;
+        single.value[length - 1 - pos / 2] = c;
+
+        std::string expected = "{\"value\":\"" + reference_escape(single.value) + "\"}";
+        std::string out = JS::serializeStruct(single, JS::SerializerOptions(JS::SerializerOptions::Compact));
+        REQUIRE(out == expected);
+
+        if (c == '\x0e' || c == '\x1f' || c == '\0' || c == '\x01')
+          continue;
+        Single parsed;
+        JS::ParseContext context(out);
+        REQUIRE(context.parseTo(parsed) == JS::Error::NoError);
+        REQUIRE(parsed.value == single.value);
+      }
+    }
+  }
+}
+
+static const char json_unicode[] = R"json({
+  "One": "\u20ac and \u00e6",
+  "Two": "\ud83d\ude00!",
+  "Three": "\uD83D\uDE00\ud834\udd1e",
+  "Four": "lone \ud83d high",
+  "Five": "lone \ude00 low",
+  "Six": "high then \ud83dA",
+  "Seven": "\ud83d\u0041 \ud83d\ud83d\ude00 \udfff\ud800"
+})json";
+
+struct Unicode
+{
+  std::string One;
+  std::string Two;
+  std::string Three;
+  std::string Four;
+  std::string Five;
+  std::string Six;
+  std::string Seven;
+  JS_OBJ(One, Two, Three, Four, Five, Six, Seven);
+};
+
+TEST_CASE("test_escape_in_unicode", "[json_struct][escape]")
+{
+  JS::ParseContext context(json_unicode);
+  Unicode unicode;
+  REQUIRE(context.parseTo(unicode) == JS::Error::NoError);
+  REQUIRE(unicode.One == "\xe2\x82\xac and \xc3\xa6");
+  REQUIRE(unicode.Two == "\xf0\x9f\x98\x80!");
+  REQUIRE(unicode.Three == "\xf0\x9f\x98\x80\xf0\x9d\x84\x9e");
+  REQUIRE(unicode.Four == "lone \xef\xbf\xbd high");
+  REQUIRE(unicode.Five == "lone \xef\xbf\xbd low");
+  REQUIRE(unicode.Six == "high then \xef\xbf\xbd" "A");
+  REQUIRE(unicode.Seven == "\xef\xbf\xbd" "A \xef\xbf\xbd\xf0\x9f\x98\x80 \xef\xbf\xbd\xef\xbf\xbd");
+}
+
 } // namespace
@@ -0,0 +1,107 @@
+/*
+ * Copyright � 2021 Jorgen Lind
+ *
+ * Permission to use, copy, modify, distribute, and sell this software and its
+ * documentation for any purpose is hereby granted without fee, provided that
+ * the above copyright notice appear in all copies and that both that copyright
+ * notice and this permission notice appear in supporting documentation, and
+ * that the name of the copyright holders not be used in advertising or
+ * publicity pertaining to distribution of the software without specific,
+ * written prior permission.  The copyright holders make no representations
+ * about the suitability of this software for any purpose.  It is provided "as
+ * is" without express or implied warranty.
+ *
+ * THE COPYRIGHT HOLDERS DISCLAIM ALL WARRANTIES WITH REGARD TO THIS SOFTWARE,
+ * INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS, IN NO
+ * EVENT SHALL THE COPYRIGHT HOLDERS BE LIABLE FOR ANY SPECIAL, INDIRECT OR
+ * CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE,
+ * DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER
+ * TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE
+ * OF THIS SOFTWARE.
+ */
+
+#include <json_struct/json_struct.h>
+
+#include "catch2/catch.hpp"
+
+namespace
+{
+struct Known
+{
+  int id = 0;
+  std::string name;
+  std::vector<int> values;
+  JS_OBJ(id, name, values);
+};
+
+static const char json_with_unknown[] = R"json({
+  "id": 4,
+  "blob": {
+    "text": "brackets } ] { [ and \"quotes\" in a string \\",
+    "nested": [ { "a": [ 1, 2, [ 3 ] ] }, "]", "}" ],
+    "empty": {},
+    "more": [ [], {}, "\\\"" ]
+  },
+  "name": "known",
+  "list": [ "}", [ "]" ], { "x": "{" } ],
+  "values": [ 1, 2, 3 ]
+})json";
+
+static void requireKnown(const Known &known)
+{
+  REQUIRE(known.id == 4);
+  REQUIRE(known.name == "known");
+  REQUIRE(known.values == std::vector<int>{1, 2, 3});
+}
+
+TEST_CASE("fast_skip_missing_members", "[json_struct][fast_skip]")
+{
+  for (bool structural_index : {false, true})
+  {
+    JS::ParseContext context(json_with_unknown);
+    context.tokenizer.useStructuralIndex(structural_index);
+    context.fast_skip_missing_members = true;
+    Known known;
+    REQUIRE(context.parseTo(known) == JS::Error::NoError);
+    requireKnown(known);
+    REQUIRE(context.missing_members == std::vector<std::string>{"blob", "list"});
+  }
+}
+
+TEST_CASE("fast_skip_missing_members_split_buffers", "[json_struct][fast_skip]")
+{
+  const size_t size = sizeof(json_with_unknown) - 1;
+  for (size_t split = 1; split < size; split++)
+  {
+    JS::ParseContext context;
+    context.fast_skip_missing_members = true;
+    context.tokenizer.addData(json_with_unknown, split);
+    context.tokenizer.addData(json_with_unknown + split, size - split);
+    Known known;
+    REQUIRE(context.parseTo(known) == JS::Error::NoError);
+    requireKnown(known);
+  }
+}
+
+TEST_CASE("fast_skip_missing_members_does_not_validate", "[json_struct][fast_skip]")
+{
+  const char json[] = R"json({ "id": 4, "blob": { "a": 1 2 3 :: }, "name": "known", "values": [ 1, 2, 3 ] })json";
+  Known known;
+  JS::ParseContext validating(json);
+  REQUIRE(validating.parseTo(known) != JS::Error::NoError);
+
+  JS::ParseContext context(json);
+  context.fast_skip_missing_members = true;
+  REQUIRE(context.parseTo(known) == JS::Error::NoError);
+  requireKnown(known);
+}
+
+TEST_CASE("fast_skip_missing_members_mismatched_bracket", "[json_struct][fast_skip]")
+{
+  const char json[] = R"json({ "id": 4, "blob": [ 1, 2 }, "name": "known" })json";
+  JS::ParseContext context(json);
+  context.fast_skip_missing_members = true;
+  Known known;
+  REQUIRE(context.parseTo(known) != JS::Error::NoError);
+}
+} // namespace
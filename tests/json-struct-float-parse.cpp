@@ -0,0 +1,227 @@
+/*
+ * Copyright � 2021 Jorgen Lind
+ *
+ * Permission to use, copy, modify, distribute, and sell this software and its
+ * documentation for any purpose is hereby granted without fee, provided that
+ * the above copyright notice appear in all copies and that both that copyright
+ * notice and this permission notice appear in supporting documentation, and
+ * that the name of the copyright holders not be used in advertising or
+ * publicity pertaining to distribution of the software without specific,
+ * written prior permission.  The copyright holders make no representations
+ * about the suitability of this software for any purpose.  It is provided "as
+ * is" without express or implied warranty.
+ *
+ * THE COPYRIGHT HOLDERS DISCLAIM ALL WARRANTIES WITH REGARD TO THIS SOFTWARE,
+ * INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS, IN NO
+ * EVENT SHALL THE COPYRIGHT HOLDERS BE LIABLE FOR ANY SPECIAL, INDIRECT OR
+ * CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE,
+ * DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER
+ * TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE
+ * OF THIS SOFTWARE.
+ */
+
+#include <json_struct/json_struct.h>
+
+#include <float.h>
+#include <random>
+#include <stdio.h>
+
+#include "catch2/catch.hpp"
+
+namespace
+{
+template <typename T>
+T reference_parse(const std::string &number);
+template <>
+double reference_parse<double>(const std::string &number)
+{
+  return strtod(number.c_str(), nullptr);
+}
+template <>
+float reference_parse<float>(const std::string &number)
+{
+  return strtof(number.c_str(), nullptr);
+}
+
+template <typename T>
+T json_parse(const std::string &number)
+{
+  T value;
+  const char *end;
+  JS::Internal::ft::to_ieee_t(number.data(), number.size(), value, end);
+  return value;
+}
+
+/* Counts the numbers that do not parse to the same bits as the C library
+ * does, and remembers the first one so a failure is easy to reproduce. */
+template <typename T>
+struct Mismatches
+{
+  size_t count = 0;
+  std::string first;
+
+  void check(const std::string &number)
+  {
+    T value = json_parse<T>(number);
+    T reference = reference_parse<T>(number);
+    if (memcmp(&value, &reference, sizeof(T)) != 0)
+    {
+      if (!count)
+        first = number;
+      count++;
+    }
+  }
+};
+
+std::string random_number(std::mt19937_64 &rng, int max_digits)
+{
+  int digits = 1 + int(rng() % uint64_t(max_digits));
+  std::string number;
+  if (rng() & 1)
+    number += '-';
+  for (int i = 0; i < digits; i++)
+    number += char('0' + rng() % 10);
+  int point = int(rng() % uint64_t(digits + 1));
+  if (point > 0 && point < digits)
+    number.insert(number.size() - size_t(digits - point), ".");
+  if (rng() % 3)
+  {
+    number += (rng() & 1) ? 'e' : 'E';
+    number += std::to_string(int(rng() % 700) - 350);
+  }
+  return number;
+}
+
+TEST_CASE("parse_float_random_digits", "[json_struct][float]")
+{
+  std::mt19937_64 rng(0x5eed);
+  Mismatches<double> doubles;
+  Mismatches<float> floats;
+  for (int i = 0; i < 1000000; i++)
+  {
+    std::string number = random_number(rng, i % 4 ? 19 : 40);
+    doubles.check(number);
+    floats.check(number);
+  }
+  INFO("first double mismatch " << doubles.first);
+  REQUIRE(doubles.count == 0);
+  INFO("first float mismatch " << floats.first);
+  REQUIRE(floats.count == 0);
+}
+
+TEST_CASE("parse_float_random_bits_round_trip", "[json_struct][float]")
+{
+  std::mt19937_64 rng(0xf10a7);
+  Mismatches<double> doubles;
+  Mismatches<float> floats;
+  char buffer[64];
+  for (int i = 0; i < 500000; i++)
+  {
+    uint64_t bits = rng();
+    double d;
+    memcpy(&d, &bits, sizeof(d));
+    if (std::isfinite(d))
+    {
+      snprintf(buffer, sizeof(buffer), "%.*g", 15 + i % 3, d);
+      doubles.check(buffer);
+    }
+    uint32_t float_bits = uint32_t(bits >> 32);
+    float f;
+    memcpy(&f, &float_bits, sizeof(f));
+    if (std::isfinite(f))
+    {
+      snprintf(buffer, sizeof(buffer), "%.*g", 7 + i % 3, double(f));
+      floats.check(buffer);
+    }
+  }
+  INFO("first double mismatch " << doubles.first);
+  REQUIRE(doubles.count == 0);
+  INFO("first float mismatch " << floats.first);
+  REQUIRE(floats.count == 0);
+}
+
+TEST_CASE("parse_float_edge_cases", "[json_struct][float]")
+{
+  const char *numbers[] = {"0",
+                           "-0",
+                           "0.0e999",
+                           "0e-999",
+                           "1",
+                           "1e308",
+                           "1.7976931348623157e308",
+                           "1.7976931348623158e308",
+                           "1.7976931348623159e308",
+                           "1e309",
+                           "2.2250738585072011e-308",
+                           "2.2250738585072014e-308",
+                           "4.9406564584124654e-324",
+                           "2.4703282292062327e-324",
+                           "2.4703282292062328e-324",
+                           "1e-324",
+                           "1e-400",
+                           "3.4028234663852886e38",
+                           "3.4028235677973366e38",
+                           "1.17549435e-38",
+                           "1.4012984643e-45",
+                           "7.006492321624085e-46",
+                           "9007199254740993",
+                           "9007199254740992.5",
+                           "9007199254740993.0000000000000000000000000000001",
+                           "16777217",
+                           "16777216.5000000000000000000001",
+                           "1e22",
+                           "1e23",
+                           "8.589973e9",
+                           "0.1",
+                           "0.3",
+                           "123456789012345678901234567890",
+                           "0.000000000000000000000000000000000123456789012345678901234567890",
+                           "1234567890123456789012345678901234567890e-30",
+                           "7.2057594037927933e16",
+                           "2.2250738585072012e-308",
+                           "17976931348623157081452742373170435679807056752584499659891747680315726078002853876058955"
+                           "86327668781715404589535143824642343213268894641827684675467035375169860499105765512820762"
+                           "45490090389328944075868508455133942304583236903222948165808559332123348274797826204144723"
+                           "168738177180919299881250404026184124858368"};
+  for (const char *number : numbers)
+  {
+    INFO(number);
+    REQUIRE(json_parse<double>(number) == reference_parse<double>(number));
+    REQUIRE(json_parse<float>(number) == reference_parse<float>(number));
+    REQUIRE(std::signbit(json_parse<double>(number)) == std::signbit(reference_parse<double>(number)));
+  }
+}
+
+TEST_CASE("parse_float_halfway_points", "[json_struct][float]")
+{
+  if (LDBL_MANT_DIG < 64)
+    return;
+  // The point halfway between two doubles is exact in an 80 bit long double,
+  // and printing it with enough digits gives its exact decimal expansion.
+  std::mt19937_64 rng(0x4a1f);
+  Mismatches<double> doubles;
+  std::vector<char> buffer(1200);
+  for (int i = 0; i < 4000; i++)
+  {
+    uint64_t bits = rng() & ~(uint64_t(1) << 63);
+    double lower;
+    memcpy(&lower, &bits, sizeof(lower));
+    if (!std::isfinite(lower) || !std::isfinite(std::nextafter(lower, HUGE_VAL)))
+      continue;
+    long double halfway = (static_cast<long double>(lower) + std::nextafter(lower, HUGE_VAL)) / 2;
+    snprintf(buffer.data(), buffer.size(), "%.800Le", halfway);
+    std::string exact = buffer.data();
+    size_t exponent = exact.find('e');
+    std::string mantissa = exact.substr(0, exponent);
+    std::string suffix = exact.substr(exponent);
+    while (mantissa.back() == '0')
+      mantissa.pop_back();
+    doubles.check(mantissa + suffix);
+    doubles.check(mantissa + "000000000000000000001" + suffix);
+    doubles.check(mantissa.substr(0, mantissa.size() - 1) + suffix);
+    doubles.check(mantissa.substr(0, std::min(mantissa.size(), size_t(24))) + suffix);
+  }
+  INFO("first double mismatch " << doubles.first);
+  REQUIRE(doubles.count == 0);
+}
+} // namespace
@@ -0,0 +1,180 @@
+/*
+ * Copyright � 2021 Jorgen Lind
+ *
+ * Permission to use, copy, modify, distribute, and sell this software and its
+ * documentation for any purpose is hereby granted without fee, provided that
+ * the above copyright notice appear in all copies and that both that copyright
+ * notice and this permission notice appear in supporting documentation, and
+ * that the name of the copyright holders not be used in advertising or
+ * publicity pertaining to distribution of the software without specific,
+ * written prior permission.  The copyright holders make no representations
+ * about the suitability of this software for any purpose.  It is provided "as
+ * is" without express or implied warranty.
+ *
+ * THE COPYRIGHT HOLDERS DISCLAIM ALL WARRANTIES WITH REGARD TO THIS SOFTWARE,
+ * INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS, IN NO
+ * EVENT SHALL THE COPYRIGHT HOLDERS BE LIABLE FOR ANY SPECIAL, INDIRECT OR
+ * CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE,
+ * DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER
+ * TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE
+ * OF THIS SOFTWARE.
+ */
+
+#include <json_struct/json_struct.h>
+
+#include "catch2/catch.hpp"
+
+namespace
+{
+struct Event
+{
+  int id = 0;
+  std::string kind;
+  std::vector<double> values;
+  JS_OBJ(id, kind, values);
+};
+
+TEST_CASE("json_lines_reader", "[json_struct][json_lines]")
+{
+  std::string json = "{ \"id\": 1, \"kind\": \"start\", \"values\": [ 1.5 ] }\n"
+                     "\n"
+                     "{ \"id\": 2, \"kind\": \"data\",\r\n"
+                     "{ \"id\": 3, \"kind\": \"data\", \"values\": [ 2, 3 ] }\r\n"
+                     "   \n"
+                     "{ \"id\": \"four\" }\n"
+                     "{ \"id\": 5 } { \"id\": 6 }\n"
+                     "{ \"id\": 7, \"kind\": \"end\", \"values\": [] }";
+
+  JS::JsonLinesReader reader(json);
+  std::vector<Event> events;
+  std::vector<size_t> error_lines;
+  Event event;
+  while (reader.next(event))
+  {
+    if (reader.context.error == JS::Error::NoError)
+      events.push_back(event);
+    else
+      error_lines.push_back(reader.line());
+    event = Event();
+  }
+  REQUIRE(reader.atEnd());
+
+  REQUIRE(events.size() == 3);
+  REQUIRE(events[0].id == 1);
+  REQUIRE(events[0].kind == "start");
+  REQUIRE(events[0].values == std::vector<double>{1.5});
+  REQUIRE(events[1].id == 3);
+  REQUIRE(events[1].values.size() == 2);
+  REQUIRE(events[2].id == 7);
+  REQUIRE(events[2].kind == "end");
+
+  REQUIRE(error_lines == std::vector<size_t>{3, 6, 7});
+}
+
+TEST_CASE("json_lines_reader_errors", "[json_struct][json_lines]")
+{
+  std::string json = "{ \"id\": 1 }\n"
+                     "{ \"id\": \"two\" }\n"
+                     "{ \"id\": 3 } 4\n";
+  JS::JsonLinesReader reader(json);
+  Event event;
+  REQUIRE(reader.next(event));
+  REQUIRE(reader.context.error == JS::Error::NoError);
+
+  REQUIRE(reader.next(event));
+  REQUIRE(reader.line() == 2);
+  REQUIRE(reader.context.error == JS::Error::FailedToParseInt);
+  REQUIRE(reader.context.makeErrorString().find("\"two\"") != std::string::npos);
+
+  REQUIRE(reader.next(event));
+  REQUIRE(reader.line() == 3);
+  REQUIRE(event.id == 3);
+  REQUIRE(reader.context.error != JS::Error::NoError);
+  REQUIRE(reader.context.makeErrorString().size());
+
+  REQUIRE(!reader.next(event));
+}
+
+TEST_CASE("json_lines_reader_arrays", "[json_struct][json_lines]")
+{
+  std::string json = "[ 1 ]\n[ 2, 3 ]\n[]";
+  JS::JsonLinesReader reader(json);
+  std::vector<std::vector<int>> values;
+  std::vector<int> value;
+  while (reader.next(value))
+  {
+    REQUIRE(reader.context.error == JS::Error::NoError);
+    values.push_back(value);
+    value.clear();
+  }
+  REQUIRE(values.size() == 3);
+  REQUIRE(values[0] == std::vector<int>{1});
+  REQUIRE(values[1] == std::vector<int>{2, 3});
+  REQUIRE(values[2].empty());
+}
+
+TEST_CASE("json_lines_reader_feed", "[json_struct][json_lines]")
+{
+  std::string json;
+  for (int i = 0; i < 200; i++)
+    json += "{ \"id\": " + std::to_string(i) + ", \"kind\": \"event\" }\n";
+  json += "{ \"id\": 200 }";
+
+  for (size_t piece : {size_t(1), size_t(7), size_t(64), json.size()})
+  {
+    INFO(piece);
+    JS::JsonLinesReader reader;
+    Event event;
+    std::vector<int> ids;
+    for (size_t offset = 0; offset < json.size(); offset += piece)
+    {
+      reader.feed(json.data() + offset, std::min(piece, json.size() - offset));
+      while (reader.next(event))
+      {
+        REQUIRE(reader.context.error == JS::Error::NoError);
+        REQUIRE(size_t(event.id) + 1 == reader.line());
+        ids.push_back(event.id);
+      }
+    }
+    // The last line has no newline, so it is only read after finish().
+    REQUIRE(ids.size() == 200);
+    reader.finish();
+    REQUIRE(reader.next(event));
+    REQUIRE(event.id == 200);
+    REQUIRE(!reader.next(event));
+    REQUIRE(reader.atEnd());
+  }
+}
+
+TEST_CASE("json_lines_callback", "[json_struct][json_lines]")
+{
+  std::string json;
+  for (int i = 0; i < 1000; i++)
+  {
+    if (i % 100 == 99)
+      json += "{ \"id\": " + std::to_string(i) + ", \"kind\": \"event\", \"values\": [ 1, x ] }\n";
+    else
+      json += "{ \"id\": " + std::to_string(i) + ", \"kind\": \"event\" }\n";
+  }
+
+  int id_sum = 0;
+  std::vector<size_t> error_lines;
+  size_t parsed = JS::parseJsonLines<Event>(
+    json.data(), json.size(),
+    [&id_sum](Event &event, size_t line) {
+      REQUIRE(size_t(event.id) + 1 == line);
+      REQUIRE(event.kind == "event");
+      id_sum += event.id;
+    },
+    [&error_lines](const JS::ParseContext &context, size_t line) {
+      REQUIRE(context.error != JS::Error::NoError);
+      error_lines.push_back(line);
+    });
+
+  REQUIRE(parsed == 990);
+  REQUIRE(error_lines.size() == 10);
+  REQUIRE(error_lines.front() == 100);
+  REQUIRE(error_lines.back() == 1000);
+  REQUIRE(id_sum == 999 * 1000 / 2 - (99 + 199 + 299 + 399 + 499 + 599 + 699 + 799 + 899 + 999));
+}
+} // namespace
@@ -0,0 +1,172 @@
+/*
+ * Copyright � 2021 Jorgen Lind
+ *
+ * Permission to use, copy, modify, distribute, and sell this software and its
+ * documentation for any purpose is hereby granted without fee, provided that
+ * the above copyright notice appear in all copies and that both that copyright
+ * notice and this permission notice appear in supporting documentation, and
+ * that the name of the copyright holders not be used in advertising or
+ * publicity pertaining to distribution of the software without specific,
+ * written prior permission.  The copyright holders make no representations
+ * about the suitability of this software for any purpose.  It is provided "as
+ * is" without express or implied warranty.
+ *
+ * THE COPYRIGHT HOLDERS DISCLAIM ALL WARRANTIES WITH REGARD TO THIS SOFTWARE,
+ * INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS, IN NO
+ * EVENT SHALL THE COPYRIGHT HOLDERS BE LIABLE FOR ANY SPECIAL, INDIRECT OR
+ * CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE,
+ * DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER
+ * TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE
+ * OF THIS SOFTWARE.
+ */
+
+#include <json_struct/json_struct.h>
+
+#include "catch2/catch.hpp"
+
+namespace
+{
+struct Point
+{
+  int x = 0;
+  int y = 0;
+  JS_OBJ(x, y);
+};
+
+struct Entry
+{
+  int x = 0;
+  JS_OBJ(x);
+};
+
+static std::string generateConfig(int keys)
+{
+  std::string json = "{";
+  for (int i = 0; i < keys; i++)
+  {
+    if (i)
+      json += ",";
+    std::string key = "\"key_" + std::to_string(i) + "\": ";
+    if (i % 3 == 0)
+      json += key + "{ \"x\": " + std::to_string(i) + ", \"y\": [ 1, { \"z\": 2 } ] }";
+    else if (i % 3 == 1)
+      json += key + "[ " + std::to_string(i) + " ]";
+    else
+      json += key + std::to_string(i);
+  }
+  json += ", \"key_7\": \"duplicate\" }";
+  return json;
+}
+
+static std::vector<std::string> keyNames(int keys)
+{
+  std::vector<std::string> names;
+  for (int i = 0; i < keys; i++)
+    names.push_back("key_" + std::to_string(i));
+  names.push_back("missing");
+  names.push_back("added_value");
+  names.push_back("added_point");
+  return names;
+}
+
+static void requireSameLookups(const JS::Map &indexed, const JS::Map &linear, const std::vector<std::string> &names)
+{
+  REQUIRE(indexed.tokens.data.size() == linear.tokens.data.size());
+  for (auto &name : names)
+  {
+    INFO(name);
+    JS::Map::It a = indexed.find(name);
+    JS::Map::It b = linear.find(name);
+    REQUIRE(a.index == b.index);
+    if (b == linear.end())
+      continue;
+    REQUIRE(a.next_meta == b.next_meta);
+    REQUIRE(a.next_complex == b.next_complex);
+  }
+}
+
+TEST_CASE("map_index_lookup", "[json_struct][map]")
+{
+  const int keys = 300;
+  std::string json = generateConfig(keys);
+  std::vector<std::string> names = keyNames(keys);
+
+  JS::Map indexed;
+  indexed.use_index = true;
+  JS::ParseContext indexed_context(json);
+  REQUIRE(indexed_context.parseTo(indexed) == JS::Error::NoError);
+
+  JS::Map linear;
+  JS::ParseContext linear_context(json);
+  REQUIRE(linear_context.parseTo(linear) == JS::Error::NoError);
+
+  requireSameLookups(indexed, linear, names);
+
+  JS::ParseContext context;
+  REQUIRE(indexed.castTo<int>("key_299", context) == 299);
+  REQUIRE(indexed.castTo<std::vector<int>>("key_7", context) == std::vector<int>{7});
+  Entry entry;
+  REQUIRE(indexed.castToType("key_3", context, entry) == JS::Error::NoError);
+  REQUIRE(entry.x == 3);
+  REQUIRE(indexed.castToType("missing", context, entry) == JS::Error::KeyNotFound);
+}
+
+TEST_CASE("map_index_follows_set_value", "[json_struct][map]")
+{
+  const int keys = 60;
+  std::string json = generateConfig(keys);
+  std::vector<std::string> names = keyNames(keys);
+
+  JS::Map indexed;
+  indexed.use_index = true;
+  JS::ParseContext indexed_context(json);
+  REQUIRE(indexed_context.parseTo(indexed) == JS::Error::NoError);
+  JS::Map linear;
+  JS::ParseContext linear_context(json);
+  REQUIRE(linear_context.parseTo(linear) == JS::Error::NoError);
+  requireSameLookups(indexed, linear, names);
+
+  Point point;
+  point.x = 100;
+  JS::ParseContext context;
+  const char *edits[] = {"key_0", "key_1", "key_2", "key_30", "key_59", "added_value", "added_point", "key_7"};
+  for (size_t i = 0; i < sizeof(edits) / sizeof(*edits); i++)
+  {
+    INFO(edits[i]);
+    if (i % 2)
+    {
+      REQUIRE(indexed.setValue(edits[i], context, int(i)) == JS::Error::NoError);
+      REQUIRE(linear.setValue(edits[i], context, int(i)) == JS::Error::NoError);
+      REQUIRE(indexed.castTo<int>(edits[i], context) == linear.castTo<int>(edits[i], context));
+    }
+    else
+    {
+      point.y = int(i);
+      REQUIRE(indexed.setValue(edits[i], context, point) == JS::Error::NoError);
+      REQUIRE(linear.setValue(edits[i], context, point) == JS::Error::NoError);
+      REQUIRE(indexed.castTo<Point>(edits[i], context).y == linear.castTo<Point>(edits[i], context).y);
+    }
+    requireSameLookups(indexed, linear, names);
+  }
+  // Members after a removed one have to still be found at their new position.
+  REQUIRE(linear.castTo<Entry>("key_9", context).x == 9);
+  REQUIRE(indexed.castTo<Entry>("key_57", context).x == 57);
+  REQUIRE(JS::serializeStruct(indexed) == JS::serializeStruct(linear));
+}
+TEST_CASE("map_set_value_json_stays_in_place", "[json_struct][map]")
+{
+  // The serialized Entry fits in a small string buffer, which would move
+  // with json_data.
+  Entry entry;
+  entry.x = 5;
+  JS::Map map;
+  JS::ParseContext context;
+  REQUIRE(map.setValue(context, entry) == JS::Error::NoError);
+  for (int i = 0; i < 40; i++)
+    REQUIRE(map.setValue("k" + std::to_string(i), context, i) == JS::Error::NoError);
+  REQUIRE(map.json_data.size() == 41);
+  REQUIRE(map.castTo<int>("x", context) == 5);
+  REQUIRE(map.castTo<int>("k0", context) == 0);
+  REQUIRE(map.castTo<int>("k39", context) == 39);
+}
+} // namespace
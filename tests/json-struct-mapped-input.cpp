@@ -0,0 +1,159 @@
+/*
+ * Copyright � 2021 Jorgen Lind
+ *
+ * Permission to use, copy, modify, distribute, and sell this software and its
+ * documentation for any purpose is hereby granted without fee, provided that
+ * the above copyright notice appear in all copies and that both that copyright
+ * notice and this permission notice appear in supporting documentation, and
+ * that the name of the copyright holders not be used in advertising or
+ * publicity pertaining to distribution of the software without specific,
+ * written prior permission.  The copyright holders make no representations
+ * about the suitability of this software for any purpose.  It is provided "as
+ * is" without express or implied warranty.
+ *
+ * THE COPYRIGHT HOLDERS DISCLAIM ALL WARRANTIES WITH REGARD TO THIS SOFTWARE,
+ * INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS, IN NO
+ * EVENT SHALL THE COPYRIGHT HOLDERS BE LIABLE FOR ANY SPECIAL, INDIRECT OR
+ * CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE,
+ * DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER
+ * TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE
+ * OF THIS SOFTWARE.
+ */
+
+#include <json_struct/json_struct_mmap.h>
+
+#include "catch2/catch.hpp"
+
+#include <stdio.h>
+
+namespace
+{
+struct MappedRecord
+{
+  std::string name;
+  int64_t id;
+  double value;
+  std::vector<int> samples;
+  JS_OBJ(name, id, value, samples);
+};
+
+struct MappedDocument
+{
+  std::vector<MappedRecord> records;
+  JS_OBJ(records);
+};
+
+struct TemporaryFile
+{
+  TemporaryFile(const char *path, const std::string &content)
+    : path(path)
+  {
+    FILE *file = fopen(path, "wb");
+    REQUIRE(file);
+    REQUIRE(fwrite(content.data(), 1, content.size(), file) == content.size());
+    fclose(file);
+  }
+  ~TemporaryFile()
+  {
+    remove(path.c_str());
+  }
+  std::string path;
+};
+
+static std::string makeDocument(size_t records)
+{
+  MappedDocument document;
+  for (size_t i = 0; i < records; i++)
+  {
+    MappedRecord record;
+    record.name = "record \"" + std::to_string(i) + "\" with a name long enough to cross window boundaries";
+    record.id = int64_t(i) * 7919 - 1000000;
+    record.value = double(i) / 3.0;
+    for (int j = 0; j < int(i % 13); j++)
+      record.samples.push_back(int(i) * j);
+    document.records.push_back(record);
+  }
+  return JS::serializeStruct(document);
+}
+
+static void requireEqual(const MappedDocument &a, const MappedDocument &b)
+{
+  REQUIRE(a.records.size() == b.records.size());
+  for (size_t i = 0; i < a.records.size(); i++)
+  {
+    REQUIRE(a.records[i].name == b.records[i].name);
+    REQUIRE(a.records[i].id == b.records[i].id);
+    REQUIRE(a.records[i].value == b.records[i].value);
+    REQUIRE(a.records[i].samples == b.records[i].samples);
+  }
+}
+
+TEST_CASE("mapped_input_parse_file", "json_struct")
+{
+  std::string json = makeDocument(8000);
+  REQUIRE(json.size() > 1000000);
+  TemporaryFile file("json-struct-mapped-input-test.json", json);
+
+  MappedDocument expected;
+  JS::ParseContext context(json);
+  REQUIRE(context.parseTo(expected) == JS::Error::NoError);
+
+  MappedDocument whole;
+  REQUIRE(JS::parseFile(file.path, whole) == JS::Error::NoError);
+  requireEqual(whole, expected);
+
+  MappedDocument windowed;
+  JS::ParseContext file_context;
+  REQUIRE(JS::parseFile(file.path, windowed, file_context, 4096) == JS::Error::NoError);
+  requireEqual(windowed, expected);
+}
+
+TEST_CASE("mapped_input_bounded_windows", "json_struct")
+{
+  std::string json = makeDocument(2000);
+  TemporaryFile file("json-struct-mapped-input-windows.json", json);
+
+  JS::ParseContext context;
+  JS::MappedInput input;
+  input.window_size = 4096;
+  REQUIRE(input.open(file.path));
+  input.attach(context.tokenizer);
+
+  size_t max_resident = 0;
+  size_t records = 0;
+  JS::Token token;
+  JS::Error error = JS::Error::NoError;
+  while (error == JS::Error::NoError)
+  {
+    error = context.tokenizer.nextToken(token);
+    if (token.name.size == 4 && memcmp(token.name.data, "name", 4) == 0)
+      records++;
+    max_resident = std::max(max_resident, input.residentBytes());
+  }
+  REQUIRE(records == 2000);
+  REQUIRE(max_resident > 0);
+  REQUIRE(max_resident <= 2 * 4096);
+  input.close();
+  REQUIRE(input.residentBytes() == 0);
+}
+
+TEST_CASE("mapped_input_missing_file", "json_struct")
+{
+  MappedDocument document;
+  JS::ParseContext context;
+  REQUIRE(JS::parseFile("json-struct-mapped-input-does-not-exist.json", document, context) ==
+          JS::Error::FailedToOpenFile);
+  REQUIRE(context.error == JS::Error::FailedToOpenFile);
+}
+
+TEST_CASE("mapped_input_error_string", "json_struct")
+{
+  std::string json = R"json({ "records": [ { "name": "a", "id": "one", "value": 2.5, "samples": [ 1, 2 ] } ] })json";
+  TemporaryFile file("json-struct-mapped-input-error.json", json);
+
+  MappedDocument document;
+  JS::ParseContext context;
+  REQUIRE(JS::parseFile(file.path, document, context) == JS::Error::FailedToParseInt);
+  REQUIRE(context.makeErrorString().find("\"id\": \"one\"") != std::string::npos);
+}
+} // namespace
@@ -0,0 +1,151 @@
+/*
+ * Copyright � 2021 Jorgen Lind
+ *
+ * Permission to use, copy, modify, distribute, and sell this software and its
+ * documentation for any purpose is hereby granted without fee, provided that
+ * the above copyright notice appear in all copies and that both that copyright
+ * notice and this permission notice appear in supporting documentation, and
+ * that the name of the copyright holders not be used in advertising or
+ * publicity pertaining to distribution of the software without specific,
+ * written prior permission.  The copyright holders make no representations
+ * about the suitability of this software for any purpose.  It is provided "as
+ * is" without express or implied warranty.
+ *
+ * THE COPYRIGHT HOLDERS DISCLAIM ALL WARRANTIES WITH REGARD TO THIS SOFTWARE,
+ * INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS, IN NO
+ * EVENT SHALL THE COPYRIGHT HOLDERS BE LIABLE FOR ANY SPECIAL, INDIRECT OR
+ * CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE,
+ * DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER
+ * TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE
+ * OF THIS SOFTWARE.
+ */
+
+#include <json_struct/json_struct.h>
+
+#include "catch2/catch.hpp"
+
+namespace
+{
+
+struct ManyMembers
+{
+  int m00 = -1, m01 = -1, m02 = -1, m03 = -1, m04 = -1, m05 = -1, m06 = -1, m07 = -1, m08 = -1, m09 = -1;
+  int m10 = -1, m11 = -1, m12 = -1, m13 = -1, m14 = -1, m15 = -1, m16 = -1, m17 = -1, m18 = -1, m19 = -1;
+  int m20 = -1, m21 = -1, m22 = -1, m23 = -1, m24 = -1, m25 = -1, m26 = -1, m27 = -1, m28 = -1, m29 = -1;
+  int m30 = -1, m31 = -1, m32 = -1, m33 = -1, m34 = -1, m35 = -1, m36 = -1, m37 = -1, m38 = -1, m39 = -1;
+  std::string name;
+
+  JS_OBJ(m00, m01, m02, m03, m04, m05, m06, m07, m08, m09, m10, m11, m12, m13, m14, m15, m16, m17, m18, m19, m20, m21,
+         m22, m23, m24, m25, m26, m27, m28, m29, m30, m31, m32, m33, m34, m35, m36, m37, m38, m39, name);
+};
+
+TEST_CASE("member_lookup_many_members", "[json_struct][member_lookup]")
+{
+  std::string json = "{";
+  for (int i = 39; i >= 0; i--)
+  {
+    char buffer[32];
+    snprintf(buffer, sizeof(buffer), "\"m%02d\": %d, ", i, i * 3);
+    json += buffer;
+  }
+  json += "\"name\": \"many\" }";
+
+  JS::ParseContext context(json);
+  ManyMembers many;
+  REQUIRE(context.parseTo(many) == JS::Error::NoError);
+  REQUIRE(context.missing_members.size() == 0);
+  REQUIRE(context.unassigned_required_members.size() == 0);
+  REQUIRE(many.m00 == 0);
+  REQUIRE(many.m17 == 51);
+  REQUIRE(many.m39 == 117);
+  REQUIRE(many.name == "many");
+}
+
+TEST_CASE("member_lookup_name_prefixes", "[json_struct][member_lookup]")
+{
+  const char json[] = R"json({ "m0": 1, "m000": 2, "m39x": 3, "": 4, "name": "x" })json";
+  JS::ParseContext context(json);
+  ManyMembers many;
+  REQUIRE(context.parseTo(many) == JS::Error::NoError);
+  REQUIRE(context.missing_members.size() == 4);
+  REQUIRE(context.missing_members[0] == "m0");
+  REQUIRE(context.missing_members[3] == "");
+  REQUIRE(context.unassigned_required_members.size() == 40);
+  REQUIRE(many.m00 == -1);
+  REQUIRE(many.name == "x");
+}
+
+struct LookupBase
+{
+  int base_value = 0;
+  int shared = 0;
+  JS_OBJ(base_value, shared);
+};
+
+struct LookupOther
+{
+  int other_value = 0;
+  JS_OBJECT(JS_MEMBER_ALIASES(other_value, "other", "base_value"));
+};
+
+struct LookupDerived : public LookupBase, public LookupOther
+{
+  int derived_value = 0;
+  int shared = 0;
+  JS_OBJECT_WITH_SUPER(JS_SUPER_CLASSES(JS_SUPER_CLASS(LookupBase), JS_SUPER_CLASS(LookupOther)),
+                       JS_MEMBER(derived_value), JS_MEMBER_ALIASES(shared, "derived_shared"));
+};
+
+TEST_CASE("member_lookup_super_classes", "[json_struct][member_lookup]")
+{
+  const char json[] = R"json({ "shared": 1, "other": 2, "base_value": 3, "derived_value": 4, "derived_shared": 5 })json";
+  JS::ParseContext context(json);
+  LookupDerived derived;
+  REQUIRE(context.parseTo(derived) == JS::Error::NoError);
+  REQUIRE(context.missing_members.size() == 0);
+  REQUIRE(context.unassigned_required_members.size() == 1);
+  REQUIRE(context.unassigned_required_members[0] == "LookupBase::shared");
+
+  // The subclass member shadows the super class member with the same name, the primary name
+  // of a super class member wins over an alias in another super class, and the last json
+  // value for a member wins.
+  REQUIRE(derived.LookupDerived::shared == 5);
+  REQUIRE(derived.LookupBase::shared == 0);
+  REQUIRE(derived.base_value == 3);
+  REQUIRE(derived.other_value == 2);
+  REQUIRE(derived.derived_value == 4);
+}
+
+TEST_CASE("member_lookup_prediction_hit_rate", "[json_struct][member_lookup]")
+{
+  const char objects[] = R"json([
+    { "derived_value": 1, "shared": 2, "other_value": 3, "base_value": 4 },
+    { "derived_value": 5, "base_value": 6, "shared": 7, "other": 8 }
+  ])json";
+  JS::ParseContext context(objects);
+  std::vector<LookupDerived> derived;
+  REQUIRE(context.parseTo(derived) == JS::Error::NoError);
+  REQUIRE(derived.size() == 2);
+  REQUIRE(derived[0].LookupDerived::shared == 2);
+  REQUIRE(derived[0].base_value == 4);
+  REQUIRE(derived[1].derived_value == 5);
+  REQUIRE(derived[1].base_value == 6);
+  REQUIRE(derived[1].LookupDerived::shared == 7);
+  REQUIRE(derived[1].other_value == 8);
+
+  // The first object has the keys in serialization order: own members first, then the
+  // members of the super classes. Only the first key of the second object is in order.
+  REQUIRE(context.member_prediction_hits == 5);
+  REQUIRE(context.member_prediction_misses == 3);
+  REQUIRE(context.memberPredictionHitRate() == Approx(0.625));
+
+  ManyMembers many;
+  std::string json = JS::serializeStruct(many);
+  JS::ParseContext many_context(json);
+  REQUIRE(many_context.memberPredictionHitRate() == 1.0);
+  REQUIRE(many_context.parseTo(many) == JS::Error::NoError);
+  REQUIRE(many_context.member_prediction_misses == 0);
+  REQUIRE(many_context.member_prediction_hits == 41);
+}
+
+} // namespace
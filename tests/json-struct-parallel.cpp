@@ -0,0 +1,239 @@
+/*
+ * Copyright � 2021 Jorgen Lind
+ *
+ * Permission to use, copy, modify, distribute, and sell this software and its
+ * documentation for any purpose is hereby granted without fee, provided that
+ * the above copyright notice appear in all copies and that both that copyright
+ * notice and this permission notice appear in supporting documentation, and
+ * that the name of the copyright holders not be used in advertising or
+ * publicity pertaining to distribution of the software without specific,
+ * written prior permission.  The copyright holders make no representations
+ * about the suitability of this software for any purpose.  It is provided "as
+ * is" without express or implied warranty.
+ *
+ * THE COPYRIGHT HOLDERS DISCLAIM ALL WARRANTIES WITH REGARD TO THIS SOFTWARE,
+ * INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS, IN NO
+ * EVENT SHALL THE COPYRIGHT HOLDERS BE LIABLE FOR ANY SPECIAL, INDIRECT OR
+ * CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE,
+ * DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER
+ * TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE
+ * OF THIS SOFTWARE.
+ */
+
+#include <json_struct/json_struct_parallel.h>
+
+#include "catch2/catch.hpp"
+
+namespace
+{
+struct ParallelRecord
+{
+  int id = 0;
+  std::string name;
+  std::vector<std::vector<int>> matrix;
+  JS_OBJ(id, name, matrix);
+};
+
+struct NewLineRecord
+{
+  int a = 0;
+  int b = 0;
+  JS_OBJ(a, b);
+};
+
+static std::string makeRecords(int count)
+{
+  std::string json = "[\n";
+  for (int i = 0; i < count; i++)
+  {
+    if (i)
+      json += ",\n";
+    json += "  { \"id\": " + std::to_string(i) + ", \"name\": \"record, [" + std::to_string(i) +
+            "] {\\\"quoted\\\"} \\\\\", \"matrix\": [ [ " + std::to_string(i % 7) + " ], [] ] }";
+  }
+  json += "\n]\n";
+  return json;
+}
+
+TEST_CASE("parallel_parse_matches_serial", "[json_struct][parallel]")
+{
+  std::string json = makeRecords(20000);
+
+  std::vector<ParallelRecord> serial;
+  JS::ParseContext serial_context(json);
+  REQUIRE(serial_context.parseTo(serial) == JS::Error::NoError);
+  REQUIRE(serial.size() == 20000);
+
+  for (size_t threads = 1; threads <= 8; threads *= 2)
+  {
+    JS::ParallelParseContext context(json);
+    context.thread_count = threads;
+    context.min_chunk_size = 4096;
+    std::vector<ParallelRecord> parallel;
+    REQUIRE(context.parseTo(parallel) == JS::Error::NoError);
+    REQUIRE(parallel.size() == serial.size());
+    for (size_t i = 0; i < serial.size(); i++)
+    {
+      REQUIRE(parallel[i].id == serial[i].id);
+      REQUIRE(parallel[i].name == serial[i].name);
+      REQUIRE(parallel[i].matrix == serial[i].matrix);
+    }
+  }
+
+  std::vector<ParallelRecord> defaults;
+  REQUIRE(JS::parallelParseTo(json.data(), json.size(), defaults) == JS::Error::NoError);
+  REQUIRE(defaults.size() == serial.size());
+  REQUIRE(defaults.back().name == serial.back().name);
+}
+
+TEST_CASE("parallel_parse_scalars_and_small_input", "[json_struct][parallel]")
+{
+  std::string json = "[";
+  for (int i = 0; i < 100000; i++)
+    json += (i ? ", " : "") + std::to_string(i * 3);
+  json += "]";
+
+  JS::ParallelParseContext context(json);
+  context.thread_count = 4;
+  context.min_chunk_size = 1024;
+  std::vector<int> values;
+  REQUIRE(context.parseTo(values) == JS::Error::NoError);
+  REQUIRE(values.size() == 100000);
+  for (int i = 0; i < 100000; i++)
+    REQUIRE(values[size_t(i)] == i * 3);
+
+  std::string small = "[ 1, 2, 3 ]";
+  std::vector<int> small_values;
+  REQUIRE(JS::parallelParseTo(small.data(), small.size(), small_values, 4) == JS::Error::NoError);
+  REQUIRE(small_values == std::vector<int>{1, 2, 3});
+}
+
+TEST_CASE("parallel_parse_error_offset", "[json_struct][parallel]")
+{
+  std::string json = makeRecords(20000);
+  std::string bad_member = "\"id\": 15000,";
+  size_t bad_offset = json.find(bad_member);
+  REQUIRE(bad_offset != std::string::npos);
+  json.replace(bad_offset, bad_member.size(), "\"id\": \"x\",");
+
+  std::vector<ParallelRecord> serial;
+  JS::ParseContext serial_context(json);
+  JS::Error serial_error = serial_context.parseTo(serial);
+  REQUIRE(serial_error == JS::Error::FailedToParseInt);
+
+  JS::ParallelParseContext context(json);
+  context.thread_count = 4;
+  context.min_chunk_size = 4096;
+  std::vector<ParallelRecord> parallel;
+  REQUIRE(context.parseTo(parallel) == serial_error);
+  REQUIRE(context.error == serial_error);
+  REQUIRE(context.context.error == serial_error);
+  REQUIRE(context.error_offset >= bad_offset);
+  REQUIRE(context.error_offset <= bad_offset + 12);
+  REQUIRE(context.makeErrorString().find("\"id\": \"x\"") != std::string::npos);
+}
+
+TEST_CASE("parallel_parse_tokenizer_options", "[json_struct][parallel]")
+{
+  std::string json = "[";
+  for (int i = 0; i < 20000; i++)
+  {
+    if (i)
+      json += ",";
+    json += "{\"a\":" + std::to_string(i) + "\n\"b\":1}";
+  }
+  json += "]";
+
+  std::vector<NewLineRecord> serial;
+  JS::ParseContext serial_context(json);
+  serial_context.tokenizer.allowNewLineAsTokenDelimiter(true);
+  REQUIRE(serial_context.parseTo(serial) == JS::Error::NoError);
+  REQUIRE(serial.size() == 20000);
+
+  JS::ParallelParseContext context(json);
+  context.thread_count = 4;
+  context.min_chunk_size = 1024;
+  context.context.tokenizer.allowNewLineAsTokenDelimiter(true);
+  std::vector<NewLineRecord> parallel;
+  REQUIRE(context.parseTo(parallel) == JS::Error::NoError);
+  REQUIRE(parallel.size() == 20000);
+  REQUIRE(parallel[19999].a == 19999);
+
+  // Without the option every chunk fails, and so does the parse.
+  JS::ParallelParseContext strict(json);
+  strict.thread_count = 4;
+  strict.min_chunk_size = 1024;
+  REQUIRE(strict.parseTo(parallel) != JS::Error::NoError);
+}
+
+TEST_CASE("parallel_parse_missing_members", "[json_struct][parallel]")
+{
+  std::string json = "[";
+  for (int i = 0; i < 5000; i++)
+    json += std::string(i ? "," : "") + "{ \"id\": " + std::to_string(i) + (i % 1000 == 0 ? ", \"extra\": 1" : "") + " }";
+  json += "]";
+
+  JS::ParallelParseContext context(json);
+  context.thread_count = 4;
+  context.min_chunk_size = 1024;
+  std::vector<ParallelRecord> records;
+  REQUIRE(context.parseTo(records) == JS::Error::NoError);
+  REQUIRE(records.size() == 5000);
+  REQUIRE(context.context.missing_members.size() == 5);
+
+  context.context.allow_missing_members = false;
+  REQUIRE(context.parseTo(records) == JS::Error::MissingPropertyMember);
+  REQUIRE(context.context.missing_members.size() == 1);
+}
+
+TEST_CASE("parallel_parse_not_an_array", "[json_struct][parallel]")
+{
+  std::string json = "{ \"id\": 1 }";
+  JS::ParallelParseContext context(json);
+  context.thread_count = 4;
+  context.min_chunk_size = 1;
+  std::vector<int> values;
+  REQUIRE(context.parseTo(values) != JS::Error::NoError);
+}
+
+TEST_CASE("parallel_serialize_matches_serial", "[json_struct][parallel]")
+{
+  std::string json = makeRecords(5000);
+  std::vector<ParallelRecord> records;
+  JS::ParseContext parse_context(json);
+  REQUIRE(parse_context.parseTo(records) == JS::Error::NoError);
+
+  for (auto style : {JS::SerializerOptions::Pretty, JS::SerializerOptions::Compact})
+  {
+    JS::SerializerOptions options(style);
+    std::string serial = JS::serializeStruct(records, options);
+    for (size_t threads = 1; threads <= 8; threads *= 2)
+    {
+      std::vector<std::string> chunks = JS::serializeStructChunks(records, options, threads, 1);
+      REQUIRE(chunks.size() == threads);
+      std::string joined;
+      for (auto &chunk : chunks)
+        joined += chunk;
+      REQUIRE(joined == serial);
+    }
+    REQUIRE(JS::serializeStructParallel(records, options, 4) == serial);
+  }
+
+  REQUIRE(JS::serializeStructParallel(records) == JS::serializeStruct(records));
+}
+
+TEST_CASE("parallel_serialize_small_vectors", "[json_struct][parallel]")
+{
+  std::vector<int> empty;
+  REQUIRE(JS::serializeStructParallel(empty, JS::SerializerOptions(), 4) == JS::serializeStruct(empty));
+
+  std::vector<std::vector<int>> nested = {{1, 2}, {}, {3}};
+  for (auto style : {JS::SerializerOptions::Pretty, JS::SerializerOptions::Compact})
+  {
+    JS::SerializerOptions options(style);
+    std::vector<std::string> chunks = JS::serializeStructChunks(nested, options, 8, 1);
+    REQUIRE(chunks.size() == 3);
+    REQUIRE(chunks[0] + chunks[1] + chunks[2] == JS::serializeStruct(nested, options));
+  }
+}
+} // namespace
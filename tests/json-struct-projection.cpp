@@ -0,0 +1,200 @@
+/*
+ * Copyright � 2021 Jorgen Lind
+ *
+ * Permission to use, copy, modify, distribute, and sell this software and its
+ * documentation for any purpose is hereby granted without fee, provided that
+ * the above copyright notice appear in all copies and that both that copyright
+ * notice and this permission notice appear in supporting documentation, and
+ * that the name of the copyright holders not be used in advertising or
+ * publicity pertaining to distribution of the software without specific,
+ * written prior permission.  The copyright holders make no representations
+ * about the suitability of this software for any purpose.  It is provided "as
+ * is" without express or implied warranty.
+ *
+ * THE COPYRIGHT HOLDERS DISCLAIM ALL WARRANTIES WITH REGARD TO THIS SOFTWARE,
+ * INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS, IN NO
+ * EVENT SHALL THE COPYRIGHT HOLDERS BE LIABLE FOR ANY SPECIAL, INDIRECT OR
+ * CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE,
+ * DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER
+ * TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE
+ * OF THIS SOFTWARE.
+ */
+
+#include <json_struct/json_struct.h>
+
+#include "catch2/catch.hpp"
+
+#ifdef JS_PROJECTION
+namespace
+{
+static int counted_parses = 0;
+
+struct Counted
+{
+  int value = 0;
+};
+} // namespace
+
+namespace JS
+{
+template <>
+struct TypeHandler<Counted>
+{
+  static inline Error to(Counted &to_type, ParseContext &context)
+  {
+    counted_parses++;
+    return TypeHandler<int>::to(to_type.value, context);
+  }
+  static inline void from(const Counted &from_type, Token &token, Serializer &serializer)
+  {
+    TypeHandler<int>::from(from_type.value, token, serializer);
+  }
+};
+} // namespace JS
+
+namespace
+{
+struct Address
+{
+  std::string street;
+  int number = 0;
+  JS_OBJ(street, number);
+};
+
+struct Route
+{
+  int id = 0;
+  std::string source;
+  std::string target;
+  std::vector<std::string> hops;
+  Address address;
+  Counted counted;
+  double weight = 0;
+  JS_OBJECT(JS_MEMBER(id), JS_MEMBER(source), JS_MEMBER_ALIASES(target, "destination"), JS_MEMBER(hops),
+            JS_MEMBER(address), JS_MEMBER(counted), JS_MEMBER(weight));
+};
+
+static const char route_json[] = R"json({
+  "source": "a",
+  "hops": [ "b", "c", [ "d" ] ],
+  "address": { "street": "main", "number": 4 },
+  "counted": 7,
+  "destination": "z",
+  "unknown": { "x": [ 1, 2 ] },
+  "id": 42,
+  "weight": 1.5
+})json";
+
+TEST_CASE("projection_parses_selected_members", "[json_struct][projection]")
+{
+  counted_parses = 0;
+  JS::ParseContext context(route_json);
+  JS::Projection<Route, &Route::id, &Route::target> projection;
+  REQUIRE(context.parseTo(projection) == JS::Error::NoError);
+  REQUIRE(projection.value.id == 42);
+  REQUIRE(projection.value.target == "z");
+  REQUIRE(projection.value.source.empty());
+  REQUIRE(projection.value.hops.empty());
+  REQUIRE(projection.value.address.number == 0);
+  REQUIRE(projection.value.weight == 0);
+  REQUIRE(counted_parses == 0);
+  REQUIRE(context.missing_members.empty());
+
+  JS::Projection<Route, &Route::counted, &Route::address> counted;
+  JS::ParseContext counted_context(route_json);
+  REQUIRE(counted_context.parseTo(counted) == JS::Error::NoError);
+  REQUIRE(counted_parses == 1);
+  REQUIRE(counted.value.counted.value == 7);
+  REQUIRE(counted.value.address.street == "main");
+}
+
+TEST_CASE("projection_stops_early", "[json_struct][projection]")
+{
+  const char json[] = R"json({ "id": 3, "destination": "x", "hops": [ 1 2 3 }, "weight": what })json";
+  JS::Projection<Route, &Route::id, &Route::target> projection;
+  {
+    JS::ParseContext context(json);
+    REQUIRE(context.parseTo(projection) != JS::Error::NoError);
+  }
+  JS::ParseContext context(json);
+  context.stop_after_projected_members = true;
+  REQUIRE(context.parseTo(projection) == JS::Error::NoError);
+  REQUIRE(projection.value.id == 3);
+  REQUIRE(projection.value.target == "x");
+}
+
+TEST_CASE("projection_nested_stops_early", "[json_struct][projection]")
+{
+  const char json[] = R"json([
+  { "id": 1, "target": "a", "hops": [ "}" ], "address": { "number": 2 } },
+  { "weight": 2, "target": "b", "id": 2, "address": { "number": 2 } },
+  { "id": 3, "hops": [], "target": "c" },
+  { "id": 4 }
+])json";
+  std::vector<JS::Projection<Route, &Route::id, &Route::target>> projections;
+  JS::ParseContext context(json);
+  context.stop_after_projected_members = true;
+  REQUIRE(context.parseTo(projections) == JS::Error::NoError);
+  REQUIRE(projections.size() == 4);
+  REQUIRE(projections[0].value.id == 1);
+  REQUIRE(projections[0].value.target == "a");
+  REQUIRE(projections[1].value.id == 2);
+  REQUIRE(projections[1].value.target == "b");
+  REQUIRE(projections[2].value.id == 3);
+  REQUIRE(projections[2].value.target == "c");
+  REQUIRE(projections[3].value.id == 4);
+  REQUIRE(projections[3].value.target.empty());
+}
+
+TEST_CASE("projection_serialize", "[json_struct][projection]")
+{
+  JS::Projection<Route, &Route::target, &Route::id> projection;
+  projection.value.id = 5;
+  projection.value.target = "t";
+  projection.value.source = "not serialized";
+  REQUIRE(JS::serializeStruct(projection, JS::SerializerOptions(JS::SerializerOptions::Compact)) ==
+          R"json({"target":"t","id":5})json");
+}
+TEST_CASE("projection_json_lines_stops_early", "[json_struct][projection]")
+{
+  const char json[] = "{ \"id\": 1, \"hops\": [ \"}\" ], \"weight\": 2 }\n"
+                      "{ \"weight\": 3, \"id\": 2 }\n"
+                      "{ \"id\": 3 } { \"id\": 4 }\n";
+  JS::JsonLinesReader reader(json, sizeof(json) - 1);
+  reader.context.stop_after_projected_members = true;
+  JS::Projection<Route, &Route::id> projection;
+  std::vector<int> ids;
+  std::vector<size_t> error_lines;
+  while (reader.next(projection))
+  {
+    if (reader.context.error == JS::Error::NoError)
+      ids.push_back(projection.value.id);
+    else
+      error_lines.push_back(reader.line());
+  }
+  REQUIRE(ids == std::vector<int>{1, 2});
+  REQUIRE(error_lines == std::vector<size_t>{3});
+}
+
+TEST_CASE("projection_unassigned_required_members", "[json_struct][projection]")
+{
+  const char json[] = R"json({ "source": "x", "weight": 1 })json";
+  JS::Projection<Route, &Route::id, &Route::target> projection;
+  {
+    JS::ParseContext context(json);
+    REQUIRE(context.parseTo(projection) == JS::Error::NoError);
+    REQUIRE(context.unassigned_required_members == std::vector<std::string>{"id", "target"});
+  }
+  JS::ParseContext context(json);
+  context.allow_unasigned_required_members = false;
+  REQUIRE(context.parseTo(projection) == JS::Error::UnassignedRequiredMember);
+  REQUIRE(context.unassigned_required_members.size() == 2);
+
+  JS::Projection<Route, &Route::source> present;
+  JS::ParseContext present_context(json);
+  present_context.allow_unasigned_required_members = false;
+  REQUIRE(present_context.parseTo(present) == JS::Error::NoError);
+  REQUIRE(present.value.source == "x");
+}
+} // namespace
+#endif
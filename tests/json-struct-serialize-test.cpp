@@ -210,4 +210,119 @@ TEST_CASE("test_serialize_empty_string", "[json_struct][serialize]")
   REQUIRE(out == empty_string_json);
 }
 
+TEST_CASE("test_serialize_owned_buffer_matches_callback_buffers", "[json_struct][serialize]")
+{
+  std::vector<empty_string_struct> structs(200);
+  for (size_t i = 0; i < structs.size(); i++)
+    structs[i].key2 = std::string(i % 50, 'a' + char(i % 26));
+
+  std::string callback_out;
+  {
+    JS::Serializer serializer;
+    std::vector<std::unique_ptr<char[]>> buffers;
+    auto ref = serializer.addRequestBufferCallback([&](JS::Serializer &serializer_p) {
+      // The callback is only invoked when the previous buffer is full.
+      if (buffers.size())
+        callback_out.append(buffers.back().get(), 7);
+      buffers.emplace_back(new char[7]);
+      serializer_p.setBuffer(buffers.back().get(), 7);
+    });
+    JS::Token token;
+    JS::TypeHandler<std::vector<empty_string_struct>>::from(structs, token, serializer);
+    callback_out.append(serializer.currentBuffer().buffer, serializer.currentBuffer().used);
+  }
+
+  JS::Serializer serializer;
+  serializer.useOwnedBuffer(1);
+  JS::Token token;
+  JS::TypeHandler<std::vector<empty_string_struct>>::from(structs, token, serializer);
+  std::string owned_out(serializer.currentBuffer().buffer, serializer.currentBuffer().used);
+  REQUIRE(owned_out == callback_out);
+
+  std::string string_out = "previous content";
+  JS::Serializer string_serializer;
+  string_serializer.useStringBuffer(string_out, 1);
+  JS::TypeHandler<std::vector<empty_string_struct>>::from(structs, token, string_serializer);
+  REQUIRE(string_out.size() >= callback_out.size());
+  string_serializer.flushStringBuffer();
+  REQUIRE(string_out == callback_out);
+  REQUIRE(string_out.data() == string_serializer.currentBuffer().buffer);
+
+  std::string out = "previous content that is overwritten";
+  {
+    JS::SerializerContext context(out);
+    context.serialize(structs);
+  }
+  REQUIRE(out == callback_out);
+  REQUIRE(JS::serializeStruct(structs) == callback_out);
+}
+
+struct KeySuper
+{
+  int super_value = 1;
+  JS_OBJ(super_value);
+};
+
+struct KeyStruct : public KeySuper
+{
+  int a = 2;
+  std::string renamed = "r";
+  std::vector<int> list = {3};
+  JS_OBJECT_WITH_SUPER(JS_SUPER_CLASSES(JS_SUPER_CLASS(KeySuper)), JS_MEMBER(a),
+                       JS_MEMBER_WITH_NAME_AND_ALIASES(renamed, "other name", "alias"), JS_MEMBER(list));
+};
+
+TEST_CASE("test_serialize_member_keys", "[json_struct][serialize]")
+{
+  KeyStruct key_struct;
+  REQUIRE(JS::serializeStruct(key_struct) == R"json({
+  "a": 2,
+  "other name": "r",
+  "list": [
+    3
+  ],
+  "super_value": 1
+})json");
+  REQUIRE(JS::serializeStruct(key_struct, JS::SerializerOptions(JS::SerializerOptions::Compact)) ==
+          R"json({"a":2,"other name":"r","list":[3],"super_value":1})json");
+
+  JS::SerializerOptions ascii_options(JS::SerializerOptions::Compact);
+  ascii_options.setConvertAsciiToString(false);
+  REQUIRE(JS::serializeStruct(key_struct, ascii_options) == R"json({a:2,other name:"r",list:[3],super_value:1})json");
+}
+
+static std::string nested_arrays_pretty(int levels, size_t shift)
+{
+  std::string expected = "[";
+  for (int i = 1; i < levels; i++)
+    expected += "\n" + std::string(i * shift, ' ') + "[";
+  expected += "\n" + std::string(levels * shift, ' ') + "1,\n" + std::string(levels * shift, ' ') + "2";
+  for (int i = levels - 1; i >= 0; i--)
+    expected += "\n" + std::string(i * shift, ' ') + "]";
+  return expected;
+}
+
+TEST_CASE("test_serialize_indentation", "[json_struct][serialize]")
+{
+  std::vector<std::vector<std::vector<std::vector<std::vector<std::vector<std::vector<int>>>>>>> deep(1);
+  deep[0].resize(1);
+  deep[0][0].resize(1);
+  deep[0][0][0].resize(1);
+  deep[0][0][0][0].resize(1);
+  deep[0][0][0][0][0].resize(1);
+  deep[0][0][0][0][0][0] = {1, 2};
+
+  REQUIRE(JS::serializeStruct(deep) == nested_arrays_pretty(7, 2));
+
+  JS::SerializerOptions options;
+  options.setShiftSize(3);
+  REQUIRE(JS::serializeStruct(deep, options) == nested_arrays_pretty(7, 3));
+
+  options.setShiftSize(100);
+  REQUIRE(JS::serializeStruct(deep, options) == nested_arrays_pretty(7, 100));
+
+  options.setStyle(JS::SerializerOptions::Compact);
+  REQUIRE(JS::serializeStruct(deep, options) == "[[[[[[[1,2]]]]]]]");
+}
+
 } // namespace
@@ -78,6 +78,222 @@ TEST_CASE("large_number_roundtrip", "json_struct")
 
   REQUIRE(to_serialize.uint64 == to_struct.uint64);
 }
+
+template <typename T>
+struct IntHolder
+{
+  T value;
+  JS_OBJ(value);
+};
+
+template <typename T>
+JS::Error parse_int(const std::string &number, T &target)
+{
+  IntHolder<T> holder;
+  std::string document = "{ \"value\": " + number + " }";
+  JS::ParseContext context(document);
+  auto error = context.parseTo(holder);
+  target = holder.value;
+  return error;
+}
+
+template <typename T>
+void require_int_limits(const char *min, const char *max, const char *below_min, const char *above_max)
+{
+  T value = 1;
+  REQUIRE(parse_int(min, value) == JS::Error::NoError);
+  REQUIRE(value == std::numeric_limits<T>::min());
+  REQUIRE(parse_int(max, value) == JS::Error::NoError);
+  REQUIRE(value == std::numeric_limits<T>::max());
+  if (below_min)
+    REQUIRE(parse_int(below_min, value) == JS::Error::FailedToParseInt);
+  REQUIRE(parse_int(above_max, value) == JS::Error::FailedToParseInt);
+}
+
+TEST_CASE("parse_plain_integer_limits", "json_struct")
+{
+  require_int_limits<int8_t>("-128", "127", "-129", "128");
+  require_int_limits<uint8_t>("0", "255", nullptr, "256");
+  require_int_limits<int16_t>("-32768", "32767", "-32769", "32768");
+  require_int_limits<uint16_t>("0", "65535", nullptr, "65536");
+  require_int_limits<int32_t>("-2147483648", "2147483647", "-2147483649", "2147483648");
+  require_int_limits<uint32_t>("0", "4294967295", nullptr, "4294967296");
+  require_int_limits<int64_t>("-9223372036854775808", "9223372036854775807", "-9223372036854775809",
+                              "9223372036854775808");
+  require_int_limits<uint64_t>("0", "18446744073709551615", nullptr, "18446744073709551616");
+  uint64_t value = 0;
+  REQUIRE(parse_int("184467440737095516150", value) == JS::Error::FailedToParseInt);
+  REQUIRE(parse_int("99999999999999999999999999999999", value) == JS::Error::FailedToParseInt);
+}
+
+TEST_CASE("parse_plain_integer_digits", "json_struct")
+{
+  uint64_t expected = 0;
+  for (int digits = 1; digits <= 19; digits++)
+  {
+    expected = expected * 10 + uint64_t(digits % 10);
+    std::string number = std::to_string(expected);
+    uint64_t value = 0;
+    REQUIRE(parse_int(number, value) == JS::Error::NoError);
+    REQUIRE(value == expected);
+    int64_t negative = 0;
+    REQUIRE(parse_int("-" + number, negative) == JS::Error::NoError);
+    REQUIRE(negative == -int64_t(expected));
+  }
+
+  int value = 0;
+  REQUIRE(parse_int("-0", value) == JS::Error::NoError);
+  REQUIRE(value == 0);
+  REQUIRE(parse_int("12345678", value) == JS::Error::NoError);
+  REQUIRE(value == 12345678);
+  REQUIRE(parse_int("1234567a", value) != JS::Error::NoError);
+}
+
+template <typename T>
+std::string int_to_buffer(T value)
+{
+  char buffer[40];
+  int size = JS::Internal::ft::integer::to_buffer(value, buffer, sizeof(buffer));
+  return std::string(buffer, size_t(size));
+}
+
+template <typename T>
+std::string int_write_integer(T value)
+{
+  char buffer[JS::Internal::ft::integer::max_chars<T>()];
+  int size = JS::Internal::ft::integer::write_integer(value, buffer);
+  return std::string(buffer, size_t(size));
+}
+
+template <typename T>
+void require_to_buffer_matches_to_string()
+{
+  const T values[] = {std::numeric_limits<T>::min(), T(std::numeric_limits<T>::min() + 1), T(-1), T(0), T(1), T(9),
+                      T(10), T(99), T(100), std::numeric_limits<T>::max(), T(std::numeric_limits<T>::max() - 1)};
+  for (T value : values)
+  {
+    std::string expected = std::is_signed<T>::value ? std::to_string((long long)value)
+                                                    : std::to_string((unsigned long long)value);
+    REQUIRE(int_to_buffer(value) == expected);
+    REQUIRE(int_write_integer(value) == expected);
+  }
+  for (uint64_t power = 1; power <= uint64_t(std::numeric_limits<T>::max()) / 10; power *= 10)
+  {
+    REQUIRE(int_to_buffer(T(power)) == std::to_string((unsigned long long)power));
+    REQUIRE(int_to_buffer(T(power - 1)) == std::to_string((unsigned long long)(power - 1)));
+    REQUIRE(int_write_integer(T(power)) == std::to_string((unsigned long long)power));
+    REQUIRE(int_write_integer(T(power - 1)) == std::to_string((unsigned long long)(power - 1)));
+  }
+}
+
+TEST_CASE("serialize_integer_widths", "json_struct")
+{
+  require_to_buffer_matches_to_string<int8_t>();
+  require_to_buffer_matches_to_string<uint8_t>();
+  require_to_buffer_matches_to_string<int16_t>();
+  require_to_buffer_matches_to_string<uint16_t>();
+  require_to_buffer_matches_to_string<int32_t>();
+  require_to_buffer_matches_to_string<uint32_t>();
+  require_to_buffer_matches_to_string<int64_t>();
+  require_to_buffer_matches_to_string<uint64_t>();
+
+  char buffer[4];
+  int truncated = 0;
+  int size = JS::Internal::ft::integer::to_buffer(-123456, buffer, sizeof(buffer), &truncated);
+  REQUIRE(std::string(buffer, size_t(size)) == "-123");
+  REQUIRE(truncated == 3);
+}
+
+struct IntegerMembers
+{
+  int8_t small;
+  uint64_t large;
+  std::vector<int64_t> list;
+  JS_OBJ(small, large, list);
+};
+
+TEST_CASE("serialize_integers_in_place", "json_struct")
+{
+  IntegerMembers members;
+  members.small = -128;
+  members.large = std::numeric_limits<uint64_t>::max();
+  members.list = {std::numeric_limits<int64_t>::min(), 0, 12345678901234};
+  REQUIRE(JS::serializeStruct(members, JS::SerializerOptions(JS::SerializerOptions::Compact)) ==
+          "{\"small\":-128,\"large\":18446744073709551615,\"list\":[-9223372036854775808,0,12345678901234]}");
+  REQUIRE(JS::serializeStruct(members) == "{\n"
+                                          "  \"small\": -128,\n"
+                                          "  \"large\": 18446744073709551615,\n"
+                                          "  \"list\": [\n"
+                                          "    -9223372036854775808,\n"
+                                          "    0,\n"
+                                          "    12345678901234\n"
+                                          "  ]\n"
+                                          "}");
+
+  std::vector<int32_t> many(5000);
+  std::string expected = "[";
+  for (size_t i = 0; i < many.size(); i++)
+  {
+    many[i] = int32_t(i * 7919) - 20000000;
+    expected += (i ? "," : "") + std::to_string(many[i]);
+  }
+  expected += "]";
+  REQUIRE(JS::serializeStruct(many, JS::SerializerOptions(JS::SerializerOptions::Compact)) == expected);
+}
+
+TEST_CASE("parse_integer_fallback_forms", "json_struct")
+{
+  int value = 0;
+  REQUIRE(parse_int("1e3", value) == JS::Error::NoError);
+  REQUIRE(value == 1000);
+  REQUIRE(parse_int("12345678.9", value) == JS::Error::NoError);
+  REQUIRE(value == 12345678);
+  REQUIRE(parse_int("-25E-1", value) == JS::Error::NoError);
+  REQUIRE(value == -2);
+  REQUIRE(parse_int("0.5e1", value) == JS::Error::NoError);
+  REQUIRE(value == 5);
+  REQUIRE(parse_int("2147483647.9", value) == JS::Error::NoError);
+  REQUIRE(value == 2147483647);
+  REQUIRE(parse_int("-2147483648e0", value) == JS::Error::NoError);
+  REQUIRE(value == -2147483648);
+  REQUIRE(parse_int("0e99999", value) == JS::Error::NoError);
+  REQUIRE(value == 0);
+  REQUIRE(parse_int("1e-99999", value) == JS::Error::NoError);
+  REQUIRE(value == 0);
+}
+
+TEST_CASE("parse_integer_fallback_forms_out_of_range", "json_struct")
+{
+  int8_t int8 = 0;
+  REQUIRE(parse_int("1e3", int8) == JS::Error::FailedToParseInt);
+  REQUIRE(parse_int("300.0", int8) == JS::Error::FailedToParseInt);
+  REQUIRE(parse_int("-1.29e2", int8) == JS::Error::FailedToParseInt);
+  REQUIRE(parse_int("1.27e2", int8) == JS::Error::NoError);
+  REQUIRE(int8 == 127);
+  REQUIRE(parse_int("-128.5", int8) == JS::Error::NoError);
+  REQUIRE(int8 == -128);
+
+  uint16_t uint16 = 0;
+  REQUIRE(parse_int("-1", uint16) == JS::Error::FailedToParseInt);
+  REQUIRE(parse_int("-1e0", uint16) == JS::Error::FailedToParseInt);
+  REQUIRE(parse_int("6.5536e4", uint16) == JS::Error::FailedToParseInt);
+  REQUIRE(parse_int("6.5535e4", uint16) == JS::Error::NoError);
+  REQUIRE(uint16 == 65535);
+  REQUIRE(parse_int("-0", uint16) == JS::Error::NoError);
+  REQUIRE(uint16 == 0);
+  REQUIRE(parse_int("-0.5", uint16) == JS::Error::NoError);
+  REQUIRE(uint16 == 0);
+
+  uint64_t uint64 = 0;
+  REQUIRE(parse_int("1.8446744073709551615e19", uint64) == JS::Error::NoError);
+  REQUIRE(uint64 == UINT64_C(18446744073709551615));
+  REQUIRE(parse_int("1.8446744073709551616e19", uint64) == JS::Error::FailedToParseInt);
+  REQUIRE(parse_int("1e99999", uint64) == JS::Error::FailedToParseInt);
+  int64_t int64 = 0;
+  REQUIRE(parse_int("-9.223372036854775808e18", int64) == JS::Error::NoError);
+  REQUIRE(int64 == std::numeric_limits<int64_t>::min());
+  REQUIRE(parse_int("9.223372036854775808e18", int64) == JS::Error::FailedToParseInt);
+}
 }
 
 #if defined(__SIZEOF_INT128__)
@@ -107,5 +323,43 @@ TEST_CASE("test_128_int", "json_struct")
   REQUIRE(error == JS::Error::NoError);
   REQUIRE(large_int_target.data == large_int.data);
 }
+
+TEST_CASE("test_128_int_serialize", "json_struct")
+{
+  std::vector<JS::js_int128_t> values = {0, -1, JS::js_int128_t(UINT64_C(10000000000000000000)),
+                                         JS::js_int128_t(~(JS::js_uint128_t(1) << 127)),
+                                         JS::js_int128_t(JS::js_uint128_t(1) << 127)};
+  values.push_back(values[2] * JS::js_int128_t(UINT64_C(10000000000000000000)) + 7);
+  REQUIRE(JS::serializeStruct(values, JS::SerializerOptions(JS::SerializerOptions::Compact)) ==
+          "[0,-1,10000000000000000000,170141183460469231731687303715884105727,"
+          "-170141183460469231731687303715884105728,100000000000000000000000000000000000007]");
+
+  std::vector<JS::js_uint128_t> unsigned_values = {JS::js_uint128_t(~JS::js_uint128_t(0))};
+  REQUIRE(JS::serializeStruct(unsigned_values, JS::SerializerOptions(JS::SerializerOptions::Compact)) ==
+          "[340282366920938463463374607431768211455]");
+}
+
+TEST_CASE("test_128_int_plain_limits", "json_struct")
+{
+  very_large_int large_int;
+  JS::ParseContext max_context(R"json({"data": 170141183460469231731687303715884105727})json");
+  REQUIRE(max_context.parseTo(large_int) == JS::Error::NoError);
+  REQUIRE(large_int.data == JS::js_int128_t(~(JS::js_uint128_t(1) << 127)));
+
+  JS::ParseContext min_context(R"json({"data": -170141183460469231731687303715884105728})json");
+  REQUIRE(min_context.parseTo(large_int) == JS::Error::NoError);
+  REQUIRE(large_int.data == JS::js_int128_t(JS::js_uint128_t(1) << 127));
+
+  JS::ParseContext overflow_context(R"json({"data": 170141183460469231731687303715884105728})json");
+  REQUIRE(overflow_context.parseTo(large_int) == JS::Error::FailedToParseInt);
+
+  std::vector<JS::js_uint128_t> unsigned_values;
+  JS::ParseContext unsigned_context("[340282366920938463463374607431768211455]");
+  REQUIRE(unsigned_context.parseTo(unsigned_values) == JS::Error::NoError);
+  REQUIRE(unsigned_values.size() == 1);
+  REQUIRE(unsigned_values[0] == JS::js_uint128_t(~JS::js_uint128_t(0)));
+  JS::ParseContext unsigned_overflow_context("[340282366920938463463374607431768211456]");
+  REQUIRE(unsigned_overflow_context.parseTo(unsigned_values) == JS::Error::FailedToParseInt);
+}
 }
 #endif
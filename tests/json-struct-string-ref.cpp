@@ -0,0 +1,134 @@
+/*
+ * Copyright � 2021 Jorgen Lind
+ *
+ * Permission to use, copy, modify, distribute, and sell this software and its
+ * documentation for any purpose is hereby granted without fee, provided that
+ * the above copyright notice appear in all copies and that both that copyright
+ * notice and this permission notice appear in supporting documentation, and
+ * that the name of the copyright holders not be used in advertising or
+ * publicity pertaining to distribution of the software without specific,
+ * written prior permission.  The copyright holders make no representations
+ * about the suitability of this software for any purpose.  It is provided "as
+ * is" without express or implied warranty.
+ *
+ * THE COPYRIGHT HOLDERS DISCLAIM ALL WARRANTIES WITH REGARD TO THIS SOFTWARE,
+ * INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS, IN NO
+ * EVENT SHALL THE COPYRIGHT HOLDERS BE LIABLE FOR ANY SPECIAL, INDIRECT OR
+ * CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE,
+ * DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER
+ * TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE
+ * OF THIS SOFTWARE.
+ */
+
+#include <json_struct/json_struct.h>
+
+#include "catch2/catch.hpp"
+
+namespace
+{
+
+struct Envelope
+{
+  JS::DataRef id;
+  JS::DataRef method;
+  int version = 0;
+  std::vector<JS::DataRef> tags;
+
+  JS_OBJ(id, method, version, tags);
+};
+
+TEST_CASE("string_ref_points_into_input", "[json_struct][string_ref]")
+{
+  const char json[] = R"json({ "id": "abc-123", "method": "get", "version": 2, "tags": [ "one", "two" ] })json";
+  JS::ParseContext context(json);
+  Envelope envelope;
+  REQUIRE(context.parseTo(envelope) == JS::Error::NoError);
+  REQUIRE(std::string(envelope.id.data, envelope.id.size) == "abc-123");
+  REQUIRE(envelope.id.data == strstr(json, "abc-123"));
+  REQUIRE(envelope.method.data == strstr(json, "get"));
+  REQUIRE(envelope.tags.size() == 2);
+  REQUIRE(envelope.tags[1].data == strstr(json, "two"));
+  REQUIRE(envelope.tags[1].size == 3);
+}
+
+TEST_CASE("string_ref_escapes_use_arena", "[json_struct][string_ref]")
+{
+  const char json[] = R"json({ "id": "a\"b\\c\næ", "method": "get", "version": 2, "tags": [ "\t" ] })json";
+  {
+    JS::ParseContext context(json);
+    Envelope envelope;
+    REQUIRE(context.parseTo(envelope) == JS::Error::NonContigiousMemory);
+  }
+
+  JS::Arena arena(16);
+  JS::ParseContext context(json);
+  context.arena = &arena;
+  Envelope envelope;
+  REQUIRE(context.parseTo(envelope) == JS::Error::NoError);
+  REQUIRE(std::string(envelope.id.data, envelope.id.size) == "a\"b\\c\n\xc3\xa6");
+  REQUIRE(envelope.method.data == strstr(json, "get"));
+  REQUIRE(envelope.tags.size() == 1);
+  REQUIRE(std::string(envelope.tags[0].data, envelope.tags[0].size) == "\t");
+
+  std::string serialized = JS::serializeStruct(envelope, JS::SerializerOptions(JS::SerializerOptions::Compact));
+  REQUIRE(serialized == R"json({"id":"a\"b\\c\n)json"
+                        "\xc3\xa6"
+                        R"json(","method":"get","version":2,"tags":["\t"]})json");
+}
+
+TEST_CASE("string_ref_split_buffers_use_arena", "[json_struct][string_ref]")
+{
+  const char json[] = R"json({ "id": "abc-123", "method": "get", "version": 2, "tags": [] })json";
+  const char *split = strstr(json, "c-1");
+  JS::Arena arena;
+  JS::ParseContext context;
+  context.arena = &arena;
+  context.tokenizer.addData(json, size_t(split - json));
+  context.tokenizer.addData(split, sizeof(json) - 1 - size_t(split - json));
+  Envelope envelope;
+  REQUIRE(context.parseTo(envelope) == JS::Error::NoError);
+  REQUIRE(std::string(envelope.id.data, envelope.id.size) == "abc-123");
+  REQUIRE(!(envelope.id.data >= json && envelope.id.data < json + sizeof(json)));
+  REQUIRE(envelope.method.data == strstr(json, "get"));
+}
+
+TEST_CASE("string_ref_arena_alignment", "[json_struct][string_ref]")
+{
+  JS::Arena arena(64);
+  char *a = static_cast<char *>(arena.allocate(3, 1));
+  char *b = static_cast<char *>(arena.allocate(8, 8));
+  REQUIRE(b >= a + 3);
+  REQUIRE(reinterpret_cast<uintptr_t>(b) % 8 == 0);
+  char *large = static_cast<char *>(arena.allocate(1000, 1));
+  memset(large, 'x', 1000);
+  arena.clear();
+  REQUIRE(static_cast<char *>(arena.allocate(3, 1)) == a);
+}
+
+#ifdef JS_STD_STRING_VIEW
+struct ViewEnvelope
+{
+  std::string_view id;
+  std::string_view method;
+
+  JS_OBJ(id, method);
+};
+
+TEST_CASE("string_ref_string_view", "[json_struct][string_ref]")
+{
+  const char json[] = R"json({ "id": "plain", "method": "esc\/aped" })json";
+  JS::Arena arena;
+  JS::ParseContext context(json);
+  context.arena = &arena;
+  ViewEnvelope envelope;
+  REQUIRE(context.parseTo(envelope) == JS::Error::NoError);
+  REQUIRE(envelope.id == "plain");
+  REQUIRE(envelope.id.data() == strstr(json, "plain"));
+  REQUIRE(envelope.method == "esc/aped");
+
+  std::string serialized = JS::serializeStruct(envelope, JS::SerializerOptions(JS::SerializerOptions::Compact));
+  REQUIRE(serialized == R"json({"id":"plain","method":"esc/aped"})json");
+}
+#endif
+
+} // namespace
@@ -0,0 +1,105 @@
+/*
+ * Copyright � 2021 Jorgen Lind
+ *
+ * Permission to use, copy, modify, distribute, and sell this software and its
+ * documentation for any purpose is hereby granted without fee, provided that
+ * the above copyright notice appear in all copies and that both that copyright
+ * notice and this permission notice appear in supporting documentation, and
+ * that the name of the copyright holders not be used in advertising or
+ * publicity pertaining to distribution of the software without specific,
+ * written prior permission.  The copyright holders make no representations
+ * about the suitability of this software for any purpose.  It is provided "as
+ * is" without express or implied warranty.
+ *
+ * THE COPYRIGHT HOLDERS DISCLAIM ALL WARRANTIES WITH REGARD TO THIS SOFTWARE,
+ * INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS, IN NO
+ * EVENT SHALL THE COPYRIGHT HOLDERS BE LIABLE FOR ANY SPECIAL, INDIRECT OR
+ * CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE,
+ * DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER
+ * TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE
+ * OF THIS SOFTWARE.
+ */
+
+/* Counts allocations with a replaced global operator new, so it is built as
+ * its own executable instead of being part of unit-tests. */
+
+#include <json_struct/json_struct.h>
+
+#include "catch2/catch.hpp"
+
+#include <cstdlib>
+#include <new>
+
+static size_t allocation_count = 0;
+
+void *operator new(std::size_t size)
+{
+  allocation_count++;
+  void *ptr = std::malloc(size ? size : 1);
+  if (!ptr)
+    throw std::bad_alloc();
+  return ptr;
+}
+
+void operator delete(void *ptr) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete(void *ptr, std::size_t) noexcept
+{
+  std::free(ptr);
+}
+
+JS_ENUM(Level, Debug, Info, Warning, Error)
+JS_ENUM_DECLARE_STRING_PARSER(Level)
+
+namespace
+{
+struct Endpoint
+{
+  std::string host;
+  uint16_t port = 0;
+  JS_OBJ(host, port);
+};
+
+struct Record : public Endpoint
+{
+  std::string message;
+  Level level = Level::Info;
+  int8_t priority = 0;
+  std::vector<std::string> tags;
+  std::vector<Endpoint> relays;
+  JS::Optional<std::string> comment;
+  std::unique_ptr<Endpoint> origin;
+  std::unordered_map<std::string, double> metrics;
+  int window[2] = {};
+  JS_OBJECT_WITH_SUPER(JS_SUPER_CLASSES(JS_SUPER_CLASS(Endpoint)), JS_MEMBER(message), JS_MEMBER(level),
+                       JS_MEMBER(priority), JS_MEMBER(tags), JS_MEMBER(relays), JS_MEMBER(comment),
+                       JS_MEMBER(origin), JS_MEMBER(metrics), JS_MEMBER(window));
+};
+
+static const char valid_record[] = R"json({
+  "host": "example.com",
+  "port": 8080,
+  "message": "a long message that does not fit in the small string buffer",
+  "level": "Warning",
+  "priority": -12,
+  "tags": [ "one", "two", "three with an escaped \" quote" ],
+  "relays": [ { "host": "relay-one.example.com", "port": 1 }, { "host": "relay-two.example.com", "port": 2 } ],
+  "origin": null,
+  "metrics": { "latency": 1.5, "throughput": 1200 },
+  "window": [ 10, 20 ]
+})json";
+
+TEST_CASE("validate_does_not_allocate", "[json_struct][validate]")
+{
+  // The first call sets up the pooled context and the member tables.
+  REQUIRE(JS::validate<Record>(valid_record, sizeof(valid_record) - 1) == JS::Error::NoError);
+
+  allocation_count = 0;
+  for (int i = 0; i < 10; i++)
+    REQUIRE(JS::validate<Record>(valid_record, sizeof(valid_record) - 1) == JS::Error::NoError);
+  REQUIRE(allocation_count == 0);
+}
+} // namespace
@@ -0,0 +1,143 @@
+/*
+ * Copyright � 2021 Jorgen Lind
+ *
+ * Permission to use, copy, modify, distribute, and sell this software and its
+ * documentation for any purpose is hereby granted without fee, provided that
+ * the above copyright notice appear in all copies and that both that copyright
+ * notice and this permission notice appear in supporting documentation, and
+ * that the name of the copyright holders not be used in advertising or
+ * publicity pertaining to distribution of the software without specific,
+ * written prior permission.  The copyright holders make no representations
+ * about the suitability of this software for any purpose.  It is provided "as
+ * is" without express or implied warranty.
+ *
+ * THE COPYRIGHT HOLDERS DISCLAIM ALL WARRANTIES WITH REGARD TO THIS SOFTWARE,
+ * INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS, IN NO
+ * EVENT SHALL THE COPYRIGHT HOLDERS BE LIABLE FOR ANY SPECIAL, INDIRECT OR
+ * CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE,
+ * DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER
+ * TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE
+ * OF THIS SOFTWARE.
+ */
+
+#include <json_struct/json_struct.h>
+
+#include "catch2/catch.hpp"
+
+JS_ENUM(Severity, Debug, Info, Warning, Error)
+JS_ENUM_DECLARE_STRING_PARSER(Severity)
+
+namespace
+{
+struct Source
+{
+  std::string host;
+  uint16_t port = 0;
+  JS_OBJ(host, port);
+};
+
+struct Event : public Source
+{
+  std::string message;
+  Severity severity = Severity::Info;
+  int8_t priority = 0;
+  std::vector<std::string> tags;
+  std::vector<Source> relays;
+  JS::Optional<std::string> comment;
+  std::unique_ptr<Source> origin;
+  std::unordered_map<std::string, double> metrics;
+  int window[2] = {};
+  JS_OBJECT_WITH_SUPER(JS_SUPER_CLASSES(JS_SUPER_CLASS(Source)), JS_MEMBER(message), JS_MEMBER(severity),
+                       JS_MEMBER(priority), JS_MEMBER(tags), JS_MEMBER(relays), JS_MEMBER(comment),
+                       JS_MEMBER(origin), JS_MEMBER(metrics), JS_MEMBER(window));
+};
+
+static const char valid_event[] = R"json({
+  "host": "example.com",
+  "port": 8080,
+  "message": "a long message that does not fit in the small string buffer",
+  "severity": "Warning",
+  "priority": -12,
+  "tags": [ "one", "two", "three with an escaped \" quote" ],
+  "relays": [ { "host": "relay-one.example.com", "port": 1 }, { "host": "relay-two.example.com", "port": 2 } ],
+  "origin": null,
+  "metrics": { "latency": 1.5, "throughput": 1200 },
+  "window": [ 10, 20 ]
+})json";
+
+static JS::Error parseEvent(const std::string &json)
+{
+  Event event;
+  JS::ParseContext context(json);
+  return context.parseTo(event);
+}
+
+TEST_CASE("validate_valid_input", "[json_struct][validate]")
+{
+  REQUIRE(parseEvent(valid_event) == JS::Error::NoError);
+  REQUIRE(JS::validate<Event>(valid_event, sizeof(valid_event) - 1) == JS::Error::NoError);
+
+  JS::ParseContext context(valid_event);
+  REQUIRE(JS::validate<Event>(context) == JS::Error::NoError);
+  REQUIRE(context.missing_members.empty());
+  REQUIRE(context.unassigned_required_members.empty());
+}
+
+TEST_CASE("validate_reports_the_same_errors_as_parse", "[json_struct][validate]")
+{
+  const char *invalid[] = {
+    R"json({ "port": 70000 })json",
+    R"json({ "priority": 128 })json",
+    R"json({ "port": -1 })json",
+    R"json({ "priority": 1e3 })json",
+    R"json({ "port": -1, "priority": 1e3 })json",
+    R"json({ "priority": -1.29e2 })json",
+    R"json({ "port": 6.5536e4 })json",
+    R"json({ "severity": "Critical" })json",
+    R"json({ "tags": "not an array" })json",
+    R"json({ "relays": [ { "port": "one" } ] })json",
+    R"json({ "origin": { "port": 65536 } })json",
+    R"json({ "metrics": { "latency": "slow" } })json",
+    R"json({ "window": [ 1, 2, 3 ] })json",
+    R"json([ 1, 2 ])json",
+  };
+  for (const char *json : invalid)
+  {
+    INFO(json);
+    JS::Error parse_error = parseEvent(json);
+    REQUIRE(parse_error != JS::Error::NoError);
+    JS::ParseContext context(json);
+    REQUIRE(JS::validate<Event>(context) == parse_error);
+    REQUIRE(context.makeErrorString().size() > 0);
+  }
+}
+
+TEST_CASE("validate_integer_ranges", "[json_struct][validate]")
+{
+  const char *valid[] = {
+    R"json({ "port": 65535, "priority": -128 })json",
+    R"json({ "port": 6.5535e4, "priority": -1.28e2 })json",
+    R"json({ "port": 0, "priority": 127.0 })json",
+  };
+  for (const char *json : valid)
+  {
+    INFO(json);
+    REQUIRE(JS::validate<Event>(json, strlen(json)) == JS::Error::NoError);
+  }
+}
+
+TEST_CASE("validate_members", "[json_struct][validate]")
+{
+  const char json[] = R"json({ "host": "a", "port": 1, "message": "b", "unknown": [ 1, 2 ] })json";
+  JS::ParseContext context(json);
+  context.allow_unasigned_required_members = false;
+  REQUIRE(JS::validate<Event>(context) == JS::Error::UnassignedRequiredMember);
+  REQUIRE(context.missing_members.size() == 1);
+  REQUIRE(context.missing_members[0] == "unknown");
+  REQUIRE(context.unassigned_required_members.size() == 6);
+
+  JS::ParseContext strict(json);
+  strict.allow_missing_members = false;
+  REQUIRE(JS::validate<Event>(strict) == JS::Error::MissingPropertyMember);
+}
+} // namespace
@@ -349,4 +349,42 @@ TEST_CASE("check_remove_callback", "[tokenizer]")
   REQUIRE(error == JS::Error::NoError);
   REQUIRE(has_been_called == false);
 }
+
+const char json_data_partial_9_1[] = "{ \"values\": [ 12\n   ";
+const char json_data_partial_9_2[] = ", true  ";
+const char json_data_partial_9_3[] = "] }";
+
+TEST_CASE("check_json_partial_value_before_delimiter", "[tokenizer]")
+{
+  JS::Error error;
+  JS::Tokenizer tokenizer;
+  tokenizer.addData(json_data_partial_9_1, sizeof(json_data_partial_9_1) - 1);
+  tokenizer.addData(json_data_partial_9_2, sizeof(json_data_partial_9_2) - 1);
+  tokenizer.addData(json_data_partial_9_3, sizeof(json_data_partial_9_3) - 1);
+
+  JS::Token token;
+  error = tokenizer.nextToken(token);
+  REQUIRE(error == JS::Error::NoError);
+  REQUIRE(token.value_type == JS::Type::ObjectStart);
+
+  error = tokenizer.nextToken(token);
+  REQUIRE(error == JS::Error::NoError);
+  REQUIRE(token.value_type == JS::Type::ArrayStart);
+
+  error = tokenizer.nextToken(token);
+  REQUIRE(error == JS::Error::NoError);
+  REQUIRE((assert_token(token, JS::Type::Ascii, "", JS::Type::Number, "12") == 0));
+
+  error = tokenizer.nextToken(token);
+  REQUIRE(error == JS::Error::NoError);
+  REQUIRE((assert_token(token, JS::Type::Ascii, "", JS::Type::Bool, "true") == 0));
+
+  error = tokenizer.nextToken(token);
+  REQUIRE(error == JS::Error::NoError);
+  REQUIRE(token.value_type == JS::Type::ArrayEnd);
+
+  error = tokenizer.nextToken(token);
+  REQUIRE(error == JS::Error::NoError);
+  REQUIRE(token.value_type == JS::Type::ObjectEnd);
+}
 } // namespace json_tokenizer_partial_test
@@ -0,0 +1,107 @@
+/*
+ * Copyright � 2021 Jorgen Lind
+ *
+ * Permission to use, copy, modify, distribute, and sell this software and its
+ * documentation for any purpose is hereby granted without fee, provided that
+ * the above copyright notice appear in all copies and that both that copyright
+ * notice and this permission notice appear in supporting documentation, and
+ * that the name of the copyright holders not be used in advertising or
+ * publicity pertaining to distribution of the software without specific,
+ * written prior permission.  The copyright holders make no representations
+ * about the suitability of this software for any purpose.  It is provided "as
+ * is" without express or implied warranty.
+ *
+ * THE COPYRIGHT HOLDERS DISCLAIM ALL WARRANTIES WITH REGARD TO THIS SOFTWARE,
+ * INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS, IN NO
+ * EVENT SHALL THE COPYRIGHT HOLDERS BE LIABLE FOR ANY SPECIAL, INDIRECT OR
+ * CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE,
+ * DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER
+ * TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE
+ * OF THIS SOFTWARE.
+ */
+
+#include <json_struct/json_struct.h>
+
+#include "catch2/catch.hpp"
+
+namespace
+{
+
+struct StringHolder
+{
+  std::string str;
+  JS_OBJ(str);
+};
+
+static std::string make_escaped_string(size_t size, size_t escape_pos, const char *escape)
+{
+  std::string ret;
+  for (size_t i = 0; i < size; i++)
+  {
+    if (i == escape_pos)
+      ret += escape;
+    ret.push_back(char('a' + (i % 26)));
+  }
+  if (escape_pos >= size)
+    ret += escape;
+  return ret;
+}
+
+TEST_CASE("tokenizer_string_scan_escape_positions", "[tokenizer]")
+{
+  const char *escapes[] = {"\\\"", "\\\\", "\\n", "\\/"};
+  const char *unescaped[] = {"\"", "\\", "\n", "/"};
+  for (size_t e = 0; e < sizeof(escapes) / sizeof(*escapes); e++)
+  {
+    for (size_t size = 0; size < 72; size++)
+    {
+      for (size_t pos = 0; pos <= size; pos++)
+      {
+        std::string json = std::string("{ \"str\": \"") + make_escaped_string(size, pos, escapes[e]) + "\" }";
+        StringHolder holder;
+        JS::ParseContext context(json);
+        REQUIRE(context.parseTo(holder) == JS::Error::NoError);
+        REQUIRE(holder.str == make_escaped_string(size, pos, unescaped[e]));
+      }
+    }
+  }
+}
+
+TEST_CASE("tokenizer_string_scan_split_buffers", "[tokenizer]")
+{
+  std::string value = make_escaped_string(40, 17, "\\\\\\\"");
+  value += make_escaped_string(23, 5, "\\\"");
+  std::string json = std::string("{ \"str\": \"") + value + "\", \"second\": 42 }";
+
+  for (size_t split = 1; split < json.size(); split++)
+  {
+    JS::Tokenizer tokenizer;
+    tokenizer.addData(json.data(), split);
+    tokenizer.addData(json.data() + split, json.size() - split);
+
+    JS::Token token;
+    REQUIRE(tokenizer.nextToken(token) == JS::Error::NoError);
+    REQUIRE(token.value_type == JS::Type::ObjectStart);
+    REQUIRE(tokenizer.nextToken(token) == JS::Error::NoError);
+    REQUIRE(token.value_type == JS::Type::String);
+    REQUIRE(std::string(token.name.data, token.name.size) == "str");
+    REQUIRE(std::string(token.value.data, token.value.size) == value);
+    REQUIRE(tokenizer.nextToken(token) == JS::Error::NoError);
+    REQUIRE(std::string(token.name.data, token.name.size) == "second");
+    REQUIRE(std::string(token.value.data, token.value.size) == "42");
+    REQUIRE(tokenizer.nextToken(token) == JS::Error::NoError);
+    REQUIRE(token.value_type == JS::Type::ObjectEnd);
+  }
+}
+
+TEST_CASE("tokenizer_string_scan_unterminated", "[tokenizer]")
+{
+  std::string json = std::string("{ \"str\": \"") + std::string(100, 'x') + "\\";
+  JS::Tokenizer tokenizer;
+  tokenizer.addData(json.data(), json.size());
+  JS::Token token;
+  REQUIRE(tokenizer.nextToken(token) == JS::Error::NoError);
+  REQUIRE(tokenizer.nextToken(token) == JS::Error::NeedMoreData);
+}
+
+} // namespace
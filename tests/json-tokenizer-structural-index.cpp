@@ -0,0 +1,175 @@
+/*
+ * Copyright � 2021 Jorgen Lind
+ *
+ * Permission to use, copy, modify, distribute, and sell this software and its
+ * documentation for any purpose is hereby granted without fee, provided that
+ * the above copyright notice appear in all copies and that both that copyright
+ * notice and this permission notice appear in supporting documentation, and
+ * that the name of the copyright holders not be used in advertising or
+ * publicity pertaining to distribution of the software without specific,
+ * written prior permission.  The copyright holders make no representations
+ * about the suitability of this software for any purpose.  It is provided "as
+ * is" without express or implied warranty.
+ *
+ * THE COPYRIGHT HOLDERS DISCLAIM ALL WARRANTIES WITH REGARD TO THIS SOFTWARE,
+ * INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS, IN NO
+ * EVENT SHALL THE COPYRIGHT HOLDERS BE LIABLE FOR ANY SPECIAL, INDIRECT OR
+ * CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE,
+ * DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER
+ * TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE
+ * OF THIS SOFTWARE.
+ */
+
+#include <json_struct/json_struct.h>
+#include <cmrc/cmrc.hpp>
+
+#include "catch2/catch.hpp"
+
+CMRC_DECLARE(external_json);
+
+namespace
+{
+
+struct TokenRecord
+{
+  JS::Error error;
+  JS::Type name_type;
+  std::string name;
+  JS::Type value_type;
+  std::string value;
+
+  bool operator==(const TokenRecord &other) const
+  {
+    return error == other.error && name_type == other.name_type && name == other.name &&
+           value_type == other.value_type && value == other.value;
+  }
+};
+
+static std::vector<TokenRecord> tokenize(const std::string &json, bool use_index, size_t split = 0,
+                                         bool allow_ascii = false)
+{
+  std::vector<TokenRecord> records;
+  JS::Tokenizer tokenizer;
+  tokenizer.useStructuralIndex(use_index);
+  tokenizer.allowAsciiType(allow_ascii);
+  if (split && split < json.size())
+  {
+    tokenizer.addData(json.data(), split);
+    tokenizer.addData(json.data() + split, json.size() - split);
+  }
+  else
+  {
+    tokenizer.addData(json.data(), json.size());
+  }
+  JS::Token token;
+  while (true)
+  {
+    JS::Error error = tokenizer.nextToken(token);
+    TokenRecord record = {error, JS::Type::Error, std::string(), JS::Type::Error, std::string()};
+    if (error == JS::Error::NoError)
+    {
+      record.name_type = token.name_type;
+      record.name.assign(token.name.data, token.name.size);
+      record.value_type = token.value_type;
+      record.value.assign(token.value.data, token.value.size);
+    }
+    records.push_back(record);
+    if (error != JS::Error::NoError)
+      break;
+  }
+  return records;
+}
+
+static const char *const documents[] = {
+  R"json({ "a": 1, "b": [1, 2, 3], "c": { "d": "e" } })json",
+  R"json([ "string with {braces} [brackets] : colons , commas", "\"quoted\"", "\\", "\\\"" ])json",
+  R"json({"escapes":"\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\\"","x":true})json",
+  R"json({
+          "pretty":      {
+                                                                                              "deep":
+                              [ 1.5e10,      -2,       null,    false        ]
+          }
+        })json",
+  R"json({ "a": 1 # "b": 2 })json",
+  R"json({ "a": 1 \ "b": 2 })json",
+  R"json({ "a" \"b": 2 })json",
+  R"json({ "a": 1 "b": 2 })json",
+  R"json({ "a": 12abc, "b": 2 })json",
+  R"json({ "long": "0123456789012345678901234567890123456789012345678901234567890123\"456789" })json",
+  R"json({ "unterminated": "0123456789012345678901234567890123456789012345678901234567890123)json",
+};
+
+TEST_CASE("structural_index_identical_tokens", "[tokenizer]")
+{
+  for (const char *document : documents)
+  {
+    std::string json(document);
+    REQUIRE(tokenize(json, false) == tokenize(json, true));
+    REQUIRE(tokenize(json, false, 0, true) == tokenize(json, true, 0, true));
+    for (size_t split = 1; split < json.size(); split++)
+    {
+      REQUIRE(tokenize(json, false, split) == tokenize(json, true, split));
+    }
+  }
+}
+
+TEST_CASE("structural_index_generated_json", "[tokenizer]")
+{
+  auto fs = cmrc::external_json::get_filesystem();
+  auto generated = fs.open("generated.json");
+  std::string json(generated.begin(), generated.size());
+  std::vector<TokenRecord> expected = tokenize(json, false);
+  REQUIRE(expected.size() > 1000);
+  REQUIRE(expected == tokenize(json, true));
+  REQUIRE(expected == tokenize(json, true, json.size() / 3));
+}
+
+TEST_CASE("structural_index_random_input", "[tokenizer]")
+{
+  // Random soup, except that closing brackets always match the open container,
+  // which the tokenizer asserts on.
+  const char alphabet[] = "{[}]:,\"\\ \n\ta1-.e";
+  uint32_t state = 12345;
+  for (int i = 0; i < 2000; i++)
+  {
+    std::string json;
+    std::vector<char> containers;
+    bool in_string = false;
+    bool escaped = false;
+    size_t size = 1 + (i % 200);
+    for (size_t j = 0; j < size; j++)
+    {
+      state = state * 1103515245 + 12345;
+      char c = alphabet[(state >> 16) % (sizeof(alphabet) - 1)];
+      if (in_string)
+      {
+        if (escaped)
+          escaped = false;
+        else if (c == '\\')
+          escaped = true;
+        else if (c == '"')
+          in_string = false;
+      }
+      else if (c == '"')
+      {
+        in_string = true;
+      }
+      else if (c == '{' || c == '[')
+      {
+        containers.push_back(c == '{' ? '}' : ']');
+      }
+      else if (c == '}' || c == ']')
+      {
+        if (containers.empty())
+          continue;
+        c = containers.back();
+        containers.pop_back();
+      }
+      json.push_back(c);
+    }
+    REQUIRE(tokenize(json, false) == tokenize(json, true));
+    REQUIRE(tokenize(json, false, 0, true) == tokenize(json, true, 0, true));
+  }
+}
+
+} // namespace
@@ -48,4 +48,80 @@ TEST_CASE("testMetaForTokens", "[meta]")
   REQUIRE((1 + metaInfo.at(1).skip + metaInfo.at(1 + metaInfo.at(1).skip).skip) == 7);
 }
 
+// The quadratic implementation metaForTokens used to have, which visits
+// every open scope for every token.
+static std::vector<JS::JsonMeta> referenceMetaForTokens(const JS::JsonTokens &tokens)
+{
+  std::vector<JS::JsonMeta> meta;
+  std::vector<size_t> parent;
+  for (size_t i = 0; i < tokens.data.size(); i++)
+  {
+    for (size_t parent_index : parent)
+      meta[parent_index].size++;
+    const JS::Token &token = tokens.data.at(i);
+    if (token.value_type == JS::Type::ArrayEnd || token.value_type == JS::Type::ObjectEnd)
+      parent.pop_back();
+    else if (parent.size())
+      meta[parent.back()].children++;
+
+    if (token.value_type == JS::Type::ArrayStart || token.value_type == JS::Type::ObjectStart)
+    {
+      if (parent.size())
+        meta[parent.back()].complex_children++;
+      for (size_t parent_index : parent)
+        meta[parent_index].skip++;
+      meta.push_back(JS::JsonMeta(i, token.value_type == JS::Type::ArrayStart));
+      parent.push_back(meta.size() - 1);
+    }
+    else if (token.value_type != JS::Type::ArrayEnd && token.value_type != JS::Type::ObjectEnd)
+    {
+      for (size_t parent_index : parent)
+        meta[parent_index].has_data = true;
+    }
+  }
+  return meta;
+}
+
+static void requireSameMeta(const std::string &json)
+{
+  JS::ParseContext context(json);
+  JS::JsonTokens tokens;
+  REQUIRE(context.parseTo(tokens) == JS::Error::NoError);
+  std::vector<JS::JsonMeta> meta = JS::metaForTokens(tokens);
+  std::vector<JS::JsonMeta> reference = referenceMetaForTokens(tokens);
+  REQUIRE(meta.size() == reference.size());
+  for (size_t i = 0; i < meta.size(); i++)
+  {
+    INFO("meta index " << i);
+    REQUIRE(meta[i].position == reference[i].position);
+    REQUIRE(meta[i].size == reference[i].size);
+    REQUIRE(meta[i].skip == reference[i].skip);
+    REQUIRE(meta[i].children == reference[i].children);
+    REQUIRE(meta[i].complex_children == reference[i].complex_children);
+    REQUIRE(meta[i].is_array == reference[i].is_array);
+    REQUIRE(meta[i].has_data == reference[i].has_data);
+  }
+}
+
+TEST_CASE("testMetaForTokensMatchesReference", "[meta]")
+{
+  requireSameMeta(json_string);
+  requireSameMeta("[]");
+  requireSameMeta(R"json({ "a": [], "b": {}, "c": [ [], [ {} ], [ 1 ] ], "d": { "e": { "f": null } } })json");
+
+  std::string deep;
+  for (int i = 0; i < 150; i++)
+    deep += i % 2 ? "{ \"member\": " : "[ 1, ";
+  deep += "[]";
+  for (int i = 149; i >= 0; i--)
+    deep += i % 2 ? ", \"after\": [ 2, {} ] }" : " ]";
+  requireSameMeta(deep);
+
+  std::string wide = "[";
+  for (int i = 0; i < 1000; i++)
+    wide += i ? ", { \"a\": [ 1, 2 ], \"b\": {} }" : "{ \"a\": [ 1, 2 ], \"b\": {} }";
+  wide += "]";
+  requireSameMeta(wide);
+}
+
 } // namespace